@@ -23,6 +23,8 @@ using namespace LAMMPS_NS;
 DumpAtomGZ::DumpAtomGZ(LAMMPS *lmp, int narg, char **arg) :
   DumpAtom(lmp, narg, arg)
 {
+  async_allow = 0;
+
   gzFp = NULL;
 
   if (!compressed)
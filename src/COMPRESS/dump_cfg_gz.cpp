@@ -25,6 +25,8 @@ using namespace LAMMPS_NS;
 DumpCFGGZ::DumpCFGGZ(LAMMPS *lmp, int narg, char **arg) :
   DumpCFG(lmp, narg, arg)
 {
+  async_allow = 0;
+
   gzFp = NULL;
 
   if (!compressed)
@@ -23,6 +23,8 @@ using namespace LAMMPS_NS;
 DumpCustomGZ::DumpCustomGZ(LAMMPS *lmp, int narg, char **arg) :
   DumpCustom(lmp, narg, arg)
 {
+  async_allow = 0;
+
   gzFp = NULL;
 
   if (!compressed)
@@ -23,6 +23,8 @@ using namespace LAMMPS_NS;
 DumpXYZGZ::DumpXYZGZ(LAMMPS *lmp, int narg, char **arg) :
   DumpXYZ(lmp, narg, arg)
 {
+  async_allow = 0;
+
   gzFp = NULL;
 
   if (!compressed)
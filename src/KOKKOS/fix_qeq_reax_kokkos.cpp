@@ -61,6 +61,10 @@ FixQEqReaxKokkos(LAMMPS *lmp, int narg, char **arg) :
   datamask_read = X_MASK | V_MASK | F_MASK | MASK_MASK | Q_MASK | TYPE_MASK;
   datamask_modify = Q_MASK | X_MASK;
 
+  if (dual_enabled || nprev != 4)
+    error->all(FLERR,"Fix qeq/reax/kk does not support dual, pipeline, "
+               "or nprev keywords");
+
   nmax = nmax = m_cap = 0;
   allocated_flag = 0;
   nprev = 4;
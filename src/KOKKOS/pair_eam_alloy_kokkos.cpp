@@ -44,6 +44,7 @@ template<class DeviceType>
 PairEAMAlloyKokkos<DeviceType>::PairEAMAlloyKokkos(LAMMPS *lmp) : PairEAM(lmp)
 {
   respa_enable = 0;
+  energy_local_enable = 0;
   one_coeff = 1;
   manybody_flag = 1;
 
@@ -47,6 +47,7 @@ template<class DeviceType>
 PairSWKokkos<DeviceType>::PairSWKokkos(LAMMPS *lmp) : PairSW(lmp)
 {
   respa_enable = 0;
+  energy_local_enable = 0;
 
 
   atomKK = (AtomKokkos *) atom;
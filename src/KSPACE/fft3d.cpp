@@ -34,6 +34,15 @@
 #define MIN(A,B) ((A) < (B) ? (A) : (B))
 #define MAX(A,B) ((A) > (B) ? (A) : (B))
 
+#define OVERLAP_CHUNK 4    // # of chunks each pipelined remap is sent in
+
+static void fft_3d_overlap(FFT_DATA *, FFT_DATA *, int, struct fft_plan_3d *);
+static void fft_1d_remap(FFT_DATA *, FFT_DATA *, int, int,
+                         struct remap_plan_3d *, struct fft_plan_3d *);
+static void fft_1d_lines(FFT_DATA *, int, int, int, int,
+                         struct fft_plan_3d *);
+static void fft_3d_scale(FFT_DATA *, struct fft_plan_3d *);
+
 /* ----------------------------------------------------------------------
    Data layout for 3d FFTs:
 
@@ -66,13 +75,14 @@
 
 void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
 {
-  int i,total,length,offset,num;
-  FFT_SCALAR norm;
-#if defined(FFT_FFTW3)
-  FFT_SCALAR *out_ptr;
-#endif
+  int total,length,offset;
   FFT_DATA *data,*copy;
 
+  if (plan->overlap) {
+    fft_3d_overlap(in,out,flag,plan);
+    return;
+  }
+
   // system specific constants
 
 #if defined(FFT_FFTW3)
@@ -216,23 +226,137 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
              (FFT_SCALAR *) plan->scratch, plan->post_plan);
 
   // scaling if required
-  if (flag == 1 && plan->scaled) {
-    norm = plan->norm;
-    num = plan->normnum;
+  if (flag == 1 && plan->scaled) fft_3d_scale(out,plan);
+}
+
+/* ----------------------------------------------------------------------
+   Perform 3d FFT with each set of 1d FFTs pipelined with the next remap
+   the 1d FFTs are done in chunks of lines and each chunk is sent as soon
+     as it is transformed, so communication overlaps with the FFTs
+   arguments are the same as for fft_3d()
+------------------------------------------------------------------------- */
+
+static void fft_3d_overlap(FFT_DATA *in, FFT_DATA *out, int flag,
+                           struct fft_plan_3d *plan)
+{
+  FFT_DATA *data,*copy;
+
+  // pre-remap to prepare for 1st FFTs if needed
+  // no FFTs to overlap it with
+
+  if (plan->pre_plan) {
+    if (plan->pre_target == 0) copy = out;
+    else copy = plan->copy;
+    remap_3d((FFT_SCALAR *) in, (FFT_SCALAR *) copy,
+             (FFT_SCALAR *) plan->scratch, plan->pre_plan);
+    data = copy;
+  }
+  else
+    data = in;
+
+  // 1d FFTs along fast axis, pipelined with 1st mid-remap
+
+  if (plan->mid1_target == 0) copy = out;
+  else copy = plan->copy;
+  fft_1d_remap(data,copy,0,flag,plan->mid1_plan,plan);
+  data = copy;
+
+  // 1d FFTs along mid axis, pipelined with 2nd mid-remap
+
+  if (plan->mid2_target == 0) copy = out;
+  else copy = plan->copy;
+  fft_1d_remap(data,copy,1,flag,plan->mid2_plan,plan);
+  data = copy;
+
+  // 1d FFTs along slow axis, pipelined with post-remap if needed
+
+  if (plan->post_plan) fft_1d_remap(data,out,2,flag,plan->post_plan,plan);
+  else fft_1d_lines(data,0,plan->total3/plan->length3,2,flag,plan);
+
+  if (flag == 1 && plan->scaled) fft_3d_scale(out,plan);
+}
+
+/* ----------------------------------------------------------------------
+   1d FFTs of one axis in chunks, each chunk sent by remap as it is done
+   result of remap is put in copy
+------------------------------------------------------------------------- */
+
+static void fft_1d_remap(FFT_DATA *data, FFT_DATA *copy, int axis, int flag,
+                         struct remap_plan_3d *remap, struct fft_plan_3d *plan)
+{
+  FFT_SCALAR *scratch = (FFT_SCALAR *) plan->scratch;
+
+  remap_3d_begin(scratch,remap);
+  for (int ichunk = 0; ichunk < remap->nchunk; ichunk++) {
+    fft_1d_lines(data,remap->chunk_line[ichunk],remap->chunk_line[ichunk+1],
+                 axis,flag,plan);
+    remap_3d_send((FFT_SCALAR *) data,scratch,ichunk,remap);
+  }
+  remap_3d_end((FFT_SCALAR *) copy,scratch,remap);
+}
+
+/* ----------------------------------------------------------------------
+   1d FFTs on lines ilo to ihi-1 along axis = 0,1,2 for fast,mid,slow
+------------------------------------------------------------------------- */
+
+static void fft_1d_lines(FFT_DATA *data, int ilo, int ihi, int axis, int flag,
+                         struct fft_plan_3d *plan)
+{
+  int offset,length;
+
+  if (axis == 0) length = plan->length1;
+  else if (axis == 1) length = plan->length2;
+  else length = plan->length3;
+
+#if defined(FFT_MKL)
+  for (offset = ilo*length; offset < ihi*length; offset += length) {
+    if (flag == -1)
+      DftiComputeForward(plan->handle_line[axis],&data[offset]);
+    else
+      DftiComputeBackward(plan->handle_line[axis],&data[offset]);
+  }
+#elif defined(FFT_FFTW3)
+  FFTW_API(plan) theplan;
+  if (flag == -1)
+    theplan = plan->plan_line_forward[axis];
+  else
+    theplan = plan->plan_line_backward[axis];
+  for (offset = ilo*length; offset < ihi*length; offset += length)
+    FFTW_API(execute_dft)(theplan,&data[offset],&data[offset]);
+#else
+  kiss_fft_cfg cfg;
+  if (axis == 0)
+    cfg = (flag == -1) ? plan->cfg_fast_forward : plan->cfg_fast_backward;
+  else if (axis == 1)
+    cfg = (flag == -1) ? plan->cfg_mid_forward : plan->cfg_mid_backward;
+  else
+    cfg = (flag == -1) ? plan->cfg_slow_forward : plan->cfg_slow_backward;
+  for (offset = ilo*length; offset < ihi*length; offset += length)
+    kiss_fft(cfg,&data[offset],&data[offset]);
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   scale result of a backward 3d FFT by 1/N
+------------------------------------------------------------------------- */
+
+static void fft_3d_scale(FFT_DATA *out, struct fft_plan_3d *plan)
+{
+  FFT_SCALAR norm = plan->norm;
+  int num = plan->normnum;
 #if defined(FFT_FFTW3)
-    out_ptr = (FFT_SCALAR *)out;
+  FFT_SCALAR *out_ptr = (FFT_SCALAR *)out;
 #endif
-    for (i = 0; i < num; i++) {
+  for (int i = 0; i < num; i++) {
 #if defined(FFT_FFTW3)
-      *(out_ptr++) *= norm;
-      *(out_ptr++) *= norm;
+    *(out_ptr++) *= norm;
+    *(out_ptr++) *= norm;
 #elif defined(FFT_MKL)
-      out[i] *= norm;
+    out[i] *= norm;
 #else
-      out[i].re *= norm;
-      out[i].im *= norm;
+    out[i].re *= norm;
+    out[i].im *= norm;
 #endif
-    }
   }
 }
 
@@ -255,6 +379,8 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
                           2 = permute twice = slow->fast, fast->mid, mid->slow
    nbuf                 returns size of internal storage buffers used by FFT
    usecollective        use collective MPI operations for remapping data
+   overlap              pipeline 1d FFTs with the following remap
+                          ignored if usecollective is set
 ------------------------------------------------------------------------- */
 
 struct fft_plan_3d *fft_3d_create_plan(
@@ -263,7 +389,7 @@ struct fft_plan_3d *fft_3d_create_plan(
        int in_klo, int in_khi,
        int out_ilo, int out_ihi, int out_jlo, int out_jhi,
        int out_klo, int out_khi,
-       int scaled, int permute, int *nbuf, int usecollective)
+       int scaled, int permute, int *nbuf, int usecollective, int overlap)
 {
   struct fft_plan_3d *plan;
   int me,nprocs;
@@ -272,7 +398,7 @@ struct fft_plan_3d *fft_3d_create_plan(
   int second_ilo,second_ihi,second_jlo,second_jhi,second_klo,second_khi;
   int third_ilo,third_ihi,third_jlo,third_jhi,third_klo,third_khi;
   int out_size,first_size,second_size,third_size,copy_size,scratch_size;
-  int np1,np2,ip1,ip2;
+  int np1,np2,ip1,ip2,nchunk;
 
   // query MPI info
 
@@ -290,6 +416,11 @@ struct fft_plan_3d *fft_3d_create_plan(
   plan = (struct fft_plan_3d *) malloc(sizeof(struct fft_plan_3d));
   if (plan == NULL) return NULL;
 
+  // remaps that follow a set of 1d FFTs are sent in chunks if overlapped
+
+  plan->overlap = (overlap && !usecollective) ? 1 : 0;
+  nchunk = plan->overlap ? OVERLAP_CHUNK : 1;
+
   // remap from initial distribution to layout needed for 1st set of 1d FFTs
   // not needed if all procs own entire fast axis initially
   // first indices = distribution after 1st set of FFTs
@@ -319,7 +450,7 @@ struct fft_plan_3d *fft_3d_create_plan(
     plan->pre_plan =
       remap_3d_create_plan(comm,in_ilo,in_ihi,in_jlo,in_jhi,in_klo,in_khi,
                            first_ilo,first_ihi,first_jlo,first_jhi,
-                           first_klo,first_khi,2,0,0,FFT_PRECISION,0);
+                           first_klo,first_khi,2,0,0,FFT_PRECISION,0,1);
     if (plan->pre_plan == NULL) return NULL;
   }
 
@@ -344,7 +475,7 @@ struct fft_plan_3d *fft_3d_create_plan(
                            first_klo,first_khi,
                            second_ilo,second_ihi,second_jlo,second_jhi,
                            second_klo,second_khi,2,1,0,FFT_PRECISION,
-                           usecollective);
+                           usecollective,nchunk);
   if (plan->mid1_plan == NULL) return NULL;
 
   // 1d FFTs along mid axis
@@ -385,7 +516,8 @@ struct fft_plan_3d *fft_3d_create_plan(
                          second_jlo,second_jhi,second_klo,second_khi,
                          second_ilo,second_ihi,
                          third_jlo,third_jhi,third_klo,third_khi,
-                         third_ilo,third_ihi,2,1,0,FFT_PRECISION,usecollective);
+                         third_ilo,third_ihi,2,1,0,FFT_PRECISION,
+                         usecollective,nchunk);
   if (plan->mid2_plan == NULL) return NULL;
 
   // 1d FFTs along slow axis
@@ -414,7 +546,8 @@ struct fft_plan_3d *fft_3d_create_plan(
                            third_klo,third_khi,third_ilo,third_ihi,
                            third_jlo,third_jhi,
                            out_klo,out_khi,out_ilo,out_ihi,
-                           out_jlo,out_jhi,2,(permute+1)%3,0,FFT_PRECISION,0);
+                           out_jlo,out_jhi,2,(permute+1)%3,0,FFT_PRECISION,
+                           0,nchunk);
     if (plan->post_plan == NULL) return NULL;
   }
 
@@ -517,6 +650,16 @@ struct fft_plan_3d *fft_3d_create_plan(
   DftiSetValue(plan->handle_slow, DFTI_OUTPUT_DISTANCE, (MKL_LONG)nslow);
   DftiCommitDescriptor(plan->handle_slow);
 
+  if (plan->overlap) {
+    int nline[3] = {nfast,nmid,nslow};
+    for (int i = 0; i < 3; i++) {
+      DftiCreateDescriptor( &(plan->handle_line[i]), FFT_MKL_PREC,
+                            DFTI_COMPLEX, 1, (MKL_LONG)nline[i]);
+      DftiSetValue(plan->handle_line[i], DFTI_PLACEMENT,DFTI_INPLACE);
+      DftiCommitDescriptor(plan->handle_line[i]);
+    }
+  }
+
   if (scaled == 0)
     plan->scaled = 0;
   else {
@@ -602,6 +745,20 @@ struct fft_plan_3d *fft_3d_create_plan(
                             NULL,&nslow,1,plan->length3,
                             FFTW_BACKWARD,FFTW_ESTIMATE);
 
+  // line offsets within a chunk need not have SIMD alignment
+
+  if (plan->overlap) {
+    int nline[3] = {nfast,nmid,nslow};
+    for (int i = 0; i < 3; i++) {
+      plan->plan_line_forward[i] =
+        FFTW_API(plan_dft_1d)(nline[i],NULL,NULL,FFTW_FORWARD,
+                              FFTW_ESTIMATE | FFTW_UNALIGNED);
+      plan->plan_line_backward[i] =
+        FFTW_API(plan_dft_1d)(nline[i],NULL,NULL,FFTW_BACKWARD,
+                              FFTW_ESTIMATE | FFTW_UNALIGNED);
+    }
+  }
+
   if (scaled == 0)
     plan->scaled = 0;
   else {
@@ -668,6 +825,8 @@ void fft_3d_destroy_plan(struct fft_plan_3d *plan)
   DftiFreeDescriptor(&(plan->handle_fast));
   DftiFreeDescriptor(&(plan->handle_mid));
   DftiFreeDescriptor(&(plan->handle_slow));
+  if (plan->overlap)
+    for (int i = 0; i < 3; i++) DftiFreeDescriptor(&(plan->handle_line[i]));
   /*
 #elif defined(FFT_FFTW2)
   if (plan->plan_slow_forward != plan->plan_fast_forward &&
@@ -689,6 +848,11 @@ void fft_3d_destroy_plan(struct fft_plan_3d *plan)
   FFTW_API(destroy_plan)(plan->plan_mid_backward);
   FFTW_API(destroy_plan)(plan->plan_fast_forward);
   FFTW_API(destroy_plan)(plan->plan_fast_backward);
+  if (plan->overlap)
+    for (int i = 0; i < 3; i++) {
+      FFTW_API(destroy_plan)(plan->plan_line_forward[i]);
+      FFTW_API(destroy_plan)(plan->plan_line_backward[i]);
+    }
 #else
   if (plan->cfg_slow_forward != plan->cfg_fast_forward &&
       plan->cfg_slow_forward != plan->cfg_mid_forward) {
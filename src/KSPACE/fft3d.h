@@ -133,12 +133,14 @@ struct fft_plan_3d {
   int scaled;                       // whether to scale FFT results
   int normnum;                      // # of values to rescale
   double norm;                      // normalization factor for rescaling
+  int overlap;                      // 1 if 1d FFTs are pipelined with remaps
 
                                     // system specific 1d FFT info
 #if defined(FFT_MKL)
   DFTI_DESCRIPTOR *handle_fast;
   DFTI_DESCRIPTOR *handle_mid;
   DFTI_DESCRIPTOR *handle_slow;
+  DFTI_DESCRIPTOR *handle_line[3];  // single 1d FFTs, only for overlap
 //#elif defined(FFT_FFTW2)
 //  fftw_plan plan_fast_forward;
 //  fftw_plan plan_fast_backward;
@@ -153,6 +155,8 @@ struct fft_plan_3d {
   FFTW_API(plan) plan_mid_backward;
   FFTW_API(plan) plan_slow_forward;
   FFTW_API(plan) plan_slow_backward;
+  FFTW_API(plan) plan_line_forward[3];  // single 1d FFTs, only for overlap
+  FFTW_API(plan) plan_line_backward[3];
 #elif defined(FFT_KISS)
   kiss_fft_cfg cfg_fast_forward;
   kiss_fft_cfg cfg_fast_backward;
@@ -170,7 +174,7 @@ extern "C" {
   struct fft_plan_3d *fft_3d_create_plan(MPI_Comm, int, int, int,
                                          int, int, int, int, int,
                                          int, int, int, int, int, int, int,
-                                         int, int, int *, int);
+                                         int, int, int *, int, int);
   void fft_3d_destroy_plan(struct fft_plan_3d *);
   void factor(int, int *, int *);
   void bifactor(int, int *, int *);
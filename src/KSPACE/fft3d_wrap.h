@@ -22,7 +22,7 @@ namespace LAMMPS_NS {
 class FFT3d : protected Pointers {
  public:
   FFT3d(class LAMMPS *, MPI_Comm,int,int,int,int,int,int,int,int,int,
-        int,int,int,int,int,int,int,int,int *,int);
+        int,int,int,int,int,int,int,int,int *,int,int overlap = 0);
   ~FFT3d();
   void compute(FFT_SCALAR *, FFT_SCALAR *, int);
   void timing1d(FFT_SCALAR *, int, int);
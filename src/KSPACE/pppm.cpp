@@ -23,6 +23,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <cfloat>
 #include "pppm.h"
 #include "atom.h"
 #include "comm.h"
@@ -831,12 +832,12 @@ void PPPM::allocate()
   fft1 = new FFT3d(lmp,world,nx_pppm,ny_pppm,nz_pppm,
                    nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
                    nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
-                   0,0,&tmp,collective_flag);
+                   0,0,&tmp,collective_flag,fft_overlap);
 
   fft2 = new FFT3d(lmp,world,nx_pppm,ny_pppm,nz_pppm,
                    nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
                    nxlo_in,nxhi_in,nylo_in,nyhi_in,nzlo_in,nzhi_in,
-                   0,0,&tmp,collective_flag);
+                   0,0,&tmp,collective_flag,fft_overlap);
 
   remap = new Remap(lmp,world,
                     nxlo_in,nxhi_in,nylo_in,nyhi_in,nzlo_in,nzhi_in,
@@ -1356,12 +1357,33 @@ double PPPM::final_accuracy()
   double q2_over_sqrt = q2 / sqrt(natoms*cutoff*xprd*yprd*zprd);
   double df_rspace = 2.0 * q2_over_sqrt * exp(-g_ewald*g_ewald*cutoff*cutoff);
   double df_table = estimate_table_accuracy(q2_over_sqrt,df_rspace);
+  double df_fft = estimate_fft_precision(q2,natoms);
   double estimated_accuracy = sqrt(df_kspace*df_kspace + df_rspace*df_rspace +
-                                   df_table*df_table);
+                                   df_table*df_table + df_fft*df_fft);
 
   return estimated_accuracy;
 }
 
+/* ----------------------------------------------------------------------
+   estimate the RMS force error from rounding of single-precision grids
+   grid values carry a relative error of FLT_EPSILON that grows with
+     the log of the FFT size, scaled by a typical per-atom k-space force
+   zero for double-precision FFTs
+------------------------------------------------------------------------- */
+
+double PPPM::estimate_fft_precision(double qsq, bigint natoms)
+{
+#ifdef FFT_SINGLE
+  const double eps = FLT_EPSILON;
+#else
+  const double eps = 0.0;
+#endif
+
+  double ngrid_all = (double) nx_pppm * ny_pppm * nz_pppm;
+  if (natoms == 0) natoms = 1;
+  return eps * log2(ngrid_all) * g_ewald*g_ewald * qsq/natoms;
+}
+
 /* ----------------------------------------------------------------------
    set local subset of PPPM/FFT grid that I own
    n xyz lo/hi in = 3d brick that I own (inclusive)
@@ -2055,7 +2077,8 @@ void PPPM::poisson_ik()
     if (vflag_global) {
       n = 0;
       for (i = 0; i < nfft; i++) {
-        eng = s2 * greensfn[i] * (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
+        eng = s2 * greensfn[i] * ((double) work1[n]*work1[n] +
+                                  (double) work1[n+1]*work1[n+1]);
         for (j = 0; j < 6; j++) virial[j] += eng*vg[i][j];
         if (eflag_global) energy += eng;
         n += 2;
@@ -2063,8 +2086,8 @@ void PPPM::poisson_ik()
     } else {
       n = 0;
       for (i = 0; i < nfft; i++) {
-        energy +=
-          s2 * greensfn[i] * (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
+        energy += s2 * greensfn[i] * ((double) work1[n]*work1[n] +
+                                      (double) work1[n+1]*work1[n+1]);
         n += 2;
       }
     }
@@ -2256,7 +2279,8 @@ void PPPM::poisson_ad()
     if (vflag_global) {
       n = 0;
       for (i = 0; i < nfft; i++) {
-        eng = s2 * greensfn[i] * (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
+        eng = s2 * greensfn[i] * ((double) work1[n]*work1[n] +
+                                  (double) work1[n+1]*work1[n+1]);
         for (j = 0; j < 6; j++) virial[j] += eng*vg[i][j];
         if (eflag_global) energy += eng;
         n += 2;
@@ -2264,8 +2288,8 @@ void PPPM::poisson_ad()
     } else {
       n = 0;
       for (i = 0; i < nfft; i++) {
-        energy +=
-          s2 * greensfn[i] * (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
+        energy += s2 * greensfn[i] * ((double) work1[n]*work1[n] +
+                                      (double) work1[n+1]*work1[n+1]);
         n += 2;
       }
     }
@@ -2456,13 +2480,14 @@ void PPPM::fieldforce_ik()
 {
   int i,l,m,n,nx,ny,nz,mx,my,mz;
   FFT_SCALAR dx,dy,dz,x0,y0,z0;
-  FFT_SCALAR ekx,eky,ekz;
+  double ekx,eky,ekz;
 
   // loop over my charges, interpolate electric field from nearby grid points
   // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
   // (dx,dy,dz) = distance to "lower left" grid pt
   // (mx,my,mz) = global coords of moving stencil pt
   // ek = 3 components of E-field on particle
+  // ek is accumulated in double even if grid values are single precision
 
   double *q = atom->q;
   double **x = atom->x;
@@ -2480,7 +2505,7 @@ void PPPM::fieldforce_ik()
 
     compute_rho1d(dx,dy,dz);
 
-    ekx = eky = ekz = ZEROF;
+    ekx = eky = ekz = 0.0;
     for (n = nlower; n <= nupper; n++) {
       mz = n+nz;
       z0 = rho1d[2][n];
@@ -2514,7 +2539,7 @@ void PPPM::fieldforce_ad()
 {
   int i,l,m,n,nx,ny,nz,mx,my,mz;
   FFT_SCALAR dx,dy,dz;
-  FFT_SCALAR ekx,eky,ekz;
+  double ekx,eky,ekz;
   double s1,s2,s3;
   double sf = 0.0;
   double *prd;
@@ -2551,7 +2576,7 @@ void PPPM::fieldforce_ad()
     compute_rho1d(dx,dy,dz);
     compute_drho1d(dx,dy,dz);
 
-    ekx = eky = ekz = ZEROF;
+    ekx = eky = ekz = 0.0;
     for (n = nlower; n <= nupper; n++) {
       mz = n+nz;
       for (m = nlower; m <= nupper; m++) {
@@ -2601,7 +2626,7 @@ void PPPM::fieldforce_peratom()
 {
   int i,l,m,n,nx,ny,nz,mx,my,mz;
   FFT_SCALAR dx,dy,dz,x0,y0,z0;
-  FFT_SCALAR u,v0,v1,v2,v3,v4,v5;
+  double u,v0,v1,v2,v3,v4,v5;
 
   // loop over my charges, interpolate from nearby grid points
   // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
@@ -2623,7 +2648,7 @@ void PPPM::fieldforce_peratom()
 
     compute_rho1d(dx,dy,dz);
 
-    u = v0 = v1 = v2 = v3 = v4 = v5 = ZEROF;
+    u = v0 = v1 = v2 = v3 = v4 = v5 = 0.0;
     for (n = nlower; n <= nupper; n++) {
       mz = n+nz;
       z0 = rho1d[2][n];
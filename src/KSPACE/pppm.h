@@ -112,6 +112,7 @@ class PPPM : public KSpace {
   double newton_raphson_f();
   double derivf();
   double final_accuracy();
+  double estimate_fft_precision(double, bigint);
 
   virtual void allocate();
   virtual void allocate_peratom();
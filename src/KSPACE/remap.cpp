@@ -77,7 +77,7 @@ void remap_3d(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
 
     for (irecv = 0; irecv < plan->nrecv; irecv++)
       MPI_Irecv(&scratch[plan->recv_bufloc[irecv]],plan->recv_size[irecv],
-                MPI_FFT_SCALAR,plan->recv_proc[irecv],0,
+                MPI_FFT_SCALAR,plan->recv_proc[irecv],plan->recv_chunk[irecv],
                 plan->comm,&plan->request[irecv]);
 
     // send all messages to other procs
@@ -86,14 +86,15 @@ void remap_3d(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
       plan->pack(&in[plan->send_offset[isend]],
                  plan->sendbuf,&plan->packplan[isend]);
       MPI_Send(plan->sendbuf,plan->send_size[isend],MPI_FFT_SCALAR,
-               plan->send_proc[isend],0,plan->comm);
+               plan->send_proc[isend],plan->send_chunk[isend],plan->comm);
     }
 
     // copy in -> scratch -> out for self data
+    // one self message per chunk, stored after all messages to other procs
 
-    if (plan->self) {
-      isend = plan->nsend;
-      irecv = plan->nrecv;
+    for (i = 0; i < plan->self; i++) {
+      isend = plan->nsend + i;
+      irecv = plan->nrecv + i;
       plan->pack(&in[plan->send_offset[isend]],
                  &scratch[plan->recv_bufloc[irecv]],
                  &plan->packplan[isend]);
@@ -203,6 +204,96 @@ void remap_3d(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
   }
 }
 
+/* ----------------------------------------------------------------------
+   Perform 3d remap in 3 phases so sends can be interleaved with compute
+   only for point-to-point plans, used by fft_3d() to pipeline 1d FFTs
+
+   remap_3d_begin() posts all recvs into scratch space
+   remap_3d_send() packs and sends all messages for one chunk of input
+     lines, chunk_line[ichunk] to chunk_line[ichunk+1]-1 of the input
+     must be final before it is called
+   remap_3d_end() unpacks all messages into out as they arrive and
+     waits for the sends to complete
+
+   in, out and buf are the same as for remap_3d()
+   in can be the same as out, since no data is unpacked before the
+     last chunk has been packed
+------------------------------------------------------------------------- */
+
+void remap_3d_begin(FFT_SCALAR *buf, struct remap_plan_3d *plan)
+{
+  FFT_SCALAR *scratch;
+
+  if (plan->memory == 0) scratch = buf;
+  else scratch = plan->scratch;
+
+  for (int irecv = 0; irecv < plan->nrecv; irecv++)
+    MPI_Irecv(&scratch[plan->recv_bufloc[irecv]],plan->recv_size[irecv],
+              MPI_FFT_SCALAR,plan->recv_proc[irecv],plan->recv_chunk[irecv],
+              plan->comm,&plan->request[irecv]);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void remap_3d_send(FFT_SCALAR *in, FFT_SCALAR *buf, int ichunk,
+                   struct remap_plan_3d *plan)
+{
+  int isend,irecv;
+  FFT_SCALAR *scratch;
+
+  if (plan->memory == 0) scratch = buf;
+  else scratch = plan->scratch;
+
+  // each message has its own slot in sendbuf, so it can stay in flight
+
+  for (isend = 0; isend < plan->nsend; isend++) {
+    if (plan->send_chunk[isend] != ichunk) continue;
+    plan->pack(&in[plan->send_offset[isend]],
+               &plan->sendbuf[plan->send_bufloc[isend]],
+               &plan->packplan[isend]);
+    MPI_Isend(&plan->sendbuf[plan->send_bufloc[isend]],plan->send_size[isend],
+              MPI_FFT_SCALAR,plan->send_proc[isend],ichunk,plan->comm,
+              &plan->send_request[isend]);
+  }
+
+  // copy in -> scratch for self data, unpacked by remap_3d_end()
+
+  for (int i = 0; i < plan->self; i++) {
+    isend = plan->nsend + i;
+    irecv = plan->nrecv + i;
+    if (plan->send_chunk[isend] != ichunk) continue;
+    plan->pack(&in[plan->send_offset[isend]],
+               &scratch[plan->recv_bufloc[irecv]],
+               &plan->packplan[isend]);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+void remap_3d_end(FFT_SCALAR *out, FFT_SCALAR *buf, struct remap_plan_3d *plan)
+{
+  int i,irecv;
+  FFT_SCALAR *scratch;
+
+  if (plan->memory == 0) scratch = buf;
+  else scratch = plan->scratch;
+
+  for (i = 0; i < plan->self; i++) {
+    irecv = plan->nrecv + i;
+    plan->unpack(&scratch[plan->recv_bufloc[irecv]],
+                 &out[plan->recv_offset[irecv]],&plan->unpackplan[irecv]);
+  }
+
+  for (i = 0; i < plan->nrecv; i++) {
+    MPI_Waitany(plan->nrecv,plan->request,&irecv,MPI_STATUS_IGNORE);
+    plan->unpack(&scratch[plan->recv_bufloc[irecv]],
+                 &out[plan->recv_offset[irecv]],&plan->unpackplan[irecv]);
+  }
+
+  if (plan->nsend)
+    MPI_Waitall(plan->nsend,plan->send_request,MPI_STATUS_IGNORE);
+}
+
 /* ----------------------------------------------------------------------
    Create plan for performing a 3d remap
 
@@ -226,6 +317,10 @@ void remap_3d(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
                           1 = single precision (4 bytes per datum)
                           2 = double precision (8 bytes per datum)
    usecollective        whether to use collective MPI or point-to-point
+   nchunk               # of chunks to split each message into
+                          chunks are slabs of the input slow index,
+                          so remap_3d_send() can send them separately
+                          must be 1 for collective MPI
 ------------------------------------------------------------------------- */
 
 struct remap_plan_3d *remap_3d_create_plan(
@@ -234,14 +329,15 @@ struct remap_plan_3d *remap_3d_create_plan(
   int in_klo, int in_khi,
   int out_ilo, int out_ihi, int out_jlo, int out_jhi,
   int out_klo, int out_khi,
-  int nqty, int permute, int memory, int /*precision*/, int usecollective)
+  int nqty, int permute, int memory, int /*precision*/, int usecollective,
+  int nchunk)
 
 {
 
   struct remap_plan_3d *plan;
   struct extent_3d *inarray, *outarray;
-  struct extent_3d in,out,overlap;
-  int i,iproc,nsend,nrecv,ibuf,size,me,nprocs;
+  struct extent_3d in,out,overlap,chunk;
+  int i,ichunk,iproc,nsend,nrecv,ibuf,size,me,nprocs;
 
   // query MPI info
 
@@ -253,6 +349,8 @@ struct remap_plan_3d *remap_3d_create_plan(
   plan = (struct remap_plan_3d *) malloc(sizeof(struct remap_plan_3d));
   if (plan == NULL) return NULL;
   plan->usecollective = usecollective;
+  if (usecollective) nchunk = 1;
+  plan->nchunk = nchunk;
 
   // store parameters in local data structs
 
@@ -280,6 +378,15 @@ struct remap_plan_3d *remap_3d_create_plan(
   out.khi = out_khi;
   out.ksize = out.khi - out.klo + 1;
 
+  // first input line of each chunk, lines are along the fast index
+
+  plan->chunk_line = (int *) malloc((nchunk+1)*sizeof(int));
+  if (plan->chunk_line == NULL) return NULL;
+  for (ichunk = 0; ichunk <= nchunk; ichunk++) {
+    remap_3d_chunk(&in,ichunk,nchunk,&chunk);
+    plan->chunk_line[ichunk] = (chunk.klo-in.klo) * MAX(in.jsize,0);
+  }
+
   // combine output extents across all procs
 
   inarray = (struct extent_3d *) malloc(nprocs*sizeof(struct extent_3d));
@@ -298,7 +405,10 @@ struct remap_plan_3d *remap_3d_create_plan(
   for (i = 0; i < nprocs; i++) {
     iproc++;
     if (iproc == nprocs) iproc = 0;
-    nsend += remap_3d_collide(&in,&outarray[iproc],&overlap);
+    for (ichunk = 0; ichunk < nchunk; ichunk++) {
+      remap_3d_chunk(&in,ichunk,nchunk,&chunk);
+      nsend += remap_3d_collide(&chunk,&outarray[iproc],&overlap);
+    }
   }
 
   // malloc space for send info
@@ -309,22 +419,27 @@ struct remap_plan_3d *remap_3d_create_plan(
     plan->send_offset = (int *) malloc(nsend*sizeof(int));
     plan->send_size = (int *) malloc(nsend*sizeof(int));
     plan->send_proc = (int *) malloc(nsend*sizeof(int));
+    plan->send_chunk = (int *) malloc(nsend*sizeof(int));
     plan->packplan = (struct pack_plan_3d *)
       malloc(nsend*sizeof(struct pack_plan_3d));
 
     if (plan->send_offset == NULL || plan->send_size == NULL ||
-        plan->send_proc == NULL || plan->packplan == NULL) return NULL;
+        plan->send_proc == NULL || plan->send_chunk == NULL ||
+        plan->packplan == NULL) return NULL;
   }
 
-  // store send info, with self as last entry
+  // store send info, with self as last entries
 
   nsend = 0;
   iproc = me;
   for (i = 0; i < nprocs; i++) {
     iproc++;
     if (iproc == nprocs) iproc = 0;
-    if (remap_3d_collide(&in,&outarray[iproc],&overlap)) {
+    for (ichunk = 0; ichunk < nchunk; ichunk++) {
+      remap_3d_chunk(&in,ichunk,nchunk,&chunk);
+      if (!remap_3d_collide(&chunk,&outarray[iproc],&overlap)) continue;
       plan->send_proc[nsend] = iproc;
+      plan->send_chunk[nsend] = ichunk;
       plan->send_offset[nsend] = nqty *
         ((overlap.klo-in.klo)*in.jsize*in.isize +
          ((overlap.jlo-in.jlo)*in.isize + overlap.ilo-in.ilo));
@@ -340,14 +455,12 @@ struct remap_plan_3d *remap_3d_create_plan(
   }
 
   // plan->nsend = # of sends not including self
+  // for collectives include self in nsend list
 
-  if (nsend && plan->send_proc[nsend-1] == me) {
-    if (plan->usecollective) // for collectives include self in nsend list
-      plan->nsend = nsend;
-    else
-      plan->nsend = nsend - 1;
-  } else
-    plan->nsend = nsend;
+  plan->nsend = nsend;
+  if (!plan->usecollective)
+    while (plan->nsend && plan->send_proc[plan->nsend-1] == me)
+      plan->nsend--;
 
   // combine input extents across all procs
 
@@ -361,7 +474,10 @@ struct remap_plan_3d *remap_3d_create_plan(
   for (i = 0; i < nprocs; i++) {
     iproc++;
     if (iproc == nprocs) iproc = 0;
-    nrecv += remap_3d_collide(&out,&inarray[iproc],&overlap);
+    for (ichunk = 0; ichunk < nchunk; ichunk++) {
+      remap_3d_chunk(&inarray[iproc],ichunk,nchunk,&chunk);
+      nrecv += remap_3d_collide(&out,&chunk,&overlap);
+    }
   }
 
   // malloc space for recv info
@@ -389,17 +505,20 @@ struct remap_plan_3d *remap_3d_create_plan(
     plan->recv_offset = (int *) malloc(nrecv*sizeof(int));
     plan->recv_size = (int *) malloc(nrecv*sizeof(int));
     plan->recv_proc = (int *) malloc(nrecv*sizeof(int));
+    plan->recv_chunk = (int *) malloc(nrecv*sizeof(int));
     plan->recv_bufloc = (int *) malloc(nrecv*sizeof(int));
     plan->request = (MPI_Request *) malloc(nrecv*sizeof(MPI_Request));
     plan->unpackplan = (struct pack_plan_3d *)
       malloc(nrecv*sizeof(struct pack_plan_3d));
 
     if (plan->recv_offset == NULL || plan->recv_size == NULL ||
-        plan->recv_proc == NULL || plan->recv_bufloc == NULL ||
+        plan->recv_proc == NULL || plan->recv_chunk == NULL ||
+        plan->recv_bufloc == NULL ||
         plan->request == NULL || plan->unpackplan == NULL) return NULL;
   }
 
-  // store recv info, with self as last entry
+  // store recv info, with self as last entries
+  // self chunks are in the same order as the self sends
 
   ibuf = 0;
   nrecv = 0;
@@ -408,8 +527,11 @@ struct remap_plan_3d *remap_3d_create_plan(
   for (i = 0; i < nprocs; i++) {
     iproc++;
     if (iproc == nprocs) iproc = 0;
-    if (remap_3d_collide(&out,&inarray[iproc],&overlap)) {
+    for (ichunk = 0; ichunk < nchunk; ichunk++) {
+      remap_3d_chunk(&inarray[iproc],ichunk,nchunk,&chunk);
+      if (!remap_3d_collide(&out,&chunk,&overlap)) continue;
       plan->recv_proc[nrecv] = iproc;
+      plan->recv_chunk[nrecv] = ichunk;
       plan->recv_bufloc[nrecv] = ibuf;
 
       if (permute == 0) {
@@ -558,17 +680,16 @@ struct remap_plan_3d *remap_3d_create_plan(
   // plan->nrecv = # of recvs not including self
   // for collectives include self in the nsend list
 
-  if (nrecv && plan->recv_proc[nrecv-1] == me) {
-    if (plan->usecollective) plan->nrecv = nrecv;
-    else plan->nrecv = nrecv - 1;
-  } else plan->nrecv = nrecv;
+  plan->nrecv = nrecv;
+  if (!plan->usecollective)
+    while (plan->nrecv && plan->recv_proc[plan->nrecv-1] == me)
+      plan->nrecv--;
 
   // init remaining fields in remap plan
+  // self = # of messages to myself, one per chunk that has data
 
   plan->memory = memory;
-
-  if (nrecv == plan->nrecv) plan->self = 0;
-  else plan->self = 1;
+  plan->self = nrecv - plan->nrecv;
 
   // free locally malloced space
 
@@ -576,12 +697,26 @@ struct remap_plan_3d *remap_3d_create_plan(
   free(outarray);
 
   // find biggest send message (not including self) and malloc space for it
+  // with chunks, sends are non-blocking and every message needs its own space
 
   plan->sendbuf = NULL;
+  plan->send_bufloc = NULL;
+  plan->send_request = NULL;
 
   size = 0;
-  for (nsend = 0; nsend < plan->nsend; nsend++)
-    size = MAX(size,plan->send_size[nsend]);
+  if (nchunk == 1) {
+    for (nsend = 0; nsend < plan->nsend; nsend++)
+      size = MAX(size,plan->send_size[nsend]);
+  } else if (plan->nsend) {
+    plan->send_bufloc = (int *) malloc(plan->nsend*sizeof(int));
+    plan->send_request =
+      (MPI_Request *) malloc(plan->nsend*sizeof(MPI_Request));
+    if (plan->send_bufloc == NULL || plan->send_request == NULL) return NULL;
+    for (nsend = 0; nsend < plan->nsend; nsend++) {
+      plan->send_bufloc[nsend] = size;
+      size += plan->send_size[nsend];
+    }
+  }
 
   if (size) {
     plan->sendbuf = (FFT_SCALAR *) malloc(size*sizeof(FFT_SCALAR));
@@ -648,18 +783,24 @@ void remap_3d_destroy_plan(struct remap_plan_3d *plan)
 
   // free internal arrays
 
+  free(plan->chunk_line);
+
   if (plan->nsend || plan->self) {
     free(plan->send_offset);
     free(plan->send_size);
     free(plan->send_proc);
+    free(plan->send_chunk);
     free(plan->packplan);
     if (plan->sendbuf) free(plan->sendbuf);
+    if (plan->send_bufloc) free(plan->send_bufloc);
+    if (plan->send_request) free(plan->send_request);
   }
 
   if (plan->nrecv || plan->self) {
     free(plan->recv_offset);
     free(plan->recv_size);
     free(plan->recv_proc);
+    free(plan->recv_chunk);
     free(plan->recv_bufloc);
     free(plan->request);
     free(plan->unpackplan);
@@ -699,3 +840,19 @@ int remap_3d_collide(struct extent_3d *block1, struct extent_3d *block2,
 
   return 1;
 }
+
+/* ----------------------------------------------------------------------
+   extract chunk ichunk of nchunk from block, split along the slow index
+   chunk is empty (khi < klo) if block has fewer slow planes than chunks
+------------------------------------------------------------------------- */
+
+void remap_3d_chunk(struct extent_3d *block, int ichunk, int nchunk,
+                    struct extent_3d *chunk)
+{
+  int ksize = MAX(block->ksize,0);
+
+  *chunk = *block;
+  chunk->klo = block->klo + ichunk*ksize/nchunk;
+  chunk->khi = block->klo + (ichunk+1)*ksize/nchunk - 1;
+  chunk->ksize = chunk->khi - chunk->klo + 1;
+}
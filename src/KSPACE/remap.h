@@ -33,16 +33,22 @@ struct remap_plan_3d {
   int *send_offset;                 // extraction loc for each send
   int *send_size;                   // size of each send message
   int *send_proc;                   // proc to send each message to
+  int *send_chunk;                  // chunk of input each send comes from
+  int *send_bufloc;                 // offset in sendbuf for each send
+  MPI_Request *send_request;        // MPI request for each posted send
   struct pack_plan_3d *packplan;    // pack plan for each send message
   int *recv_offset;                 // insertion loc for each recv
   int *recv_size;                   // size of each recv message
   int *recv_proc;                   // proc to recv each message from
+  int *recv_chunk;                  // chunk of sender's input in each recv
   int *recv_bufloc;                 // offset in scratch buf for each recv
   MPI_Request *request;             // MPI request for each posted recv
   struct pack_plan_3d *unpackplan;  // unpack plan for each recv message
   int nrecv;                        // # of recvs from other procs
   int nsend;                        // # of sends to other procs
-  int self;                         // whether I send/recv with myself
+  int self;                         // # of messages I send/recv with myself
+  int nchunk;                       // # of chunks input is sent in
+  int *chunk_line;                  // first input line of each chunk
   int memory;                       // user provides scratch space or not
   MPI_Comm comm;                    // group of procs performing remap
   int usecollective;                // use collective or point-to-point MPI
@@ -61,10 +67,14 @@ struct extent_3d {
 // function prototypes
 
 void remap_3d(FFT_SCALAR *, FFT_SCALAR *, FFT_SCALAR *, struct remap_plan_3d *);
+void remap_3d_begin(FFT_SCALAR *, struct remap_plan_3d *);
+void remap_3d_send(FFT_SCALAR *, FFT_SCALAR *, int, struct remap_plan_3d *);
+void remap_3d_end(FFT_SCALAR *, FFT_SCALAR *, struct remap_plan_3d *);
 struct remap_plan_3d *remap_3d_create_plan(MPI_Comm,
                                            int, int, int, int, int, int,
                                            int, int, int, int, int, int,
-                                           int, int, int, int, int);
+                                           int, int, int, int, int, int);
 void remap_3d_destroy_plan(struct remap_plan_3d *);
 int remap_3d_collide(struct extent_3d *,
                      struct extent_3d *, struct extent_3d *);
+void remap_3d_chunk(struct extent_3d *, int, int, struct extent_3d *);
@@ -38,6 +38,7 @@ PairEAM::PairEAM(LAMMPS *lmp) : Pair(lmp)
 {
   restartinfo = 0;
   manybody_flag = 1;
+  energy_local_enable = 1;
 
   nmax = 0;
   rho = NULL;
@@ -317,6 +318,67 @@ void PairEAM::compute(int eflag, int vflag)
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   energy of owned atom I = embedding energy + half of its pair energies
+   density of I is summed over its full neighbor list, so this only
+     depends on the types of I and its neighbors
+------------------------------------------------------------------------- */
+
+double PairEAM::energy_local(int i, NeighList *listfull)
+{
+  int j,jj,m,jtype;
+  double delx,dely,delz,rsq,r,p,rhoi,phi,energy;
+  double *coeff;
+
+  double **x = atom->x;
+  int *type = atom->type;
+  int itype = type[i];
+
+  int *jlist = listfull->firstneigh[i];
+  int jnum = listfull->numneigh[i];
+
+  rhoi = 0.0;
+  energy = 0.0;
+
+  for (jj = 0; jj < jnum; jj++) {
+    j = jlist[jj];
+    j &= NEIGHMASK;
+
+    delx = x[i][0] - x[j][0];
+    dely = x[i][1] - x[j][1];
+    delz = x[i][2] - x[j][2];
+    rsq = delx*delx + dely*dely + delz*delz;
+
+    if (rsq < cutforcesq) {
+      jtype = type[j];
+      r = sqrt(rsq);
+      p = r*rdr + 1.0;
+      m = static_cast<int> (p);
+      m = MIN(m,nr-1);
+      p -= m;
+      p = MIN(p,1.0);
+      coeff = rhor_spline[type2rhor[jtype][itype]][m];
+      rhoi += ((coeff[3]*p + coeff[4])*p + coeff[5])*p + coeff[6];
+      coeff = z2r_spline[type2z2r[itype][jtype]][m];
+      phi = (((coeff[3]*p + coeff[4])*p + coeff[5])*p + coeff[6]) / r;
+      energy += 0.5*scale[itype][jtype]*phi;
+    }
+  }
+
+  p = rhoi*rdrho + 1.0;
+  m = static_cast<int> (p);
+  m = MAX(1,MIN(m,nrho-1));
+  p -= m;
+  p = MIN(p,1.0);
+  coeff = frho_spline[type2frho[itype]][m];
+  phi = ((coeff[3]*p + coeff[4])*p + coeff[5])*p + coeff[6];
+  if (rhoi > rhomax) phi += ((coeff[0]*p + coeff[1])*p + coeff[2]) *
+                       (rhoi-rhomax);
+  energy += scale[itype][itype]*phi;
+
+  return energy;
+}
+
 /* ----------------------------------------------------------------------
    allocate all arrays
 ------------------------------------------------------------------------- */
@@ -39,6 +39,7 @@ PairEAMCD::PairEAMCD(LAMMPS *lmp, int _cdeamVersion)
   : PairEAM(lmp), PairEAMAlloy(lmp), cdeamVersion(_cdeamVersion)
 {
   single_enable = 0;
+  energy_local_enable = 0;
   restartinfo = 0;
 
   rhoB = NULL;
@@ -44,6 +44,7 @@ PairSW::PairSW(LAMMPS *lmp) : Pair(lmp)
   restartinfo = 0;
   one_coeff = 1;
   manybody_flag = 1;
+  energy_local_enable = 1;
 
   nelements = 0;
   elements = NULL;
@@ -221,6 +222,83 @@ void PairSW::compute(int eflag, int vflag)
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   energy of owned atom I = two-body terms of the I-J pairs that
+     compute() assigns to I + three-body terms centered on I
+------------------------------------------------------------------------- */
+
+double PairSW::energy_local(int i, NeighList *listfull)
+{
+  int j,k,jj,kk,itype,jtype,ktype,ijparam,ikparam,ijkparam,pairflag;
+  tagint itag,jtag;
+  double xtmp,ytmp,ztmp,evdwl,fpair,rsq1,rsq2;
+  double delr1[3],delr2[3],fj[3],fk[3];
+
+  double **x = atom->x;
+  tagint *tag = atom->tag;
+  int *type = atom->type;
+
+  int *jlist = listfull->firstneigh[i];
+  int jnum = listfull->numneigh[i];
+
+  itag = tag[i];
+  itype = map[type[i]];
+  xtmp = x[i][0];
+  ytmp = x[i][1];
+  ztmp = x[i][2];
+
+  double energy = 0.0;
+
+  for (jj = 0; jj < jnum; jj++) {
+    j = jlist[jj];
+    j &= NEIGHMASK;
+    jtype = map[type[j]];
+    ijparam = elem2param[itype][jtype][jtype];
+
+    delr1[0] = x[j][0] - xtmp;
+    delr1[1] = x[j][1] - ytmp;
+    delr1[2] = x[j][2] - ztmp;
+    rsq1 = delr1[0]*delr1[0] + delr1[1]*delr1[1] + delr1[2]*delr1[2];
+    if (rsq1 >= params[ijparam].cutsq) continue;
+
+    // two-body interaction, same choice of half of the pairs as compute()
+
+    jtag = tag[j];
+    if (itag > jtag) pairflag = (itag+jtag) % 2;
+    else if (itag < jtag) pairflag = !((itag+jtag) % 2);
+    else pairflag = !(x[j][2] < ztmp ||
+                      (x[j][2] == ztmp && x[j][1] < ytmp) ||
+                      (x[j][2] == ztmp && x[j][1] == ytmp && x[j][0] < xtmp));
+
+    if (pairflag) {
+      twobody(&params[ijparam],rsq1,fpair,1,evdwl);
+      energy += evdwl;
+    }
+
+    // three-body interactions with each later K
+
+    for (kk = jj+1; kk < jnum; kk++) {
+      k = jlist[kk];
+      k &= NEIGHMASK;
+      ktype = map[type[k]];
+      ikparam = elem2param[itype][ktype][ktype];
+      ijkparam = elem2param[itype][jtype][ktype];
+
+      delr2[0] = x[k][0] - xtmp;
+      delr2[1] = x[k][1] - ytmp;
+      delr2[2] = x[k][2] - ztmp;
+      rsq2 = delr2[0]*delr2[0] + delr2[1]*delr2[1] + delr2[2]*delr2[2];
+      if (rsq2 >= params[ikparam].cutsq) continue;
+
+      threebody(&params[ijparam],&params[ikparam],&params[ijkparam],
+                rsq1,rsq2,delr1,delr2,fj,fk,1,evdwl);
+      energy += evdwl;
+    }
+  }
+
+  return energy;
+}
+
 /* ---------------------------------------------------------------------- */
 
 void PairSW::allocate()
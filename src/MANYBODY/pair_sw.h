@@ -33,6 +33,7 @@ class PairSW : public Pair {
   virtual void coeff(int, char **);
   virtual double init_one(int, int);
   virtual void init_style();
+  double energy_local(int, class NeighList *);
 
   struct Param {
     double epsilon,sigma;
@@ -33,6 +33,7 @@ class PairTersoff : public Pair {
   void coeff(int, char **);
   virtual void init_style();
   double init_one(int, int);
+  double energy_local(int, class NeighList *);
 
  protected:
   struct Param {
@@ -46,6 +46,8 @@
 #include "thermo.h"
 #include "output.h"
 #include "neighbor.h"
+#include "neigh_list.h"
+#include "neigh_request.h"
 #include <iostream>
 
 using namespace std;
@@ -60,6 +62,8 @@ FixAtomSwap::FixAtomSwap(LAMMPS *lmp, int narg, char **arg) :
   idregion(NULL), type_list(NULL), mu(NULL), qtype(NULL),
   sqrt_mass_ratio(NULL), local_swap_iatom_list(NULL),
   local_swap_jatom_list(NULL), local_swap_atom_list(NULL),
+  list(NULL), select_list(NULL), select_flag(NULL),
+  ghost_numneigh(NULL), ghost_firstneigh(NULL), ghost_neigh(NULL),
   random_equal(NULL), random_unequal(NULL), c_pe(NULL)
 {
   if (narg < 10) error->all(FLERR,"Illegal fix atom/swap command");
@@ -116,6 +120,10 @@ FixAtomSwap::FixAtomSwap(LAMMPS *lmp, int narg, char **arg) :
   local_swap_iatom_list = NULL;
   local_swap_jatom_list = NULL;
 
+  localflag = 0;
+  nselect = select_nmax = 0;
+  ghost_nmax = ghost_maxneigh = 0;
+
   // set comm size needed by this Fix
 
   if (atom->q_flag) comm_forward = 2;
@@ -194,6 +202,11 @@ FixAtomSwap::~FixAtomSwap()
   memory->destroy(mu);
   memory->destroy(qtype);
   memory->destroy(sqrt_mass_ratio);
+  memory->destroy(select_list);
+  memory->destroy(select_flag);
+  memory->destroy(ghost_numneigh);
+  memory->destroy(ghost_firstneigh);
+  memory->destroy(ghost_neigh);
   if (regionflag) delete [] idregion;
   delete random_equal;
   delete random_unequal;
@@ -281,6 +294,21 @@ void FixAtomSwap::init()
         if (cutsq[type_list[iswaptype]][ktype] != cutsq[type_list[jswaptype]][ktype])
           unequal_cutoffs = true;
 
+  // if pair style can compute the energy of single atoms,
+  //   request an occasional full neighbor list,
+  //   so the energy change of a swap only needs atoms near swapped atoms
+  // not possible if reneighboring is needed between swaps
+
+  list = NULL;
+  if (force->pair->energy_local_enable && !unequal_cutoffs) {
+    int irequest = neighbor->request(this,instance_me);
+    neighbor->requests[irequest]->pair = 0;
+    neighbor->requests[irequest]->fix = 1;
+    neighbor->requests[irequest]->half = 0;
+    neighbor->requests[irequest]->full = 1;
+    neighbor->requests[irequest]->occasional = 1;
+  }
+
   // check that no swappable atoms are in atom->firstgroup
   // swapping such an atom might not leave firstgroup atoms first
 
@@ -300,6 +328,13 @@ void FixAtomSwap::init()
   }
 }
 
+/* ---------------------------------------------------------------------- */
+
+void FixAtomSwap::init_list(int /*id*/, NeighList *ptr)
+{
+  list = ptr;
+}
+
 /* ----------------------------------------------------------------------
    attempt Monte Carlo swaps
 ------------------------------------------------------------------------- */
@@ -318,6 +353,18 @@ void FixAtomSwap::pre_exchange()
   if (modify->n_pre_neighbor) modify->pre_neighbor();
   neighbor->build(1);
 
+  // use local energy changes only if no other term depends on atom types,
+  //   i.e. no KSpace, no pre_force() fixes, and no fix energy contributions
+  // fix lists are only known after Modify::init(), so check it here
+
+  localflag = 0;
+  if (list && !force->kspace && modify->n_pre_force == 0 &&
+      modify->n_thermo_energy == 0) {
+    localflag = 1;
+    neighbor->build_one(list);
+    ghost_neighbors();
+  }
+
   energy_stored = energy_full();
 
   int nsuccess = 0;
@@ -348,6 +395,13 @@ int FixAtomSwap::attempt_semi_grand()
 
   int itype,jtype,jswaptype;
   int i = pick_semi_grand_atom();
+
+  double energy_local_before = 0.0;
+  if (localflag) {
+    select_local(i,-1);
+    energy_local_before = energy_local();
+  }
+
   if (i >= 0) {
     jswaptype = static_cast<int> (nswaptypes*random_unequal->uniform());
     jtype = type_list[jswaptype];
@@ -372,7 +426,11 @@ int FixAtomSwap::attempt_semi_grand()
   }
 
   if (force->kspace) force->kspace->qsum_qsq();
-  double energy_after = energy_full();
+
+  double energy_after;
+  if (localflag) energy_after = energy_before +
+                   energy_local_change(energy_local_before);
+  else energy_after = energy_full();
 
   int success = 0;
   if (i >= 0)
@@ -431,6 +489,12 @@ int FixAtomSwap::attempt_swap()
   int itype = type_list[0];
   int jtype = type_list[1];
 
+  double energy_local_before = 0.0;
+  if (localflag) {
+    select_local(i,j);
+    energy_local_before = energy_local();
+  }
+
   if (i >= 0) {
     atom->type[i] = jtype;
     if (atom->q_flag) atom->q[i] = qtype[1];
@@ -452,7 +516,10 @@ int FixAtomSwap::attempt_swap()
     comm->forward_comm_fix(this);
   }
 
-  double energy_after = energy_full();
+  double energy_after;
+  if (localflag) energy_after = energy_before +
+                   energy_local_change(energy_local_before);
+  else energy_after = energy_full();
 
   if (random_equal->uniform() <
       exp(beta*(energy_before - energy_after))) {
@@ -529,6 +596,215 @@ double FixAtomSwap::energy_full()
   return total_energy;
 }
 
+/* ----------------------------------------------------------------------
+   create lists of owned neighbors of ghost atoms within pair cutoff
+   inverse of the ghost entries in the full neighbor list of owned atoms
+------------------------------------------------------------------------- */
+
+void FixAtomSwap::ghost_neighbors()
+{
+  int i,j,ii,jj,inum,jnum,nghost,ntotal;
+  int *ilist,*jlist,*numneigh,**firstneigh;
+  double delx,dely,delz,rsq;
+
+  double **x = atom->x;
+  int nlocal = atom->nlocal;
+  nghost = atom->nghost;
+
+  if (nghost > ghost_nmax) {
+    memory->destroy(ghost_numneigh);
+    memory->destroy(ghost_firstneigh);
+    ghost_nmax = atom->nmax;
+    memory->create(ghost_numneigh,ghost_nmax,"atom/swap:ghost_numneigh");
+    memory->create(ghost_firstneigh,ghost_nmax,"atom/swap:ghost_firstneigh");
+  }
+
+  inum = list->inum;
+  ilist = list->ilist;
+  numneigh = list->numneigh;
+  firstneigh = list->firstneigh;
+
+  double cutsq = force->pair->cutforce * force->pair->cutforce;
+
+  // count owned neighbors of each ghost atom
+
+  for (j = 0; j < nghost; j++) ghost_numneigh[j] = 0;
+
+  for (ii = 0; ii < inum; ii++) {
+    i = ilist[ii];
+    jlist = firstneigh[i];
+    jnum = numneigh[i];
+
+    for (jj = 0; jj < jnum; jj++) {
+      j = jlist[jj];
+      j &= NEIGHMASK;
+      if (j < nlocal) continue;
+
+      delx = x[i][0] - x[j][0];
+      dely = x[i][1] - x[j][1];
+      delz = x[i][2] - x[j][2];
+      rsq = delx*delx + dely*dely + delz*delz;
+      if (rsq < cutsq) ghost_numneigh[j-nlocal]++;
+    }
+  }
+
+  ntotal = 0;
+  for (j = 0; j < nghost; j++) {
+    ghost_firstneigh[j] = ntotal;
+    ntotal += ghost_numneigh[j];
+  }
+
+  if (ntotal > ghost_maxneigh) {
+    memory->destroy(ghost_neigh);
+    ghost_maxneigh = ntotal;
+    memory->create(ghost_neigh,ghost_maxneigh,"atom/swap:ghost_neigh");
+  }
+
+  // fill lists, so they are in same order as owned atoms
+
+  for (j = 0; j < nghost; j++) ghost_numneigh[j] = 0;
+
+  for (ii = 0; ii < inum; ii++) {
+    i = ilist[ii];
+    jlist = firstneigh[i];
+    jnum = numneigh[i];
+
+    for (jj = 0; jj < jnum; jj++) {
+      j = jlist[jj];
+      j &= NEIGHMASK;
+      if (j < nlocal) continue;
+
+      delx = x[i][0] - x[j][0];
+      dely = x[i][1] - x[j][1];
+      delz = x[i][2] - x[j][2];
+      rsq = delx*delx + dely*dely + delz*delz;
+      if (rsq < cutsq) {
+        j -= nlocal;
+        ghost_neigh[ghost_firstneigh[j] + ghost_numneigh[j]++] = i;
+      }
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   select owned atoms whose energy depends on the types of atoms I and J
+   I,J = local indices of swap atoms on owning proc, else -1
+   selected atoms = owned images of I,J and owned atoms within cutoff
+     of any owned or ghost image of I,J on this proc
+------------------------------------------------------------------------- */
+
+void FixAtomSwap::select_local(int i, int j)
+{
+  int k,m,n,jj,jnum;
+  int *jlist;
+  double delx,dely,delz,rsq;
+
+  tagint *tag = atom->tag;
+  double **x = atom->x;
+  int nlocal = atom->nlocal;
+  int nall = nlocal + atom->nghost;
+
+  tagint swaptag[2],swaptagall[2];
+  swaptag[0] = (i >= 0) ? tag[i] : 0;
+  swaptag[1] = (j >= 0) ? tag[j] : 0;
+  MPI_Allreduce(swaptag,swaptagall,2,MPI_LMP_TAGINT,MPI_MAX,world);
+
+  if (atom->nmax > select_nmax) {
+    memory->destroy(select_list);
+    memory->destroy(select_flag);
+    select_nmax = atom->nmax;
+    memory->create(select_list,select_nmax,"atom/swap:select_list");
+    memory->create(select_flag,select_nmax,"atom/swap:select_flag");
+    for (k = 0; k < select_nmax; k++) select_flag[k] = 0;
+  }
+
+  double cutsq = force->pair->cutforce * force->pair->cutforce;
+  nselect = 0;
+
+  for (n = 0; n < 2; n++) {
+    if (swaptagall[n] == 0) continue;
+
+    // loop over all local images of swap atom
+    // use atom map if it exists, else search all owned and ghost atoms
+
+    if (atom->map_style) m = atom->map(swaptagall[n]);
+    else for (m = 0; m < nall; m++) if (tag[m] == swaptagall[n]) break;
+
+    while (m >= 0 && m < nall) {
+      if (m < nlocal) {
+        if (!select_flag[m]) {
+          select_flag[m] = 1;
+          select_list[nselect++] = m;
+        }
+
+        jlist = list->firstneigh[m];
+        jnum = list->numneigh[m];
+
+        for (jj = 0; jj < jnum; jj++) {
+          k = jlist[jj];
+          k &= NEIGHMASK;
+          if (k >= nlocal || select_flag[k]) continue;
+
+          delx = x[m][0] - x[k][0];
+          dely = x[m][1] - x[k][1];
+          delz = x[m][2] - x[k][2];
+          rsq = delx*delx + dely*dely + delz*delz;
+          if (rsq >= cutsq) continue;
+
+          select_flag[k] = 1;
+          select_list[nselect++] = k;
+        }
+
+      } else {
+        jlist = &ghost_neigh[ghost_firstneigh[m-nlocal]];
+        jnum = ghost_numneigh[m-nlocal];
+
+        for (jj = 0; jj < jnum; jj++) {
+          k = jlist[jj];
+          if (select_flag[k]) continue;
+          select_flag[k] = 1;
+          select_list[nselect++] = k;
+        }
+      }
+
+      if (atom->map_style) m = atom->sametag[m];
+      else {
+        for (m++; m < nall; m++) if (tag[m] == swaptagall[n]) break;
+      }
+    }
+  }
+
+  for (k = 0; k < nselect; k++) select_flag[select_list[k]] = 0;
+}
+
+/* ----------------------------------------------------------------------
+   pair energy of selected owned atoms on this proc
+------------------------------------------------------------------------- */
+
+double FixAtomSwap::energy_local()
+{
+  Pair *pair = force->pair;
+
+  double energy = 0.0;
+  for (int k = 0; k < nselect; k++)
+    energy += pair->energy_local(select_list[k],list);
+
+  return energy;
+}
+
+/* ----------------------------------------------------------------------
+   change of system potential energy since energy of selected atoms
+     was ENERGY_BEFORE on this proc
+------------------------------------------------------------------------- */
+
+double FixAtomSwap::energy_local_change(double energy_before)
+{
+  double delta = energy_local() - energy_before;
+  double deltaall;
+  MPI_Allreduce(&delta,&deltaall,1,MPI_DOUBLE,MPI_SUM,world);
+  return deltaall;
+}
+
 /* ----------------------------------------------------------------------
 ------------------------------------------------------------------------- */
 
@@ -761,6 +1037,9 @@ double FixAtomSwap::compute_vector(int n)
 double FixAtomSwap::memory_usage()
 {
   double bytes = atom_swap_nmax * sizeof(int);
+  bytes += 2 * select_nmax * sizeof(int);
+  bytes += 2 * ghost_nmax * sizeof(int);
+  bytes += ghost_maxneigh * sizeof(int);
   return bytes;
 }
 
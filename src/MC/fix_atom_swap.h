@@ -31,10 +31,15 @@ class FixAtomSwap : public Fix {
   ~FixAtomSwap();
   int setmask();
   void init();
+  void init_list(int, class NeighList *);
   void pre_exchange();
   int attempt_semi_grand();
   int attempt_swap();
   double energy_full();
+  void ghost_neighbors();
+  void select_local(int, int);
+  double energy_local();
+  double energy_local_change(double);
   int pick_semi_grand_atom();
   int pick_i_swap_atom();
   int pick_j_swap_atom();
@@ -80,6 +85,17 @@ class FixAtomSwap : public Fix {
   int *local_swap_jatom_list;
   int *local_swap_atom_list;
 
+  int localflag;                          // 1 = local energy change of swaps
+  class NeighList *list;                  // full list of owned atoms
+  int nselect;                            // # of owned atoms near swap atoms
+  int select_nmax;
+  int *select_list;                       // owned atoms near swap atoms
+  int *select_flag;                       // 1 if atom is in select_list
+  int ghost_nmax,ghost_maxneigh;
+  int *ghost_numneigh;                    // # of owned neighbors of ghosts
+  int *ghost_firstneigh;                  // offset of each ghost into
+  int *ghost_neigh;                       //   owned neighbors of ghosts
+
   class RanPark *random_equal;
   class RanPark *random_unequal;
 
@@ -120,7 +120,7 @@ void FixTFMC::init()
   // (and real MD in general)
   int has_shake = 0;
   for (int i = 0; i < modify->nfix; i++)
-    if (strcmp(modify->fix[i]->style,"shake") == 0) ++has_shake;
+    if (strncmp(modify->fix[i]->style,"shake",5) == 0) ++has_shake;
 
   if (has_shake > 0)
     error->all(FLERR,"Fix tfmc is not compatible with fix shake");
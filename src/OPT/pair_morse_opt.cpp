@@ -29,7 +29,10 @@ using namespace LAMMPS_NS;
 
 /* ---------------------------------------------------------------------- */
 
-PairMorseOpt::PairMorseOpt(LAMMPS *lmp) : PairMorse(lmp) {}
+PairMorseOpt::PairMorseOpt(LAMMPS *lmp) : PairMorse(lmp)
+{
+  fuse_enable = 0;
+}
 
 /* ---------------------------------------------------------------------- */
 
@@ -50,6 +50,7 @@ FixQEq::FixQEq(LAMMPS *lmp, int narg, char **arg) :
   gamma(NULL), zeta(NULL), zcore(NULL), chizj(NULL), shld(NULL),
   s(NULL), t(NULL), s_hist(NULL), t_hist(NULL), Hdia_inv(NULL), b_s(NULL),
   b_t(NULL), p(NULL), q(NULL), r(NULL), d(NULL),
+  y(NULL), u(NULL), w(NULL), z(NULL), h(NULL),
   qf(NULL), q1(NULL), q2(NULL), qv(NULL)
 {
   if (narg < 8) error->all(FLERR,"Illegal fix qeq command");
@@ -75,7 +76,31 @@ FixQEq::FixQEq(LAMMPS *lmp, int narg, char **arg) :
   pack_flag = 0;
   s = NULL;
   t = NULL;
-  nprev = 5;
+
+  // optional args for the CG solver
+  // dual = solve for s and t together, pipeline = dual with overlapped comm
+  // nprev = # of previous solutions used to extrapolate the initial guess
+  // other keywords are processed by derived classes
+
+  dual_enabled = 0;
+  pipeline = 0;
+  nprev = 4;
+
+  int iarg = 8;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"dual") == 0) {
+      dual_enabled = 1;
+      iarg++;
+    } else if (strcmp(arg[iarg],"pipeline") == 0) {
+      dual_enabled = pipeline = 1;
+      iarg++;
+    } else if (strcmp(arg[iarg],"nprev") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix qeq command");
+      nprev = force->inumeric(FLERR,arg[iarg+1]);
+      if (nprev < 2) error->all(FLERR,"Illegal fix qeq command");
+      iarg += 2;
+    } else iarg++;
+  }
 
   Hdia_inv = NULL;
   b_s = NULL;
@@ -103,7 +128,8 @@ FixQEq::FixQEq(LAMMPS *lmp, int narg, char **arg) :
   reax_flag = 0;
   qv = NULL;
 
-  comm_forward = comm_reverse = 1;
+  if (dual_enabled) comm_forward = comm_reverse = 2;
+  else comm_forward = comm_reverse = 1;
 
   // perform initial allocation of atom-based arrays
   // register with Atom class
@@ -116,6 +142,15 @@ FixQEq::FixQEq(LAMMPS *lmp, int narg, char **arg) :
     for (int j = 0; j < nprev; ++j )
       s_hist[i][j] = t_hist[i][j] = atom->q[i];
 
+  // polynomial extrapolation through the last nprev values of s
+  // and the last nprev-1 values of t
+
+  memory->create(s_extrap,nprev,"qeq:s_extrap");
+  memory->create(t_extrap,nprev,"qeq:t_extrap");
+  extrapolation_weights(s_extrap,nprev);
+  extrapolation_weights(t_extrap,nprev-1);
+  t_extrap[nprev-1] = 0.0;
+
   if (strcmp(arg[7],"coul/streitz") == 0) {
     streitz_flag = 1;
   } else if (strcmp(arg[7],"reax/c") == 0) {
@@ -135,6 +170,8 @@ FixQEq::~FixQEq()
 
   memory->destroy(s_hist);
   memory->destroy(t_hist);
+  memory->destroy(s_extrap);
+  memory->destroy(t_extrap);
 
   deallocate_storage();
   deallocate_matrix();
@@ -173,10 +210,23 @@ void FixQEq::allocate_storage()
   memory->create(b_s,nmax,"qeq:b_s");
   memory->create(b_t,nmax,"qeq:b_t");
 
-  memory->create(p,nmax,"qeq:p");
-  memory->create(q,nmax,"qeq:q");
-  memory->create(r,nmax,"qeq:r");
-  memory->create(d,nmax,"qeq:d");
+  // dual CG support
+
+  int size = nmax;
+  if (dual_enabled) size *= 2;
+
+  memory->create(p,size,"qeq:p");
+  memory->create(q,size,"qeq:q");
+  memory->create(r,size,"qeq:r");
+  memory->create(d,size,"qeq:d");
+
+  if (dual_enabled) memory->create(y,size,"qeq:y");
+  if (pipeline) {
+    memory->create(u,size,"qeq:u");
+    memory->create(w,size,"qeq:w");
+    memory->create(z,size,"qeq:z");
+    memory->create(h,size,"qeq:h");
+  }
 
   memory->create(chizj,nmax,"qeq:chizj");
   memory->create(qf,nmax,"qeq:qf");
@@ -202,6 +252,12 @@ void FixQEq::deallocate_storage()
   memory->destroy( r );
   memory->destroy( d );
 
+  memory->destroy( y );
+  memory->destroy( u );
+  memory->destroy( w );
+  memory->destroy( z );
+  memory->destroy( h );
+
   memory->destroy( chizj );
   memory->destroy( qf );
   memory->destroy( q1 );
@@ -437,6 +493,234 @@ void FixQEq::sparse_matvec( sparse_matrix *A, double *x, double *b )
 
 }
 
+/* ----------------------------------------------------------------------
+   solve H s = b_s and H t = b_t together as one block system
+   s and t values of CG vectors are interleaved, so that each iteration
+     needs a single matvec with one forward and one reverse comm
+   single-reduction PCG of Chronopoulos and Gear: both dot products
+     of both systems are summed in one collective per iteration
+   with pipeline set, that collective is posted non-blocking and
+     overlaps the matvec, see Ghysels and Vanroose, Parallel Comput,
+     40, 224 (2014)
+   a system that has converged is frozen while the other one continues
+------------------------------------------------------------------------- */
+
+int FixQEq::dual_CG( double *b1, double *b2, double *x1, double *x2 )
+{
+  int  loop, i, ii, k, inum, *ilist;
+  double alfa[2], beta[2], sig_old[2], b_norm[2], res;
+  double my_buf[4], buf[4];
+  int active[2];
+  double *x[2];
+  MPI_Request request;
+
+  inum = list->inum;
+  ilist = list->ilist;
+  nall = atom->nlocal + atom->nghost;
+
+  int *mask = atom->mask;
+  x[0] = x1;
+  x[1] = x2;
+
+  // without pipelining, u and w = A u are the forwarded d
+  //   and reverse summed q of the matvec
+  // with pipelining, d and q hold m = M w and n = A m instead
+
+  double *uu = pipeline ? u : d;
+  double *ww = pipeline ? w : q;
+
+  // initial residual r = b - A x and u = M r
+  // s and t of ghost atoms are current, so no forward comm of d is needed
+
+  pack_flag = 5;
+  for( i = 0; i < nall; ++i ) {
+    d[2*i  ] = x1[i];
+    d[2*i+1] = x2[i];
+  }
+  dual_sparse_matvec( &H, d, q );
+  comm->reverse_comm_fix( this );
+
+  my_buf[0] = my_buf[1] = 0.0;
+  for( ii = 0; ii < inum; ++ii ) {
+    i = ilist[ii];
+    if (mask[i] & groupbit) {
+      r[2*i  ] = b1[i] - q[2*i  ];
+      r[2*i+1] = b2[i] - q[2*i+1];
+      d[2*i  ] = r[2*i  ] * Hdia_inv[i];
+      d[2*i+1] = r[2*i+1] * Hdia_inv[i];
+      p[2*i] = p[2*i+1] = y[2*i] = y[2*i+1] = 0.0;
+      if (pipeline) z[2*i] = z[2*i+1] = h[2*i] = h[2*i+1] = 0.0;
+      my_buf[0] += b1[i] * b1[i];
+      my_buf[1] += b2[i] * b2[i];
+    }
+  }
+
+  MPI_Allreduce( my_buf, buf, 2, MPI_DOUBLE, MPI_SUM, world );
+  b_norm[0] = sqrt(buf[0]);
+  b_norm[1] = sqrt(buf[1]);
+
+  // w = A u
+
+  comm->forward_comm_fix( this );
+  dual_sparse_matvec( &H, d, q );
+  comm->reverse_comm_fix( this );
+
+  if (pipeline) {
+    for( ii = 0; ii < inum; ++ii ) {
+      i = ilist[ii];
+      if (mask[i] & groupbit) {
+        u[2*i  ] = d[2*i  ];
+        u[2*i+1] = d[2*i+1];
+        w[2*i  ] = q[2*i  ];
+        w[2*i+1] = q[2*i+1];
+      }
+    }
+  }
+
+  active[0] = active[1] = 1;
+  alfa[0] = alfa[1] = 1.0;
+  sig_old[0] = sig_old[1] = 1.0;
+  res = 0.0;
+
+  for( loop = 1; loop < maxiter; ++loop ) {
+
+    // sigma = (r,u) and delta = (w,u) for both systems in one reduction
+
+    for( k = 0; k < 4; k++ ) my_buf[k] = 0.0;
+    for( ii = 0; ii < inum; ++ii ) {
+      i = ilist[ii];
+      if (mask[i] & groupbit) {
+        my_buf[0] += r[2*i  ] * uu[2*i  ];
+        my_buf[1] += r[2*i+1] * uu[2*i+1];
+        my_buf[2] += ww[2*i  ] * uu[2*i  ];
+        my_buf[3] += ww[2*i+1] * uu[2*i+1];
+      }
+    }
+
+    if (pipeline) {
+      MPI_Iallreduce( my_buf, buf, 4, MPI_DOUBLE, MPI_SUM, world, &request );
+
+      // m = M w and n = A m while the reduction is in flight
+
+      for( ii = 0; ii < inum; ++ii ) {
+        i = ilist[ii];
+        if (mask[i] & groupbit) {
+          d[2*i  ] = w[2*i  ] * Hdia_inv[i];
+          d[2*i+1] = w[2*i+1] * Hdia_inv[i];
+        }
+      }
+
+      comm->forward_comm_fix( this );
+      dual_sparse_matvec( &H, d, q );
+      comm->reverse_comm_fix( this );
+
+      MPI_Wait( &request, MPI_STATUS_IGNORE );
+    } else MPI_Allreduce( my_buf, buf, 4, MPI_DOUBLE, MPI_SUM, world );
+
+    res = 0.0;
+    for( k = 0; k < 2; k++ ) {
+      if (!active[k]) continue;
+      if (sqrt(buf[k])/b_norm[k] <= tolerance) {
+        active[k] = 0;
+        continue;
+      }
+      res = MAX(res,sqrt(buf[k])/b_norm[k]);
+      if (loop == 1) {
+        beta[k] = 0.0;
+        alfa[k] = buf[k] / buf[2+k];
+      } else {
+        beta[k] = buf[k] / sig_old[k];
+        alfa[k] = buf[k] / (buf[2+k] - beta[k] * buf[k] / alfa[k]);
+      }
+      sig_old[k] = buf[k];
+    }
+
+    if (!active[0] && !active[1]) break;
+
+    for( ii = 0; ii < inum; ++ii ) {
+      i = ilist[ii];
+      if (mask[i] & groupbit) {
+        for( k = 0; k < 2; k++ ) {
+          if (!active[k]) continue;
+          int m = 2*i + k;
+          p[m] = uu[m] + beta[k] * p[m];
+          y[m] = ww[m] + beta[k] * y[m];
+          x[k][i] += alfa[k] * p[m];
+          r[m] -= alfa[k] * y[m];
+          if (pipeline) {
+            z[m] = q[m] + beta[k] * z[m];
+            h[m] = d[m] + beta[k] * h[m];
+            u[m] -= alfa[k] * h[m];
+            w[m] -= alfa[k] * z[m];
+          }
+        }
+      }
+    }
+
+    if (pipeline) continue;
+
+    // u = M r and w = A u for the next iteration
+
+    for( ii = 0; ii < inum; ++ii ) {
+      i = ilist[ii];
+      if (mask[i] & groupbit) {
+        d[2*i  ] = r[2*i  ] * Hdia_inv[i];
+        d[2*i+1] = r[2*i+1] * Hdia_inv[i];
+      }
+    }
+
+    comm->forward_comm_fix( this );
+    dual_sparse_matvec( &H, d, q );
+    comm->reverse_comm_fix( this );
+  }
+
+  if (loop >= maxiter && comm->me == 0) {
+    char str[128];
+    sprintf(str,"Fix qeq dual CG convergence failed (%g) after %d iterations "
+            "at " BIGINT_FORMAT " step",res,loop,update->ntimestep);
+    error->warning(FLERR,str);
+  }
+
+  return loop;
+}
+
+/* ----------------------------------------------------------------------
+   b = A x for interleaved x and b
+------------------------------------------------------------------------- */
+
+void FixQEq::dual_sparse_matvec( sparse_matrix *A, double *x, double *b )
+{
+  int i, j, itr_j;
+
+  nlocal = atom->nlocal;
+  nall = atom->nlocal + atom->nghost;
+
+  for( i = 0; i < nlocal; ++i ) {
+    if (atom->mask[i] & groupbit) {
+      b[2*i  ] = eta[ atom->type[i] ] * x[2*i  ];
+      b[2*i+1] = eta[ atom->type[i] ] * x[2*i+1];
+    }
+  }
+
+  for( i = nlocal; i < nall; ++i ) {
+    if (atom->mask[i] & groupbit)
+      b[2*i] = b[2*i+1] = 0;
+  }
+
+  for( i = 0; i < nlocal; ++i ) {
+    if (atom->mask[i] & groupbit) {
+      for( itr_j=A->firstnbr[i]; itr_j<A->firstnbr[i]+A->numnbrs[i]; itr_j++) {
+        j = A->jlist[itr_j];
+        b[2*i  ] += A->val[itr_j] * x[2*j  ];
+        b[2*i+1] += A->val[itr_j] * x[2*j+1];
+        b[2*j  ] += A->val[itr_j] * x[2*i  ];
+        b[2*j+1] += A->val[itr_j] * x[2*i+1];
+      }
+    }
+  }
+
+}
+
 /* ---------------------------------------------------------------------- */
 
 void FixQEq::calculate_Q()
@@ -458,7 +742,7 @@ void FixQEq::calculate_Q()
     if (atom->mask[i] & groupbit) {
       q[i] = s[i] - u * t[i];
 
-      for( k = 4; k > 0; --k ) {
+      for( k = nprev-1; k > 0; --k ) {
         s_hist[i][k] = s_hist[i][k-1];
         t_hist[i][k] = t_hist[i][k-1];
       }
@@ -471,6 +755,20 @@ void FixQEq::calculate_Q()
   comm->forward_comm_fix( this ); //Dist_vector( atom->q );
 }
 
+/* ----------------------------------------------------------------------
+   weights of a polynomial extrapolation through the last n values
+   weight of the k-th most recent value is (-1)^(k+1) C(n,k), k = 1..n
+------------------------------------------------------------------------- */
+
+void FixQEq::extrapolation_weights(double *weight, int n)
+{
+  double binom = 1.0;
+  for (int k = 1; k <= n; k++) {
+    binom = binom * (n-k+1) / k;
+    weight[k-1] = (k % 2) ? binom : -binom;
+  }
+}
+
 /* ---------------------------------------------------------------------- */
 
 int FixQEq::pack_forward_comm(int n, int *list, double *buf,
@@ -486,6 +784,14 @@ int FixQEq::pack_forward_comm(int n, int *list, double *buf,
     for(m = 0; m < n; m++) buf[m] = t[list[m]];
   else if( pack_flag == 4 )
     for(m = 0; m < n; m++) buf[m] = atom->q[list[m]];
+  else if( pack_flag == 5 ) {
+    m = 0;
+    for(int i = 0; i < n; i++) {
+      int j = 2 * list[i];
+      buf[m++] = d[j  ];
+      buf[m++] = d[j+1];
+    }
+  }
 
   return m;
 }
@@ -504,6 +810,14 @@ void FixQEq::unpack_forward_comm(int n, int first, double *buf)
     for(m = 0, i = first; m < n; m++, i++) t[i] = buf[m];
   else if( pack_flag == 4)
     for(m = 0, i = first; m < n; m++, i++) atom->q[i] = buf[m];
+  else if( pack_flag == 5) {
+    int last = first + n;
+    m = 0;
+    for(i = first; i < last; i++) {
+      d[2*i  ] = buf[m++];
+      d[2*i+1] = buf[m++];
+    }
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -511,6 +825,14 @@ void FixQEq::unpack_forward_comm(int n, int first, double *buf)
 int FixQEq::pack_reverse_comm(int n, int first, double *buf)
 {
   int i, m;
+  if (pack_flag == 5) {
+    int last = first + n;
+    for(m = 0, i = first; i < last; i++) {
+      buf[m++] = q[2*i  ];
+      buf[m++] = q[2*i+1];
+    }
+    return m;
+  }
   for(m = 0, i = first; m < n; m++, i++) buf[m] = q[i];
   return m;
 }
@@ -521,6 +843,16 @@ void FixQEq::unpack_reverse_comm(int n, int *list, double *buf)
 {
   int m;
 
+  if (pack_flag == 5) {
+    m = 0;
+    for(int i = 0; i < n; i++) {
+      int j = 2 * list[i];
+      q[j  ] += buf[m++];
+      q[j+1] += buf[m++];
+    }
+    return;
+  }
+
   for(m = 0; m < n; m++) q[list[m]] += buf[m];
 }
 
@@ -538,6 +870,11 @@ double FixQEq::memory_usage()
   bytes += m_cap * sizeof(int);
   bytes += m_cap * sizeof(double);
 
+  if (dual_enabled)
+    bytes += atom->nmax*6 * sizeof(double); // double size for p, q, r, d, y
+  if (pipeline)
+    bytes += atom->nmax*8 * sizeof(double); // u, w, z, and h
+
   return bytes;
 }
 
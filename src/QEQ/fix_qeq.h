@@ -79,6 +79,7 @@ class FixQEq : public Fix {
   double *s, *t;
   double **s_hist, **t_hist;
   int nprev;
+  double *s_extrap, *t_extrap;   // extrapolation weights of s_hist, t_hist
 
   typedef struct{
     int n, m;
@@ -93,6 +94,13 @@ class FixQEq : public Fix {
   double *b_s, *b_t;
   double *p, *q, *r, *d;
 
+  // dual CG storage, interleaved s and t values
+  // y = A p, u and w = A u are separate from d and q only when pipelined
+  // z, h = recurrences for A M w and M y in pipelined CG
+
+  int dual_enabled, pipeline;
+  double *y, *u, *w, *z, *h;
+
   // streitz-mintmire
 
   double alpha;
@@ -105,6 +113,7 @@ class FixQEq : public Fix {
   double *qv;
 
   void calculate_Q();
+  void extrapolation_weights(double *, int);
 
   double parallel_norm(double*, int);
   double parallel_dot(double*, double*, int);
@@ -124,6 +133,10 @@ class FixQEq : public Fix {
 
   virtual int CG(double *, double *);
   virtual void sparse_matvec(sparse_matrix *, double *,double *);
+
+  // dual CG support
+  virtual int dual_CG(double *, double *, double *, double *);
+  virtual void dual_sparse_matvec(sparse_matrix *, double *, double *);
 };
 
 }
@@ -146,6 +159,10 @@ W: Fix qeq CG convergence failed (%g) after %d iterations at %ld step
 
 Self-explanatory.
 
+W: Fix qeq dual CG convergence failed (%g) after %d iterations at %ld step
+
+Self-explanatory.
+
 E: Cannot open fix qeq parameter file %s
 
 The specified file cannot be opened.  Check that the path and name are
@@ -142,8 +142,12 @@ void FixQEqShielded::pre_force(int /*vflag*/)
     reallocate_matrix();
 
   init_matvec();
-  matvecs = CG(b_s, s);         // CG on s - parallel
-  matvecs += CG(b_t, t);        // CG on t - parallel
+  if (dual_enabled) {
+    matvecs = dual_CG(b_s, b_t, s, t);
+  } else {
+    matvecs = CG(b_s, s);       // CG on s - parallel
+    matvecs += CG(b_t, t);      // CG on t - parallel
+  }
   calculate_Q();
 
   if (force->kspace) force->kspace->qsum_qsq();
@@ -155,7 +159,7 @@ void FixQEqShielded::init_matvec()
 {
   compute_H();
 
-  int inum, ii, i;
+  int inum, ii, i, k;
   int *ilist;
 
   inum = list->inum;
@@ -167,8 +171,11 @@ void FixQEqShielded::init_matvec()
       Hdia_inv[i] = 1. / eta[ atom->type[i] ];
       b_s[i]      = -( chi[atom->type[i]] + chizj[i] );
       b_t[i]      = -1.0;
-      t[i] = t_hist[i][2] + 3 * ( t_hist[i][0] - t_hist[i][1] );
-      s[i] = 4*(s_hist[i][0]+s_hist[i][2])-(6*s_hist[i][1]+s_hist[i][3]);
+      s[i] = t[i] = 0.0;
+      for( k = 0; k < nprev; k++ ) {
+        s[i] += s_extrap[k] * s_hist[i][k];
+        t[i] += t_extrap[k] * t_hist[i][k];
+      }
     }
   }
 
@@ -54,6 +54,11 @@ FixQEqSlater::FixQEqSlater(LAMMPS *lmp, int narg, char **arg) :
       if (iarg+2 > narg) error->all(FLERR,"Illegal fix qeq/slater command");
       alpha = atof(arg[iarg+1]);
       iarg += 2;
+    } else if (strcmp(arg[iarg],"dual") == 0 ||
+               strcmp(arg[iarg],"pipeline") == 0) {
+      iarg++;
+    } else if (strcmp(arg[iarg],"nprev") == 0) {
+      iarg += 2;
     } else error->all(FLERR,"Illegal fix qeq/slater command");
   }
 
@@ -120,8 +125,12 @@ void FixQEqSlater::pre_force(int /*vflag*/)
     reallocate_matrix();
 
   init_matvec();
-  matvecs = CG(b_s, s);         // CG on s - parallel
-  matvecs += CG(b_t, t);        // CG on t - parallel
+  if (dual_enabled) {
+    matvecs = dual_CG(b_s, b_t, s, t);
+  } else {
+    matvecs = CG(b_s, s);       // CG on s - parallel
+    matvecs += CG(b_t, t);      // CG on t - parallel
+  }
   calculate_Q();
 
   if (force->kspace) force->kspace->qsum_qsq();
@@ -133,7 +142,7 @@ void FixQEqSlater::init_matvec()
 {
   compute_H();
 
-  int inum, ii, i;
+  int inum, ii, i, k;
   int *ilist;
 
   inum = list->inum;
@@ -145,8 +154,11 @@ void FixQEqSlater::init_matvec()
       Hdia_inv[i] = 1. / eta[ atom->type[i] ];
       b_s[i]      = -( chi[atom->type[i]] + chizj[i] );
       b_t[i]      = -1.0;
-      t[i] = t_hist[i][2] + 3 * ( t_hist[i][0] - t_hist[i][1] );
-      s[i] = 4*(s_hist[i][0]+s_hist[i][2])-(6*s_hist[i][1]+s_hist[i][3]);
+      s[i] = t[i] = 0.0;
+      for( k = 0; k < nprev; k++ ) {
+        s[i] += s_extrap[k] * s_hist[i][k];
+        t[i] += t_extrap[k] * t_hist[i][k];
+      }
     }
   }
 
@@ -377,3 +389,42 @@ void FixQEqSlater::sparse_matvec( sparse_matrix *A, double *x, double *b )
   }
 
 }
+
+/* ---------------------------------------------------------------------- */
+
+void FixQEqSlater::dual_sparse_matvec( sparse_matrix *A, double *x, double *b )
+{
+  int i, j, itr_j;
+
+  nlocal = atom->nlocal;
+  nall = atom->nlocal + atom->nghost;
+
+  double r = cutoff;
+  double woself = 0.50*erfc(alpha*r)/r + alpha/MY_PIS;
+
+  for( i = 0; i < nlocal; ++i ) {
+    if (atom->mask[i] & groupbit) {
+      double diag = eta[atom->type[i]] - 2.0*force->qqr2e*woself;
+      b[2*i  ] = diag * x[2*i  ];
+      b[2*i+1] = diag * x[2*i+1];
+    }
+  }
+
+  for( i = nlocal; i < nall; ++i ) {
+    if (atom->mask[i] & groupbit)
+      b[2*i] = b[2*i+1] = 0;
+  }
+
+  for( i = 0; i < nlocal; ++i ) {
+    if (atom->mask[i] & groupbit) {
+      for( itr_j=A->firstnbr[i]; itr_j<A->firstnbr[i]+A->numnbrs[i]; itr_j++) {
+        j = A->jlist[itr_j];
+        b[2*i  ] += A->val[itr_j] * x[2*j  ];
+        b[2*i+1] += A->val[itr_j] * x[2*j+1];
+        b[2*j  ] += A->val[itr_j] * x[2*i  ];
+        b[2*j+1] += A->val[itr_j] * x[2*i+1];
+      }
+    }
+  }
+
+}
@@ -34,6 +34,7 @@ class FixQEqSlater : public FixQEq {
  private:
   void init_matvec();
   void sparse_matvec(sparse_matrix*,double*,double*);
+  void dual_sparse_matvec(sparse_matrix*,double*,double*);
   void compute_H();
   double calculate_H(double, double, double, double, double &);
   double calculate_H_wolf(double, double, double, double, double &);
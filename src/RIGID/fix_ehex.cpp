@@ -191,7 +191,7 @@ void FixEHEX::init()
     int id_shake;
     for (int i = 0; i < modify->nfix; i++) {
       if (strcmp("rattle", modify->fix[i]->style) == 0 ||
-          strcmp("shake", modify->fix[i]->style) == 0) {
+          strncmp("shake", modify->fix[i]->style, 5) == 0) {
         cnt_shake++;
         id_shake = i;
       }
@@ -43,6 +43,7 @@ using namespace MathConst;
 
 #define BIG 1.0e20
 #define MASSDELTA 0.1
+#define SETTLE_BLOCK 16    // # of SETTLE clusters solved together
 
 /* ---------------------------------------------------------------------- */
 
@@ -161,10 +162,11 @@ FixShake::FixShake(LAMMPS *lmp, int narg, char **arg) :
   // parse optional args
 
   onemols = NULL;
+  settle_flag = 0;
 
   int iarg = next;
   while (iarg < narg) {
-    if (strcmp(arg[next],"mol") == 0) {
+    if (strcmp(arg[iarg],"mol") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal fix shake command");
       int imol = atom->find_molecule(arg[iarg+1]);
       if (imol == -1)
@@ -175,6 +177,12 @@ FixShake::FixShake(LAMMPS *lmp, int narg, char **arg) :
       onemols = &atom->molecules[imol];
       nmol = onemols[0]->nset;
       iarg += 2;
+    } else if (strcmp(arg[iarg],"settle") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix shake command");
+      if (strcmp(arg[iarg+1],"yes") == 0) settle_flag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) settle_flag = 0;
+      else error->all(FLERR,"Illegal fix shake command");
+      iarg += 2;
     } else error->all(FLERR,"Illegal fix shake command");
   }
 
@@ -238,6 +246,7 @@ FixShake::FixShake(LAMMPS *lmp, int narg, char **arg) :
 
   maxlist = 0;
   list = NULL;
+  nlist = nsettle = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -337,7 +346,7 @@ void FixShake::init()
 
   int count = 0;
   for (i = 0; i < modify->nfix; i++)
-    if (strcmp(modify->fix[i]->style,"shake") == 0) count++;
+    if (strncmp(modify->fix[i]->style,"shake",5) == 0) count++;
   if (count > 1) error->all(FLERR,"More than one fix shake");
 
   // cannot use with minimization since SHAKE turns off bonds
@@ -354,7 +363,7 @@ void FixShake::init()
   }
   if (i < modify->nfix) {
     for (int j = i; j < modify->nfix; j++)
-      if (strcmp(modify->fix[j]->style,"shake") == 0)
+      if (strncmp(modify->fix[j]->style,"shake",5) == 0)
         error->all(FLERR,"Shake fix must come before NPT/NPH fix");
   }
 
@@ -568,6 +577,21 @@ void FixShake::pre_neighbor()
           list[nlist++] = i;
       }
     }
+
+  // with SETTLE, move clusters it can handle to the end of list
+  // so they can be solved in blocks separately from the SHAKE clusters
+
+  nsettle = 0;
+  if (settle_flag) {
+    int k = nlist;
+    for (int i = nlist-1; i >= 0; i--)
+      if (settle_check(list[i])) {
+        int tmp = list[i];
+        list[i] = list[--k];
+        list[k] = tmp;
+      }
+    nsettle = nlist - k;
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -592,13 +616,15 @@ void FixShake::post_force(int vflag)
   // loop over clusters to add constraint forces
 
   int m;
-  for (int i = 0; i < nlist; i++) {
+  int nshake_list = nlist - nsettle;
+  for (int i = 0; i < nshake_list; i++) {
     m = list[i];
-    if (shake_flag[m] == 2) shake(m);
-    else if (shake_flag[m] == 3) shake3(m);
-    else if (shake_flag[m] == 4) shake4(m);
-    else shake3angle(m);
+    if (shake_flag[m] == 2) shake(m,virial);
+    else if (shake_flag[m] == 3) shake3(m,virial);
+    else if (shake_flag[m] == 4) shake4(m,virial);
+    else shake3angle(m,virial);
   }
+  if (nsettle) settle(&list[nshake_list],nsettle,virial);
 
   // store vflag for coordinate_constraints_end_of_step()
 
@@ -640,13 +666,15 @@ void FixShake::post_force_respa(int vflag, int ilevel, int iloop)
   // loop over clusters to add constraint forces
 
   int m;
-  for (int i = 0; i < nlist; i++) {
+  int nshake_list = nlist - nsettle;
+  for (int i = 0; i < nshake_list; i++) {
     m = list[i];
-    if (shake_flag[m] == 2) shake(m);
-    else if (shake_flag[m] == 3) shake3(m);
-    else if (shake_flag[m] == 4) shake4(m);
-    else shake3angle(m);
+    if (shake_flag[m] == 2) shake(m,virial);
+    else if (shake_flag[m] == 3) shake3(m,virial);
+    else if (shake_flag[m] == 4) shake4(m,virial);
+    else shake3angle(m,virial);
   }
+  if (nsettle) settle(&list[nshake_list],nsettle,virial);
 
   // store vflag for coordinate_constraints_end_of_step()
   vflag_post_force = vflag;
@@ -1687,7 +1715,7 @@ void FixShake::unconstrained_update_respa(int ilevel)
 
 /* ---------------------------------------------------------------------- */
 
-void FixShake::shake(int m)
+void FixShake::shake(int m, double *vsum)
 {
   int nlist,list[2];
   double v[6];
@@ -1782,13 +1810,13 @@ void FixShake::shake(int m)
     v[4] = lamda*r01[0]*r01[2];
     v[5] = lamda*r01[1]*r01[2];
 
-    v_tally(nlist,list,2.0,v);
+    cluster_v_tally(nlist,list,2.0,v,vsum);
   }
 }
 
 /* ---------------------------------------------------------------------- */
 
-void FixShake::shake3(int m)
+void FixShake::shake3(int m, double *vsum)
 {
   int nlist,list[3];
   double v[6];
@@ -1955,13 +1983,13 @@ void FixShake::shake3(int m)
     v[4] = lamda01*r01[0]*r01[2] + lamda02*r02[0]*r02[2];
     v[5] = lamda01*r01[1]*r01[2] + lamda02*r02[1]*r02[2];
 
-    v_tally(nlist,list,3.0,v);
+    cluster_v_tally(nlist,list,3.0,v,vsum);
   }
 }
 
 /* ---------------------------------------------------------------------- */
 
-void FixShake::shake4(int m)
+void FixShake::shake4(int m, double *vsum)
 {
  int nlist,list[4];
   double v[6];
@@ -2207,13 +2235,13 @@ void FixShake::shake4(int m)
     v[4] = lamda01*r01[0]*r01[2]+lamda02*r02[0]*r02[2]+lamda03*r03[0]*r03[2];
     v[5] = lamda01*r01[1]*r01[2]+lamda02*r02[1]*r02[2]+lamda03*r03[1]*r03[2];
 
-    v_tally(nlist,list,4.0,v);
+    cluster_v_tally(nlist,list,4.0,v,vsum);
   }
 }
 
 /* ---------------------------------------------------------------------- */
 
-void FixShake::shake3angle(int m)
+void FixShake::shake3angle(int m, double *vsum)
 {
   int nlist,list[3];
   double v[6];
@@ -2450,7 +2478,297 @@ void FixShake::shake3angle(int m)
     v[4] = lamda01*r01[0]*r01[2]+lamda02*r02[0]*r02[2]+lamda12*r12[0]*r12[2];
     v[5] = lamda01*r01[1]*r01[2]+lamda02*r02[1]*r02[2]+lamda12*r12[1]*r12[2];
 
-    v_tally(nlist,list,3.0,v);
+    cluster_v_tally(nlist,list,3.0,v,vsum);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   check if angle cluster M is a rigid 3-site molecule SETTLE can solve
+   requires 2 bonds of equal length and equal masses of the 2 outer atoms
+------------------------------------------------------------------------- */
+
+int FixShake::settle_check(int m)
+{
+  if (shake_flag[m] != 1) return 0;
+  if (bond_distance[shake_type[m][0]] != bond_distance[shake_type[m][1]])
+    return 0;
+
+  int i1 = atom->map(shake_atom[m][1]);
+  int i2 = atom->map(shake_atom[m][2]);
+  if (rmass) {
+    if (rmass[i1] != rmass[i2]) return 0;
+  } else if (type[i1] != type[i2] && mass[type[i1]] != mass[type[i2]])
+    return 0;
+
+  return 1;
+}
+
+/* ----------------------------------------------------------------------
+   analytic SETTLE for the N angle clusters in CLIST
+   Miyamoto and Kollman, J Comp Chem, 13, 952 (1992)
+   places the rigid molecule at the unique position that conserves
+     linear and angular momentum of the unconstrained move,
+     which is the converged SHAKE solution
+   clusters are done in blocks of SETTLE_BLOCK:
+     gather relative coords, solve the block with branch-free loops
+     over per-block arrays, then scatter constraint forces and virial
+   a cluster whose unconstrained move is too large for the
+     analytic solution is done by iterative SHAKE instead
+------------------------------------------------------------------------- */
+
+void FixShake::settle(int *clist, int n, double *vsum)
+{
+  int i,k,m,nblock;
+  int nlist,list[3];
+  double v[6],del[3];
+
+  int i0[SETTLE_BLOCK],i1[SETTLE_BLOCK],i2[SETTLE_BLOCK];
+  int ok[SETTLE_BLOCK];
+  double m0[SETTLE_BLOCK],m1[SETTLE_BLOCK];
+  double ra[SETTLE_BLOCK],rb[SETTLE_BLOCK],rc[SETTLE_BLOCK],wh[SETTLE_BLOCK];
+  double b0[3][SETTLE_BLOCK],c0[3][SETTLE_BLOCK];
+  double a1[3][SETTLE_BLOCK],b1[3][SETTLE_BLOCK],c1[3][SETTLE_BLOCK];
+  double da[3][SETTLE_BLOCK],db[3][SETTLE_BLOCK],dc[3][SETTLE_BLOCK];
+
+  double invdtfsq = 1.0/dtfsq;
+
+  for (int ifirst = 0; ifirst < n; ifirst += SETTLE_BLOCK) {
+    nblock = MIN(SETTLE_BLOCK,n-ifirst);
+
+    // gather block
+    // b0,c0 = bond vecs from central atom at current coords, with PBC
+    // a1,b1,c1 = unconstrained coords relative to their center of mass
+    // use Domain::minimum_image_once() for xshake as in shake3angle()
+
+    for (k = 0; k < nblock; k++) {
+      m = clist[ifirst+k];
+      i0[k] = atom->map(shake_atom[m][0]);
+      i1[k] = atom->map(shake_atom[m][1]);
+      i2[k] = atom->map(shake_atom[m][2]);
+
+      if (rmass) {
+        m0[k] = rmass[i0[k]];
+        m1[k] = rmass[i1[k]];
+      } else {
+        m0[k] = mass[type[i0[k]]];
+        m1[k] = mass[type[i1[k]]];
+      }
+
+      const double bond = bond_distance[shake_type[m][0]];
+      const double half12 = 0.5*angle_distance[shake_type[m][2]];
+      const double height = sqrt(bond*bond - half12*half12);
+      wh[k] = m1[k]/(m0[k]+2.0*m1[k]);
+      ra[k] = 2.0*wh[k]*height;
+      rb[k] = height - ra[k];
+      rc[k] = half12;
+
+      for (i = 0; i < 3; i++) del[i] = x[i1[k]][i] - x[i0[k]][i];
+      domain->minimum_image(del);
+      for (i = 0; i < 3; i++) b0[i][k] = del[i];
+      for (i = 0; i < 3; i++) del[i] = x[i2[k]][i] - x[i0[k]][i];
+      domain->minimum_image(del);
+      for (i = 0; i < 3; i++) c0[i][k] = del[i];
+
+      for (i = 0; i < 3; i++) del[i] = xshake[i1[k]][i] - xshake[i0[k]][i];
+      domain->minimum_image_once(del);
+      for (i = 0; i < 3; i++) b1[i][k] = del[i];
+      for (i = 0; i < 3; i++) del[i] = xshake[i2[k]][i] - xshake[i0[k]][i];
+      domain->minimum_image_once(del);
+      for (i = 0; i < 3; i++) c1[i][k] = del[i];
+
+      for (i = 0; i < 3; i++) {
+        a1[i][k] = -wh[k]*(b1[i][k] + c1[i][k]);
+        b1[i][k] += a1[i][k];
+        c1[i][k] += a1[i][k];
+      }
+    }
+
+    // solve block
+    // frame: z normal to current molecule plane, x normal to a1 and z
+    // step 2: tilt canonical molecule so z coords match unconstrained ones
+    // step 3: rotate about z to conserve angular momentum
+    // da,db,dc = displacement from unconstrained to constrained coords
+
+    for (k = 0; k < nblock; k++) {
+      double zx = b0[1][k]*c0[2][k] - b0[2][k]*c0[1][k];
+      double zy = b0[2][k]*c0[0][k] - b0[0][k]*c0[2][k];
+      double zz = b0[0][k]*c0[1][k] - b0[1][k]*c0[0][k];
+      double xx = a1[1][k]*zz - a1[2][k]*zy;
+      double xy = a1[2][k]*zx - a1[0][k]*zz;
+      double xz = a1[0][k]*zy - a1[1][k]*zx;
+      double yx = zy*xz - zz*xy;
+      double yy = zz*xx - zx*xz;
+      double yz = zx*xy - zy*xx;
+
+      double rinv = 1.0/sqrt(xx*xx + xy*xy + xz*xz);
+      xx *= rinv; xy *= rinv; xz *= rinv;
+      rinv = 1.0/sqrt(yx*yx + yy*yy + yz*yz);
+      yx *= rinv; yy *= rinv; yz *= rinv;
+      rinv = 1.0/sqrt(zx*zx + zy*zy + zz*zz);
+      zx *= rinv; zy *= rinv; zz *= rinv;
+
+      const double xb0d = xx*b0[0][k] + xy*b0[1][k] + xz*b0[2][k];
+      const double yb0d = yx*b0[0][k] + yy*b0[1][k] + yz*b0[2][k];
+      const double xc0d = xx*c0[0][k] + xy*c0[1][k] + xz*c0[2][k];
+      const double yc0d = yx*c0[0][k] + yy*c0[1][k] + yz*c0[2][k];
+      const double za1d = zx*a1[0][k] + zy*a1[1][k] + zz*a1[2][k];
+      const double xb1d = xx*b1[0][k] + xy*b1[1][k] + xz*b1[2][k];
+      const double yb1d = yx*b1[0][k] + yy*b1[1][k] + yz*b1[2][k];
+      const double zb1d = zx*b1[0][k] + zy*b1[1][k] + zz*b1[2][k];
+      const double xc1d = xx*c1[0][k] + xy*c1[1][k] + xz*c1[2][k];
+      const double yc1d = yx*c1[0][k] + yy*c1[1][k] + yz*c1[2][k];
+      const double zc1d = zx*c1[0][k] + zy*c1[1][k] + zz*c1[2][k];
+
+      // invalid intermediate values flag the cluster and are reset
+      //   to harmless ones, so the loop has no early exit
+
+      int valid = 1;
+      const double sinphi = za1d/ra[k];
+      double tmp = 1.0 - sinphi*sinphi;
+      if (tmp <= 0.0) { valid = 0; tmp = 1.0; }
+      const double cosphi = sqrt(tmp);
+      const double sinpsi = (zb1d - zc1d) / (2.0*rc[k]*cosphi);
+      tmp = 1.0 - sinpsi*sinpsi;
+      if (tmp <= 0.0) { valid = 0; tmp = 1.0; }
+      const double cospsi = sqrt(tmp);
+
+      const double ya2d = ra[k]*cosphi;
+      const double xb2d = -rc[k]*cospsi;
+      const double t1 = -rb[k]*cosphi;
+      const double t2 = rc[k]*sinpsi*sinphi;
+      const double yb2d = t1 - t2;
+      const double yc2d = t1 + t2;
+
+      const double alpha = xb2d*(xb0d - xc0d) + yb0d*yb2d + yc0d*yc2d;
+      const double beta = xb2d*(yc0d - yb0d) + xb0d*yb2d + xc0d*yc2d;
+      const double gamma = xb0d*yb1d - xb1d*yb0d + xc0d*yc1d - xc1d*yc0d;
+      const double al2be2 = alpha*alpha + beta*beta;
+      tmp = al2be2 - gamma*gamma;
+      if (tmp < 0.0 || al2be2 == 0.0) { valid = 0; tmp = 0.0; }
+      double sinthe = (alpha*gamma - beta*sqrt(tmp)) / (valid ? al2be2 : 1.0);
+      tmp = 1.0 - sinthe*sinthe;
+      if (tmp < 0.0) { valid = 0; tmp = 1.0; sinthe = 0.0; }
+      const double costhe = sqrt(tmp);
+
+      const double xa3d = -ya2d*sinthe;
+      const double ya3d = ya2d*costhe;
+      const double xb3d = xb2d*costhe - yb2d*sinthe;
+      const double yb3d = xb2d*sinthe + yb2d*costhe;
+      const double xc3d = -xb2d*costhe - yc2d*sinthe;
+      const double yc3d = -xb2d*sinthe + yc2d*costhe;
+
+      // z coords are unchanged in the rotated frame,
+      //   so displacements only have x,y components
+
+      const double dxa = xa3d;
+      const double dya = ya3d - (yx*a1[0][k] + yy*a1[1][k] + yz*a1[2][k]);
+      const double dxb = xb3d - xb1d;
+      const double dyb = yb3d - yb1d;
+      const double dxc = xc3d - xc1d;
+      const double dyc = yc3d - yc1d;
+
+      da[0][k] = xx*dxa + yx*dya;
+      da[1][k] = xy*dxa + yy*dya;
+      da[2][k] = xz*dxa + yz*dya;
+      db[0][k] = xx*dxb + yx*dyb;
+      db[1][k] = xy*dxb + yy*dyb;
+      db[2][k] = xz*dxb + yz*dyb;
+      dc[0][k] = xx*dxc + yx*dyc;
+      dc[1][k] = xy*dxc + yy*dyc;
+      dc[2][k] = xz*dxc + yz*dyc;
+      ok[k] = valid;
+    }
+
+    // scatter block
+    // constraint force = mass * displacement / dtfsq
+    // update forces if atom is owned by this processor
+    // virial uses bond vecs from central atom, as for SHAKE
+
+    for (k = 0; k < nblock; k++) {
+      if (!ok[k]) {
+        shake3angle(clist[ifirst+k],vsum);
+        continue;
+      }
+
+      const double fa0 = m0[k]*invdtfsq*da[0][k];
+      const double fa1 = m0[k]*invdtfsq*da[1][k];
+      const double fa2 = m0[k]*invdtfsq*da[2][k];
+      const double fb0 = m1[k]*invdtfsq*db[0][k];
+      const double fb1 = m1[k]*invdtfsq*db[1][k];
+      const double fb2 = m1[k]*invdtfsq*db[2][k];
+      const double fc0 = m1[k]*invdtfsq*dc[0][k];
+      const double fc1 = m1[k]*invdtfsq*dc[1][k];
+      const double fc2 = m1[k]*invdtfsq*dc[2][k];
+
+      if (i0[k] < nlocal) {
+        f[i0[k]][0] += fa0;
+        f[i0[k]][1] += fa1;
+        f[i0[k]][2] += fa2;
+      }
+
+      if (i1[k] < nlocal) {
+        f[i1[k]][0] += fb0;
+        f[i1[k]][1] += fb1;
+        f[i1[k]][2] += fb2;
+      }
+
+      if (i2[k] < nlocal) {
+        f[i2[k]][0] += fc0;
+        f[i2[k]][1] += fc1;
+        f[i2[k]][2] += fc2;
+      }
+
+      if (evflag) {
+        nlist = 0;
+        if (i0[k] < nlocal) list[nlist++] = i0[k];
+        if (i1[k] < nlocal) list[nlist++] = i1[k];
+        if (i2[k] < nlocal) list[nlist++] = i2[k];
+
+        v[0] = b0[0][k]*fb0 + c0[0][k]*fc0;
+        v[1] = b0[1][k]*fb1 + c0[1][k]*fc1;
+        v[2] = b0[2][k]*fb2 + c0[2][k]*fc2;
+        v[3] = 0.5*(b0[0][k]*fb1 + b0[1][k]*fb0 + c0[0][k]*fc1 + c0[1][k]*fc0);
+        v[4] = 0.5*(b0[0][k]*fb2 + b0[2][k]*fb0 + c0[0][k]*fc2 + c0[2][k]*fc0);
+        v[5] = 0.5*(b0[1][k]*fb2 + b0[2][k]*fb1 + c0[1][k]*fc2 + c0[2][k]*fc1);
+
+        cluster_v_tally(nlist,list,3.0,v,vsum);
+      }
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   tally virial of one cluster, same as Fix::v_tally()
+     except global virial is summed into VSUM
+   VSUM = virial, or a per-thread accumulator when clusters are threaded
+   per-atom virial can be summed directly,
+     since each atom belongs to only one cluster
+------------------------------------------------------------------------- */
+
+void FixShake::cluster_v_tally(int n, int *list, double total,
+                               double *v, double *vsum)
+{
+  if (vflag_global) {
+    double fraction = n/total;
+    vsum[0] += fraction*v[0];
+    vsum[1] += fraction*v[1];
+    vsum[2] += fraction*v[2];
+    vsum[3] += fraction*v[3];
+    vsum[4] += fraction*v[4];
+    vsum[5] += fraction*v[5];
+  }
+
+  if (vflag_atom) {
+    double fraction = 1.0/total;
+    for (int i = 0; i < n; i++) {
+      int m = list[i];
+      vatom[m][0] += fraction*v[0];
+      vatom[m][1] += fraction*v[1];
+      vatom[m][2] += fraction*v[2];
+      vatom[m][3] += fraction*v[3];
+      vatom[m][4] += fraction*v[4];
+      vatom[m][5] += fraction*v[5];
+    }
   }
 }
 
@@ -67,6 +67,7 @@ class FixShake : public Fix {
   int max_iter;                          // max # of SHAKE iterations
   int output_every;                      // SHAKE stat output every so often
   bigint next_output;                    // timestep for next output
+  int settle_flag;                       // 1 = SETTLE for rigid 3-site angles
 
                                          // settings from input command
   int *bond_flag,*angle_flag;            // bond/angle types to constrain
@@ -106,6 +107,7 @@ class FixShake : public Fix {
 
   int *list;                            // list of clusters to SHAKE
   int nlist,maxlist;                    // size and max-size of list
+  int nsettle;                          // # of SETTLE clusters at end of list
 
                                         // stat quantities
   int *b_count,*b_count_all;            // counts for each bond type
@@ -128,10 +130,13 @@ class FixShake : public Fix {
   int masscheck(double);
   void unconstrained_update();
   void unconstrained_update_respa(int);
-  void shake(int);
-  void shake3(int);
-  void shake4(int);
-  void shake3angle(int);
+  void shake(int, double *);
+  void shake3(int, double *);
+  void shake4(int, double *);
+  void shake3angle(int, double *);
+  int settle_check(int);
+  void settle(int *, int, double *);
+  void cluster_v_tally(int, int *, double, double *, double *);
   void stats();
   int bondtype_findset(int, tagint, tagint, int);
   int angletype_findset(int, tagint, tagint, int);
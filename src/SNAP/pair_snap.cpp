@@ -89,6 +89,8 @@ PairSNAP::PairSNAP(LAMMPS *lmp) : Pair(lmp)
   i_zarray_i =NULL;
 
   use_shared_arrays = 0;
+  use_adjoint = 0;
+  beta = NULL;
 
 #ifdef TIMING_INFO
   timers[0] = 0;
@@ -118,6 +120,8 @@ PairSNAP::~PairSNAP()
     memory->destroy(coeffelem);
   }
 
+  memory->destroy(beta);
+
   // Need to set this because restart not handled by PairHybrid
 
   if (sna) {
@@ -158,7 +162,9 @@ PairSNAP::~PairSNAP()
 
 void PairSNAP::compute(int eflag, int vflag)
 {
-  if (use_optimized)
+  if (use_adjoint)
+    compute_adjoint(eflag, vflag);
+  else if (use_optimized)
     compute_optimized(eflag, vflag);
   else
     compute_regular(eflag, vflag);
@@ -352,6 +358,173 @@ void PairSNAP::compute_regular(int eflag, int vflag)
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   This version uses the adjoint Yi = sum_k beta_k dBi_k/dUi,
+   computed once per atom, so that the force on each neighbor
+   only requires the contraction dUi/dRj.Yi
+   ---------------------------------------------------------------------- */
+
+void PairSNAP::compute_adjoint(int eflag, int vflag)
+{
+  int i,j,jnum,ninside;
+  double delx,dely,delz,evdwl,rsq;
+  double fij[3];
+  int *jlist,*numneigh,**firstneigh;
+  evdwl = 0.0;
+
+  ev_init(eflag,vflag);
+
+  double **x = atom->x;
+  double **f = atom->f;
+  int *type = atom->type;
+  int nlocal = atom->nlocal;
+  int newton_pair = force->newton_pair;
+  class SNA* snaptr = sna[0];
+
+  numneigh = list->numneigh;
+  firstneigh = list->firstneigh;
+
+  for (int ii = 0; ii < list->inum; ii++) {
+    i = list->ilist[ii];
+
+    const double xtmp = x[i][0];
+    const double ytmp = x[i][1];
+    const double ztmp = x[i][2];
+    const int itype = type[i];
+    const int ielem = map[itype];
+    const double radi = radelem[ielem];
+
+    jlist = firstneigh[i];
+    jnum = numneigh[i];
+
+    // insure rij, inside, wj, and rcutij are of size jnum
+
+    snaptr->grow_rij(jnum);
+
+    // rij[][3] = displacements between atom I and those neighbors
+    // inside = indices of neighbors of I within cutoff
+    // wj = weights for neighbors of I within cutoff
+    // rcutij = cutoffs for neighbors of I within cutoff
+    // note Rij sign convention => dU/dRij = dU/dRj = -dU/dRi
+
+    ninside = 0;
+    for (int jj = 0; jj < jnum; jj++) {
+      j = jlist[jj];
+      j &= NEIGHMASK;
+      delx = x[j][0] - xtmp;
+      dely = x[j][1] - ytmp;
+      delz = x[j][2] - ztmp;
+      rsq = delx*delx + dely*dely + delz*delz;
+      int jtype = type[j];
+      int jelem = map[jtype];
+
+      if (rsq < cutsq[itype][jtype]&&rsq>1e-20) {
+        snaptr->rij[ninside][0] = delx;
+        snaptr->rij[ninside][1] = dely;
+        snaptr->rij[ninside][2] = delz;
+        snaptr->inside[ninside] = j;
+        snaptr->wj[ninside] = wjelem[jelem];
+        snaptr->rcutij[ninside] = (radi + radelem[jelem])*rcutfac;
+        ninside++;
+      }
+    }
+
+    // compute Ui for atom I
+    // Bi is only needed for the energy and the quadratic terms
+
+    snaptr->compute_ui(ninside);
+    if (eflag || quadraticflag) {
+      snaptr->compute_zi();
+      snaptr->compute_bi();
+      snaptr->copy_bi2bvec();
+    }
+
+    // beta = dEi/dBi, linear plus quadratic contributions
+
+    double* coeffi = coeffelem[ielem];
+
+    for (int icoeff = 0; icoeff < ncoeff; icoeff++)
+      beta[icoeff] = coeffi[icoeff+1];
+
+    if (quadraticflag) {
+      int k = ncoeff+1;
+      for (int icoeff = 0; icoeff < ncoeff; icoeff++) {
+        double bveci = snaptr->bvec[icoeff];
+        beta[icoeff] += coeffi[k]*bveci;
+        k++;
+        for (int jcoeff = icoeff+1; jcoeff < ncoeff; jcoeff++) {
+          double bvecj = snaptr->bvec[jcoeff];
+          beta[icoeff] += coeffi[k]*bvecj;
+          beta[jcoeff] += coeffi[k]*bveci;
+          k++;
+        }
+      }
+    }
+
+    // compute adjoint Yi for atom I
+
+    snaptr->compute_yi(beta);
+
+    // for neighbors of I within cutoff:
+    // compute dUi/drj and Fij = dEi/dRj = Conj(dUi/dRj).Yi
+    // Fij = dEi/dRj = -dEi/dRi => add to Fi, subtract from Fj
+
+    for (int jj = 0; jj < ninside; jj++) {
+      int j = snaptr->inside[jj];
+      snaptr->compute_duidrj(snaptr->rij[jj],
+                             snaptr->wj[jj],snaptr->rcutij[jj]);
+
+      snaptr->compute_deidrj(fij);
+
+      f[i][0] += fij[0];
+      f[i][1] += fij[1];
+      f[i][2] += fij[2];
+      f[j][0] -= fij[0];
+      f[j][1] -= fij[1];
+      f[j][2] -= fij[2];
+
+      // tally per-atom virial contribution
+
+      if (vflag)
+        ev_tally_xyz(i,j,nlocal,newton_pair,0.0,0.0,
+                     fij[0],fij[1],fij[2],
+                     -snaptr->rij[jj][0],-snaptr->rij[jj][1],
+                     -snaptr->rij[jj][2]);
+    }
+
+    // tally energy contribution
+
+    if (eflag) {
+
+      // evdwl = energy of atom I, sum over coeffs_k * Bi_k
+      // E = beta.B + 0.5*B^t.alpha.B
+
+      evdwl = coeffi[0];
+
+      // linear contributions
+
+      for (int k = 1; k <= ncoeff; k++)
+        evdwl += coeffi[k]*snaptr->bvec[k-1];
+
+      // quadratic contributions
+
+      if (quadraticflag) {
+        int k = ncoeff+1;
+        for (int icoeff = 0; icoeff < ncoeff; icoeff++) {
+          double bveci = snaptr->bvec[icoeff];
+          evdwl += 0.5*coeffi[k++]*bveci*bveci;
+          for (int jcoeff = icoeff+1; jcoeff < ncoeff; jcoeff++) {
+            evdwl += coeffi[k++]*bveci*snaptr->bvec[jcoeff];
+          }
+        }
+      }
+      ev_tally_full(i,2.0*evdwl,0.0,0.0,0.0,0.0,0.0);
+    }
+
+  }
+
+  if (vflag_fdotr) virial_fdotr_compute();
+}
 
 /* ----------------------------------------------------------------------
    This version is optimized for threading, micro-load balancing
@@ -1323,6 +1496,8 @@ void PairSNAP::settings(int narg, char **arg)
   use_shared_arrays=-1;
   do_load_balance = 0;
   use_optimized = 1;
+  use_adjoint = 0;
+  schedule_user = 0;
 
   // optional arguments
 
@@ -1369,6 +1544,15 @@ void PairSNAP::settings(int narg, char **arg)
       }
       continue;
     }
+    if (strcmp(arg[i],"algorithm")==0) {
+      i++;
+      if (strcmp(arg[i],"regular")==0)
+        use_adjoint = 0;
+      else if (strcmp(arg[i],"adjoint")==0)
+        use_adjoint = 1;
+      else error->all(FLERR,"Illegal pair_style command");
+      continue;
+    }
     if (strcmp(arg[i],"schedule")==0) {
       i++;
       if (strcmp(arg[i],"static")==0)
@@ -1388,6 +1572,22 @@ void PairSNAP::settings(int narg, char **arg)
     error->all(FLERR,"Illegal pair_style command");
   }
 
+  // adjoint algorithm runs on the single SNA engine sna[0]
+  // fall back to regular algorithm if threads only come from OpenMP setup
+
+  if (use_adjoint) {
+    if (nthreads > 1 || use_shared_arrays > 0 || do_load_balance ||
+        schedule_user)
+      error->all(FLERR,"Pair style snap algorithm adjoint cannot be "
+                 "used with threading keywords");
+    if (nthreads < 0 && comm->nthreads > 1) {
+      if (comm->me == 0)
+        error->warning(FLERR,"Pair style snap algorithm adjoint requires "
+                       "1 OpenMP thread, using algorithm regular");
+      use_adjoint = 0;
+    }
+  }
+
   if (nthreads < 0)
     nthreads = comm->nthreads;
 
@@ -1510,6 +1710,9 @@ void PairSNAP::coeff(int narg, char **arg)
       sna[tid]->grow_rij(nmax);
   }
 
+  memory->destroy(beta);
+  memory->create(beta,ncoeff,"pair:beta");
+
   if (ncoeff != sna[0]->ncoeff) {
     if (comm->me == 0)
       printf("ncoeff = %d snancoeff = %d \n",ncoeff,sna[0]->ncoeff);
@@ -1794,6 +1997,7 @@ double PairSNAP::memory_usage()
   bytes += nmax*sizeof(int);
   bytes += (2*ncoeffall)*sizeof(double);
   bytes += (ncoeff*3)*sizeof(double);
+  bytes += ncoeff*sizeof(double);
   bytes += sna[0]->memory_usage()*nthreads;
   return bytes;
 }
@@ -31,6 +31,7 @@ public:
   virtual void compute(int, int);
   void compute_regular(int, int);
   void compute_optimized(int, int);
+  void compute_adjoint(int, int);
   void settings(int, char **);
   virtual void coeff(int, char **);
   virtual void init_style();
@@ -75,6 +76,8 @@ protected:
 
   int use_optimized;
   int use_shared_arrays;
+  int use_adjoint;
+  double *beta;                 // linear coeffs incl. quadratic terms
 
   int i_max;
   int i_neighmax;
@@ -124,6 +127,18 @@ Self-explanatory.  Check the input script syntax and compare to the
 documentation for the command.  You can use -echo screen as a
 command-line option when running LAMMPS to see the offending line.
 
+E: Pair style snap algorithm adjoint cannot be used with threading keywords
+
+The adjoint algorithm uses a single SNA engine per MPI task and
+cannot be combined with the nthreads > 1, shared, loadbalance, or
+schedule keywords.
+
+W: Pair style snap algorithm adjoint requires 1 OpenMP thread, using algorithm regular
+
+More than one OpenMP thread per MPI task is used, e.g. via the
+OMP_NUM_THREADS environment variable, so the regular algorithm is used
+instead.
+
 E: Must set number of threads via package omp command
 
 Because you are using the USER-OMP package, set the number of threads
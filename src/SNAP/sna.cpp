@@ -157,8 +157,7 @@ SNA::SNA(LAMMPS* lmp, double rfac0_in,
 #endif
 
   build_indexlist();
-
-
+  build_adjoint_indexlist();
 }
 
 /* ---------------------------------------------------------------------- */
@@ -175,6 +174,14 @@ SNA::~SNA()
     memory->destroy(dbvec);
   }
   delete[] idxj;
+  delete[] idxz;
+  memory->destroy(idxz_block);
+  memory->destroy(idxzbeta);
+  memory->destroy(zbetafac);
+  memory->destroy(zbeta);
+  memory->destroy(idxy_block);
+  memory->destroy(ylist_r);
+  memory->destroy(ylist_i);
 }
 
 void SNA::build_indexlist()
@@ -279,6 +286,88 @@ void SNA::build_indexlist()
 }
 /* ---------------------------------------------------------------------- */
 
+/* ----------------------------------------------------------------------
+   index lists for the adjoint force evaluation:
+   offsets of the half-symmetric Y(j) blocks, the Z(j1,j2,j) blocks
+   with j1 >= j2, and for each bispectrum coefficient the three
+   Z blocks and weights that enter dB(j1,j2,j)/dRj
+------------------------------------------------------------------------- */
+
+void SNA::build_adjoint_indexlist()
+{
+  int jdim = twojmax + 1;
+
+  memory->create(idxy_block, jdim, "sna:idxy_block");
+
+  idxy_max = 0;
+  for(int j = 0; j <= twojmax; j++) {
+    idxy_block[j] = idxy_max;
+    idxy_max += (j/2 + 1) * (j + 1);
+  }
+
+  memory->create(ylist_r, idxy_max, "sna:ylist");
+  memory->create(ylist_i, idxy_max, "sna:ylist");
+
+  memory->create(idxz_block, jdim, jdim, jdim, "sna:idxz_block");
+
+  int idxz_count = 0;
+
+  for(int j1 = 0; j1 <= twojmax; j1++)
+    for(int j2 = 0; j2 <= twojmax; j2++)
+      for(int j = 0; j <= twojmax; j++)
+        idxz_block[j1][j2][j] = -1;
+
+  for(int j1 = 0; j1 <= twojmax; j1++)
+    for(int j2 = 0; j2 <= j1; j2++)
+      for(int j = j1 - j2; j <= MIN(twojmax, j1 + j2); j += 2)
+        idxz_block[j1][j2][j] = idxz_count++;
+
+  idxz = new SNA_LOOPINDICES[idxz_count];
+  idxz_max = idxz_count;
+
+  for(int j1 = 0; j1 <= twojmax; j1++)
+    for(int j2 = 0; j2 <= j1; j2++)
+      for(int j = j1 - j2; j <= MIN(twojmax, j1 + j2); j += 2) {
+        idxz_count = idxz_block[j1][j2][j];
+        idxz[idxz_count].j1 = j1;
+        idxz[idxz_count].j2 = j2;
+        idxz[idxz_count].j = j;
+      }
+
+  memory->create(zbeta, idxz_max, "sna:zbeta");
+  memory->create(idxzbeta, idxj_max, 3, "sna:idxzbeta");
+  memory->create(zbetafac, idxj_max, 3, "sna:zbetafac");
+
+  // dB(j1,j2,j)/dRj = 2*Conj(dU(j)/dRj)*Z(j1,j2,j)
+  //   + 2*(j+1)/(j1+1)*Conj(dU(j1)/dRj)*Z(j,j2,j1)
+  //   + 2*(j+1)/(j2+1)*Conj(dU(j2)/dRj)*Z(j1,j,j2)
+  // using Z j1/j2 symmetry, see compute_dbidrj()
+
+  for(int JJ = 0; JJ < idxj_max; JJ++) {
+    const int j1 = idxj[JJ].j1;
+    const int j2 = idxj[JJ].j2;
+    const int j = idxj[JJ].j;
+
+    idxzbeta[JJ][0] = idxz_block[MAX(j1, j2)][MIN(j1, j2)][j];
+    zbetafac[JJ][0] = 2.0;
+    idxzbeta[JJ][1] = idxz_block[MAX(j, j2)][MIN(j, j2)][j1];
+    zbetafac[JJ][1] = 2.0*(j+1)/(j1+1.0);
+    idxzbeta[JJ][2] = idxz_block[MAX(j1, j)][MIN(j1, j)][j2];
+    zbetafac[JJ][2] = 2.0*(j+1)/(j2+1.0);
+
+    // j1,j2,j that cannot couple, e.g. odd j1 = j2 = j
+    // for diagonalstyle 2, do not contribute
+
+    for(int l = 0; l < 3; l++)
+      if (idxzbeta[JJ][l] < 0) {
+        idxzbeta[JJ][l] = 0;
+        zbetafac[JJ][l] = 0.0;
+      }
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
 void SNA::init()
 {
   init_clebsch_gordan();
@@ -621,6 +710,142 @@ void SNA::copy_bi2bvec()
     }
 }
 
+/* ----------------------------------------------------------------------
+   compute adjoint Yi = sum_k beta_k dB_k/dU for given linear
+   coefficients beta, so that dEi/dRj = Conj(dU/dRj).Yi
+   only Z blocks with non-zero weight are evaluated, and the
+   half-sum weights of the middle column are folded into Yi
+------------------------------------------------------------------------- */
+
+void SNA::compute_yi(const double* beta)
+{
+  // for each Z(j1,j2,j) block used by the coefficients
+  //   for mb = 0,...,jmid
+  //     for ma = 0,...,j
+  //       y(j,ma,mb) += zbeta(j1,j2,j)*z(j1,j2,j,ma,mb)
+  // see compute_zi() for the z(j1,j2,j,ma,mb) loops
+
+#ifdef TIMING_INFO
+  clock_gettime(CLOCK_REALTIME, &starttime);
+#endif
+
+  for(int jjz = 0; jjz < idxz_max; jjz++)
+    zbeta[jjz] = 0.0;
+
+  for(int JJ = 0; JJ < idxj_max; JJ++)
+    for(int l = 0; l < 3; l++)
+      zbeta[idxzbeta[JJ][l]] += beta[JJ]*zbetafac[JJ][l];
+
+  for(int jjy = 0; jjy < idxy_max; jjy++) {
+    ylist_r[jjy] = 0.0;
+    ylist_i[jjy] = 0.0;
+  }
+
+  for(int jjz = 0; jjz < idxz_max; jjz++) {
+    const double betaz = zbeta[jjz];
+    if (betaz == 0.0) continue;
+
+    const int j1 = idxz[jjz].j1;
+    const int j2 = idxz[jjz].j2;
+    const int j = idxz[jjz].j;
+    double** cgblock = cgarray[j1][j2][j];
+    double* yr = ylist_r + idxy_block[j];
+    double* yi = ylist_i + idxy_block[j];
+
+    for(int mb = 0; 2*mb <= j; mb++) {
+
+      // middle column only needs ma <= mb
+
+      const int mamax = (2*mb == j) ? mb : j;
+
+      for(int ma = 0; ma <= mamax; ma++) {
+        double ztmp_r = 0.0;
+        double ztmp_i = 0.0;
+
+        for(int ma1 = MAX(0, (2 * ma - j - j2 + j1) / 2);
+            ma1 <= MIN(j1, (2 * ma - j + j2 + j1) / 2); ma1++) {
+          double sumb1_r = 0.0;
+          double sumb1_i = 0.0;
+
+          const int ma2 = (2 * ma - j - (2 * ma1 - j1) + j2) / 2;
+          const double* u1_r = uarraytot_r[j1][ma1];
+          const double* u1_i = uarraytot_i[j1][ma1];
+          const double* u2_r = uarraytot_r[j2][ma2];
+          const double* u2_i = uarraytot_i[j2][ma2];
+
+          for(int mb1 = MAX(0, (2 * mb - j - j2 + j1) / 2);
+              mb1 <= MIN(j1, (2 * mb - j + j2 + j1) / 2); mb1++) {
+            const int mb2 = (2 * mb - j - (2 * mb1 - j1) + j2) / 2;
+            const double cg = cgblock[mb1][mb2];
+            sumb1_r += cg * (u1_r[mb1] * u2_r[mb2] - u1_i[mb1] * u2_i[mb2]);
+            sumb1_i += cg * (u1_r[mb1] * u2_i[mb2] + u1_i[mb1] * u2_r[mb2]);
+          } // end loop over mb1
+
+          ztmp_r += sumb1_r * cgblock[ma1][ma2];
+          ztmp_i += sumb1_i * cgblock[ma1][ma2];
+        } // end loop over ma1
+
+        const int jjy = mb * (j + 1) + ma;
+        yr[jjy] += betaz * ztmp_r;
+        yi[jjy] += betaz * ztmp_i;
+      } // end loop over ma
+    } // end loop over mb
+  } // end loop over Z blocks
+
+  // For j even, the middle column diagonal counts half
+
+  for(int j = 0; j <= twojmax; j += 2) {
+    const int jjy = idxy_block[j] + (j/2) * (j + 1) + j/2;
+    ylist_r[jjy] *= 0.5;
+    ylist_i[jjy] *= 0.5;
+  }
+
+#ifdef TIMING_INFO
+  clock_gettime(CLOCK_REALTIME, &endtime);
+  timers[1] += (endtime.tv_sec - starttime.tv_sec + 1.0 *
+                (endtime.tv_nsec - starttime.tv_nsec) / 1000000000);
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   calculate derivative of Ei w.r.t. atom j
+   requires compute_duidrj() and compute_yi()
+------------------------------------------------------------------------- */
+
+void SNA::compute_deidrj(double* dedr)
+{
+  double* dudr_r, *dudr_i;
+
+#ifdef TIMING_INFO
+  clock_gettime(CLOCK_REALTIME, &starttime);
+#endif
+
+  for(int k = 0; k < 3; k++)
+    dedr[k] = 0.0;
+
+  for(int j = 0; j <= twojmax; j++) {
+    const double* yr = ylist_r + idxy_block[j];
+    const double* yi = ylist_i + idxy_block[j];
+
+    for(int mb = 0; 2*mb <= j; mb++) {
+      const int mamax = (2*mb == j) ? mb : j;
+      for(int ma = 0; ma <= mamax; ma++) {
+        const int jjy = mb * (j + 1) + ma;
+        dudr_r = duarray_r[j][ma][mb];
+        dudr_i = duarray_i[j][ma][mb];
+        for(int k = 0; k < 3; k++)
+          dedr[k] += dudr_r[k] * yr[jjy] + dudr_i[k] * yi[jjy];
+      }
+    }
+  }
+
+#ifdef TIMING_INFO
+  clock_gettime(CLOCK_REALTIME, &endtime);
+  timers[4] += (endtime.tv_sec - starttime.tv_sec + 1.0 *
+                (endtime.tv_nsec - starttime.tv_nsec) / 1000000000);
+#endif
+}
+
 /* ----------------------------------------------------------------------
    calculate derivative of Ui w.r.t. atom j
 ------------------------------------------------------------------------- */
@@ -1492,6 +1717,10 @@ double SNA::memory_usage()
   bytes += jdim * jdim * jdim * 3 * sizeof(double);
   bytes += ncoeff * sizeof(double);
   bytes += jdim * jdim * jdim * jdim * jdim * sizeof(complex<double>);
+  bytes += idxy_max * sizeof(complex<double>);
+  bytes += idxz_max * (sizeof(SNA_LOOPINDICES) + sizeof(double));
+  bytes += jdim * jdim * jdim * sizeof(int);
+  bytes += idxj_max * 3 * (sizeof(int) + sizeof(double));
   return bytes;
 }
 
@@ -59,6 +59,11 @@ public:
   double compute_sfac(double, double);
   double compute_dsfac(double, double);
 
+  // functions for adjoint force evaluation
+
+  void compute_yi(const double*);
+  void compute_deidrj(double*);
+
 #ifdef TIMING_INFO
   double* timers;
   timespec starttime, endtime;
@@ -84,12 +89,29 @@ public:
   double***** zarray_r_b, ***** zarray_i_b;
   double*** uarray_r, *** uarray_i;
 
+  // adjoint Y(j,ma,mb) in flattened half-symmetric layout,
+  // block j holds mb = 0,...,j/2 and ma = 0,...,j
+
+  double* ylist_r, * ylist_i;
+  int* idxy_block;
+  int idxy_max;
+
 private:
   double rmin0, rfac0;
 
   //use indexlist instead of loops, constructor generates these
   SNA_LOOPINDICES* idxj;
   int idxj_max;
+
+  // Z(j1,j2,j) blocks with j1 >= j2 needed by the adjoint,
+  // each bispectrum coefficient maps onto three of them
+
+  SNA_LOOPINDICES* idxz;
+  int idxz_max;
+  int*** idxz_block;
+  int** idxzbeta;
+  double** zbetafac;
+  double* zbeta;
   // data for bispectrum coefficients
 
   double***** cgarray;
@@ -105,6 +127,7 @@ private:
   static const double nfac_table[];
   double factorial(int);
 
+  void build_adjoint_indexlist();
   void create_twojmax_arrays();
   void destroy_twojmax_arrays();
   void init_clebsch_gordan();
@@ -57,6 +57,8 @@ public:
 DumpAtomADIOS::DumpAtomADIOS(LAMMPS *lmp, int narg, char **arg)
 : DumpAtom(lmp, narg, arg)
 {
+    async_allow = 0;
+
     internal = new DumpAtomADIOSInternal();
     internal->ad =
         new adios2::ADIOS("adios2_config.xml", world, adios2::DebugON);
@@ -131,6 +131,8 @@ public:
 DumpCustomADIOS::DumpCustomADIOS(LAMMPS *lmp, int narg, char **arg)
 : DumpCustom(lmp, narg, arg)
 {
+    async_allow = 0;
+
     internal = new DumpCustomADIOSInternal();
     internal->ad =
         new adios2::ADIOS("adios2_config.xml", world, adios2::DebugON);
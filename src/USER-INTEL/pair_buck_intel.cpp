@@ -39,6 +39,7 @@ using namespace MathConst;
 PairBuckIntel::PairBuckIntel(LAMMPS *lmp) : PairBuck(lmp)
 {
   suffix_flag |= Suffix::INTEL;
+  fuse_enable = 0;
 }
 
 PairBuckIntel::~PairBuckIntel()
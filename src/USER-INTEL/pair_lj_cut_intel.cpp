@@ -36,6 +36,7 @@ PairLJCutIntel::PairLJCutIntel(LAMMPS *lmp) :
 {
   suffix_flag |= Suffix::INTEL;
   respa_enable = 0;
+  fuse_enable = 0;
   cut_respa = NULL;
 }
 
@@ -273,7 +273,7 @@ void FixFilterCorotate::init()
   // check for fix shake:
   count = 0;
   for (i = 0; i < modify->nfix; i++){
-    if (strcmp(modify->fix[i]->style,"shake") == 0) count++;
+    if (strncmp(modify->fix[i]->style,"shake",5) == 0) count++;
   }
   if (count > 1)
     error->one(FLERR,"Both fix shake and fix filter/corotate detected.");
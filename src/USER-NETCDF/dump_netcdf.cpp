@@ -80,6 +80,8 @@ const int THIS_IS_A_BIGINT   = -4;
 DumpNetCDF::DumpNetCDF(LAMMPS *lmp, int narg, char **arg) :
   DumpCustom(lmp, narg, arg)
 {
+  async_allow = 0;
+
   // arrays for data rearrangement
 
   sort_flag = 1;
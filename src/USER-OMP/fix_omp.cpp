@@ -22,6 +22,8 @@
 #include "force.h"
 #include "neighbor.h"
 #include "neigh_request.h"
+#include "neigh_list.h"
+#include "memory.h"
 #include "universe.h"
 #include "update.h"
 #include "integrate.h"
@@ -62,7 +64,9 @@ static int get_tid()
 FixOMP::FixOMP(LAMMPS *lmp, int narg, char **arg)
   :  Fix(lmp, narg, arg),
      thr(NULL), last_omp_style(NULL), last_pair_hybrid(NULL),
-     _nthr(-1), _neighbor(true), _mixed(false), _reduced(true)
+     _nthr(-1), _neighbor(true), _mixed(false), _reduced(true),
+     _reduce_color(false), _color(false), _ncopy(1), _colormask(NULL),
+     _maxcolor(0), _color_ncalls(-1)
 {
   if (narg < 4) error->all(FLERR,"Illegal package omp command");
 
@@ -101,6 +105,12 @@ FixOMP::FixOMP(LAMMPS *lmp, int narg, char **arg)
       else if (strcmp(arg[iarg+1],"no") == 0) _neighbor = false;
       else error->all(FLERR,"Illegal package omp command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"reduce") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal package omp command");
+      if (strcmp(arg[iarg+1],"full") == 0) _reduce_color = false;
+      else if (strcmp(arg[iarg+1],"color") == 0) _reduce_color = true;
+      else error->all(FLERR,"Illegal package omp command");
+      iarg += 2;
     } else error->all(FLERR,"Illegal package omp command");
   }
 
@@ -133,6 +143,7 @@ FixOMP::FixOMP(LAMMPS *lmp, int narg, char **arg)
 
   thr = new ThrData *[nthreads];
   _nthr = nthreads;
+  _ncopy = nthreads;
 #if defined(_OPENMP)
 #pragma omp parallel default(none) shared(lmp)
 #endif
@@ -151,6 +162,7 @@ FixOMP::~FixOMP()
     delete thr[i];
 
   delete[] thr;
+  memory->destroy(_colormask);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -206,7 +218,7 @@ void FixOMP::init()
       && (strstr(update->integrate_style,"respa/omp") == NULL))
     error->all(FLERR,"Need to use respa/omp for r-RESPA with /omp styles");
 
-  int check_hybrid, kspace_split;
+  int check_hybrid, kspace_split, nomp = 0;
   last_pair_hybrid = NULL;
   last_omp_style = NULL;
   const char *last_omp_name = NULL;
@@ -238,6 +250,7 @@ void FixOMP::init()
       last_force_name = (const char *) #name;                           \
       last_omp_name = force->name ## _style;                            \
       last_omp_style = (void *) force->name;                            \
+      ++nomp;                                                           \
     }                                                                   \
   }
 
@@ -249,6 +262,7 @@ void FixOMP::init()
         last_force_name = (const char *) #name;               \
         last_omp_name = style->keywords[i];                   \
         last_omp_style = style->styles[i];                    \
+        ++nomp;                                               \
       }                                                       \
     }                                                         \
   }
@@ -282,6 +296,30 @@ void FixOMP::init()
 #undef CheckHybridForOMP
   set_neighbor_omp();
 
+  // threads can only share force array copies, if the pair style
+  // is the only /omp style and it writes only to atoms in its
+  // neighbor list rows, which are known after each reneighboring
+
+  _color = false;
+  if (_reduce_color && (nthreads > 1)) {
+    if ((nomp == 1) && (kspace_split == 0) && !last_pair_hybrid
+        && (last_omp_style == (void *) force->pair)
+        && (strstr(update->integrate_style,"respa") == NULL)) {
+      ThrOMP *style = dynamic_cast<ThrOMP *>(force->pair);
+      if (style && style->color_allow) _color = true;
+    }
+    if (!_color && (comm->me == 0))
+      error->warning(FLERR,"Package omp reduce color is not supported "
+                     "by current styles, using full reduction");
+  }
+
+  for (int i=0; i < nthreads; ++i) {
+    thr[i]->_fcopy = i;
+    thr[i]->_fowner = true;
+  }
+  _ncopy = nthreads;
+  _color_ncalls = -1;
+
   // diagnostic output
   if (comm->me == 0) {
     if (last_omp_style) {
@@ -349,6 +387,8 @@ void FixOMP::pre_force(int)
   double *de = atom->de;
   double *drho = atom->drho;
 
+  if (_color && (neighbor->ncalls != _color_ncalls)) color_threads();
+
 #if defined(_OPENMP)
 #pragma omp parallel default(none) shared(f,torque,erforce,de,drho)
 #endif
@@ -361,12 +401,104 @@ void FixOMP::pre_force(int)
   _reduced = false;
 }
 
+/* ----------------------------------------------------------------------
+   assign threads to shared force array copies after reneighboring.
+   each thread works on the same chunk of the pair neighbor list as in
+   ThrOMP::loop_setup_thr() and touches atoms I and their neighbors J.
+   threads whose sets of touched atoms are disjoint get the same color
+   and accumulate into the same copy, so fewer copies need to be
+   cleared and reduced. copy 0 is atom->f itself.
+------------------------------------------------------------------------- */
+
+void FixOMP::color_threads()
+{
+  _color_ncalls = neighbor->ncalls;
+
+  const int nall = atom->nlocal + atom->nghost;
+  const int maxbits = 8*sizeof(int) - 1;
+  NeighList *list = force->pair->list;
+
+  for (int i=0; i < _nthr; ++i) {
+    thr[i]->_fcopy = i;
+    thr[i]->_fowner = true;
+  }
+  _ncopy = _nthr;
+  if (!list) return;
+
+  if (nall > _maxcolor) {
+    memory->destroy(_colormask);
+    _maxcolor = atom->nmax;
+    memory->create(_colormask,_maxcolor,"fix_omp:colormask");
+  }
+  memset(_colormask,0,nall*sizeof(int));
+
+  const int inum = list->inum;
+  const int * const ilist = list->ilist;
+  const int * const numneigh = list->numneigh;
+  int ** const firstneigh = list->firstneigh;
+  const int idelta = 1 + inum/_nthr;
+
+  int ncolor = 0;
+  int owner[8*sizeof(int)];
+
+  for (int tid = 0; tid < _nthr; ++tid) {
+    const int ifrom = tid*idelta;
+    const int ito = ((ifrom + idelta) > inum) ? inum : ifrom + idelta;
+
+    // collect colors of all threads that touch the same atoms
+
+    int used = 0;
+    for (int ii = ifrom; ii < ito; ++ii) {
+      const int i = ilist[ii];
+      used |= _colormask[i];
+      const int * const jlist = firstneigh[i];
+      const int jnum = numneigh[i];
+      for (int jj = 0; jj < jnum; ++jj)
+        used |= _colormask[jlist[jj] & NEIGHMASK];
+    }
+
+    int c;
+    for (c = 0; c < ncolor; ++c)
+      if (!(used & (1 << c))) break;
+
+    // out of colors: give up and use one copy per thread
+
+    if (c >= maxbits) {
+      for (int i=0; i < _nthr; ++i) {
+        thr[i]->_fcopy = i;
+        thr[i]->_fowner = true;
+      }
+      _ncopy = _nthr;
+      return;
+    }
+
+    if (c == ncolor) {
+      owner[c] = tid;
+      ++ncolor;
+    }
+    thr[tid]->_fcopy = c;
+    thr[tid]->_fowner = (owner[c] == tid);
+
+    const int bit = 1 << c;
+    for (int ii = ifrom; ii < ito; ++ii) {
+      const int i = ilist[ii];
+      _colormask[i] |= bit;
+      const int * const jlist = firstneigh[i];
+      const int jnum = numneigh[i];
+      for (int jj = 0; jj < jnum; ++jj)
+        _colormask[jlist[jj] & NEIGHMASK] |= bit;
+    }
+  }
+  _ncopy = ncolor;
+}
+
 /* ---------------------------------------------------------------------- */
 
 double FixOMP::memory_usage()
 {
   double bytes = _nthr * (sizeof(ThrData *) + sizeof(ThrData));
   bytes += _nthr * thr[0]->memory_usage();
+  bytes += _maxcolor * sizeof(int);
 
   return bytes;
 }
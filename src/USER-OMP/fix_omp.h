@@ -64,17 +64,40 @@ class FixOMP : public Fix {
   bool get_neighbor() const { return _neighbor; }
   bool get_mixed()    const { return _mixed;    }
   bool get_reduced()  const { return _reduced;  }
+  int  get_ncopy()    const { return _ncopy;    }
 
  private:
   int  _nthr;       // number of currently active ThrData objects
   bool _neighbor;   // en/disable threads for neighbor list construction
   bool _mixed;      // whether to prefer mixed precision compute kernels
   bool _reduced;    // whether forces have been reduced for this step
+  bool _reduce_color; // whether threads may share force array copies
+  bool _color;      // whether shared force array copies are active
+  int  _ncopy;      // number of force array copies in use
+  int *_colormask;  // per atom bitmask of colors touching the atom
+  int  _maxcolor;   // allocated length of _colormask
+  bigint _color_ncalls; // neighbor list build of current coloring
 
   void set_neighbor_omp();
+  void color_threads();
 };
 
 }
 
 #endif
 #endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal package omp command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.
+
+W: Package omp reduce color is not supported by current styles, using full reduction
+
+Shared force copies require that the only /omp force style is a
+non-hybrid pair style which supports them, and that neither run_style
+respa/omp nor verlet/split is used.
+
+*/
@@ -67,7 +67,7 @@ using namespace FixConst;
 FixQEqReaxOMP::FixQEqReaxOMP(LAMMPS *lmp, int narg, char **arg) :
   FixQEqReax(lmp, narg, arg)
 {
-  if (narg<8 || narg>9) error->all(FLERR,"Illegal fix qeq/reax/omp command");
+  if (narg < 8) error->all(FLERR,"Illegal fix qeq/reax/omp command");
 
   b_temp = NULL;
 
@@ -310,7 +310,9 @@ void FixQEqReaxOMP::pre_force(int /* vflag */)
   startTimeBase = endTimeBase;
 #endif
 
-  if (dual_enabled) {
+  if (pipeline) {
+    matvecs = FixQEqReax::dual_CG(b_s, b_t, s, t);
+  } else if (dual_enabled) {
     matvecs = dual_CG(b_s, b_t, s, t); // OMP_TIMING inside dual_CG
   } else {
     matvecs_s = CG(b_s, s);     // CG on s - parallel
@@ -424,17 +426,15 @@ void FixQEqReaxOMP::init_matvec()
         b_s[i]      = -chi[ atom->type[i] ];
         b_t[i]      = -1.0;
 
-        /* linear extrapolation for s & t from previous solutions */
-        //s[i] = 2 * s_hist[i][0] - s_hist[i][1];
-        //t[i] = 2 * t_hist[i][0] - t_hist[i][1];
-
-        /* quadratic extrapolation for s & t from previous solutions */
-        //s[i] = s_hist[i][2] + 3 * ( s_hist[i][0] - s_hist[i][1] );
-        t[i] = t_hist[i][2] + 3 * ( t_hist[i][0] - t_hist[i][1] );
-
-        /* cubic extrapolation for s & t from previous solutions */
-        s[i] = 4*(s_hist[i][0]+s_hist[i][2])-(6*s_hist[i][1]+s_hist[i][3]);
-        //t[i] = 4*(t_hist[i][0]+t_hist[i][2])-(6*t_hist[i][1]+t_hist[i][3]);
+        /* polynomial extrapolation for s & t from previous solutions */
+        double sp = 0.0;
+        double tp = 0.0;
+        for (int k = 0; k < nprev; k++) {
+          sp += s_extrap[k] * s_hist[i][k];
+          tp += t_extrap[k] * t_hist[i][k];
+        }
+        s[i] = sp;
+        t[i] = tp;
       }
     }
   }
@@ -0,0 +1,233 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include <cstring>
+#include "fix_shake_omp.h"
+#include "atom.h"
+#include "comm.h"
+#include "update.h"
+#include "memory.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+using namespace LAMMPS_NS;
+using namespace FixConst;
+
+#define SETTLE_CHUNK 64     // # of SETTLE clusters per thread work item
+
+typedef struct { double x,y,z; } dbl3_t;
+
+/* ---------------------------------------------------------------------- */
+
+FixShakeOMP::FixShakeOMP(LAMMPS *lmp, int narg, char **arg) :
+  FixShake(lmp, narg, arg), sortlist(NULL), maxsort(0) { }
+
+/* ---------------------------------------------------------------------- */
+
+FixShakeOMP::~FixShakeOMP()
+{
+  memory->destroy(sortlist);
+}
+
+/* ----------------------------------------------------------------------
+   build list of SHAKE clusters as in FixShake, then order the clusters
+     solved by SHAKE by cluster size, so each thread works on long runs
+     of the same kind of cluster
+   SETTLE clusters stay at the end of list
+------------------------------------------------------------------------- */
+
+void FixShakeOMP::pre_neighbor()
+{
+  FixShake::pre_neighbor();
+
+  if (maxlist > maxsort) {
+    maxsort = maxlist;
+    memory->destroy(sortlist);
+    memory->create(sortlist,maxsort,"shake/omp:sortlist");
+  }
+
+  // counting sort on shake_flag = 1 to 4
+
+  const int nshake_list = nlist - nsettle;
+  int i,k,first[5];
+  for (k = 0; k < 5; k++) first[k] = 0;
+  for (i = 0; i < nshake_list; i++) first[shake_flag[list[i]]]++;
+
+  int n = 0;
+  for (k = 1; k < 5; k++) {
+    const int count = first[k];
+    first[k] = n;
+    n += count;
+  }
+
+  for (i = 0; i < nshake_list; i++)
+    sortlist[first[shake_flag[list[i]]]++] = list[i];
+  if (nshake_list) memcpy(list,sortlist,nshake_list*sizeof(int));
+}
+
+/* ----------------------------------------------------------------------
+   compute the force adjustment for SHAKE constraint
+------------------------------------------------------------------------- */
+
+void FixShakeOMP::post_force(int vflag)
+{
+  if (update->ntimestep == next_output) stats();
+
+  // xshake = unconstrained move with current v,f
+  // communicate results if necessary
+
+  unconstrained_update_thr();
+  if (nprocs > 1) comm->forward_comm_fix(this);
+
+  // virial setup
+
+  if (vflag) v_setup(vflag);
+  else evflag = 0;
+
+  // add constraint forces of all clusters
+
+  solve_clusters_thr();
+
+  // store vflag for coordinate_constraints_end_of_step()
+
+  vflag_post_force = vflag;
+}
+
+/* ----------------------------------------------------------------------
+   enforce SHAKE constraints from rRESPA
+   xshake prediction portion is different than Verlet
+------------------------------------------------------------------------- */
+
+void FixShakeOMP::post_force_respa(int vflag, int ilevel, int iloop)
+{
+  // call stats only on outermost level
+
+  if (ilevel == nlevels_respa-1 && update->ntimestep == next_output) stats();
+
+  // xshake = unconstrained move with current v,f as function of level
+  // communicate results if necessary
+
+  unconstrained_update_respa(ilevel);
+  if (nprocs > 1) comm->forward_comm_fix(this);
+
+  // virial setup only needed on last iteration of innermost level
+  //   and if pressure is requested
+  // virial accumulation happens via evflag at last iteration of each level
+
+  if (ilevel == 0 && iloop == loop_respa[ilevel]-1 && vflag) v_setup(vflag);
+  if (iloop == loop_respa[ilevel]-1) evflag = 1;
+  else evflag = 0;
+
+  // add constraint forces of all clusters
+
+  solve_clusters_thr();
+
+  // store vflag for coordinate_constraints_end_of_step()
+
+  vflag_post_force = vflag;
+}
+
+/* ----------------------------------------------------------------------
+   xshake = unconstrained move with current v,f, threaded over atoms
+------------------------------------------------------------------------- */
+
+void FixShakeOMP::unconstrained_update_thr()
+{
+  const dbl3_t * _noalias xx = (dbl3_t *) x[0];
+  const dbl3_t * _noalias vv = (dbl3_t *) v[0];
+  const dbl3_t * _noalias ff = (dbl3_t *) f[0];
+  dbl3_t * _noalias xs = (dbl3_t *) xshake[0];
+  int i;
+
+#if defined(_OPENMP)
+#pragma omp parallel for default(none) private(i) shared(xx,vv,ff,xs) schedule(static)
+#endif
+  for (i = 0; i < nlocal; i++) {
+    if (shake_flag[i]) {
+      const double dtfmsq = rmass ? dtfsq/rmass[i] : dtfsq/mass[type[i]];
+      xs[i].x = xx[i].x + dtv*vv[i].x + dtfmsq*ff[i].x;
+      xs[i].y = xx[i].y + dtv*vv[i].y + dtfmsq*ff[i].y;
+      xs[i].z = xx[i].z + dtv*vv[i].z + dtfmsq*ff[i].z;
+    } else xs[i].z = xs[i].y = xs[i].x = 0.0;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   add constraint forces of all clusters, threaded over clusters
+   clusters share no atoms, so forces and per-atom virial are
+     updated without conflicts
+   global virial is summed per thread and reduced at the end
+   SETTLE clusters are handed out in chunks of SETTLE_CHUNK,
+     which FixShake::settle() solves in SIMD-friendly blocks
+------------------------------------------------------------------------- */
+
+void FixShakeOMP::solve_clusters_thr()
+{
+  int nshake_list = nlist - nsettle;
+  int nchunk = (nsettle + SETTLE_CHUNK - 1) / SETTLE_CHUNK;
+  double v0=0.0,v1=0.0,v2=0.0,v3=0.0,v4=0.0,v5=0.0;
+
+#if defined(_OPENMP)
+#pragma omp parallel default(none) shared(nshake_list,nchunk) reduction(+:v0,v1,v2,v3,v4,v5)
+#endif
+  {
+    double vthr[6] = {0.0,0.0,0.0,0.0,0.0,0.0};
+    int i,m;
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (i = 0; i < nshake_list; i++) {
+      m = list[i];
+      if (shake_flag[m] == 2) shake(m,vthr);
+      else if (shake_flag[m] == 3) shake3(m,vthr);
+      else if (shake_flag[m] == 4) shake4(m,vthr);
+      else shake3angle(m,vthr);
+    }
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (i = 0; i < nchunk; i++) {
+      const int ifirst = nshake_list + i*SETTLE_CHUNK;
+      settle(&list[ifirst],MIN(SETTLE_CHUNK,nlist-ifirst),vthr);
+    }
+
+    v0 += vthr[0];
+    v1 += vthr[1];
+    v2 += vthr[2];
+    v3 += vthr[3];
+    v4 += vthr[4];
+    v5 += vthr[5];
+  }
+
+  if (evflag && vflag_global) {
+    virial[0] += v0;
+    virial[1] += v1;
+    virial[2] += v2;
+    virial[3] += v3;
+    virial[4] += v4;
+    virial[5] += v5;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+double FixShakeOMP::memory_usage()
+{
+  double bytes = FixShake::memory_usage();
+  bytes += maxsort * sizeof(int);
+  return bytes;
+}
@@ -0,0 +1,47 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef FIX_CLASS
+
+FixStyle(shake/omp,FixShakeOMP)
+
+#else
+
+#ifndef LMP_FIX_SHAKE_OMP_H
+#define LMP_FIX_SHAKE_OMP_H
+
+#include "fix_shake.h"
+
+namespace LAMMPS_NS {
+
+class FixShakeOMP : public FixShake {
+ public:
+  FixShakeOMP(class LAMMPS *, int, char **);
+  virtual ~FixShakeOMP();
+  virtual void pre_neighbor();
+  virtual void post_force(int);
+  virtual void post_force_respa(int, int, int);
+  virtual double memory_usage();
+
+ private:
+  int *sortlist;                        // scratch list for ordering clusters
+  int maxsort;
+
+  void unconstrained_update_thr();
+  void solve_clusters_thr();
+};
+
+}
+
+#endif
+#endif
@@ -38,6 +38,7 @@ PairBuckCoulLongOMP::PairBuckCoulLongOMP(LAMMPS *lmp) :
 {
   suffix_flag |= Suffix::OMP;
   respa_enable = 0;
+  color_allow = 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -30,6 +30,7 @@ PairBuckOMP::PairBuckOMP(LAMMPS *lmp) :
 {
   suffix_flag |= Suffix::OMP;
   respa_enable = 0;
+  color_allow = 1;
 }
 
 /* ---------------------------------------------------------------------- */
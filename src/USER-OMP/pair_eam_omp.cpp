@@ -33,6 +33,7 @@ PairEAMOMP::PairEAMOMP(LAMMPS *lmp) :
 {
   suffix_flag |= Suffix::OMP;
   respa_enable = 0;
+  color_allow = 1;
 }
 
 /* ---------------------------------------------------------------------- */
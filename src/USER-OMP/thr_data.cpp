@@ -29,7 +29,7 @@ using namespace LAMMPS_NS;
 /* ---------------------------------------------------------------------- */
 
 ThrData::ThrData(int tid, Timer *t)
-  : _f(0),_torque(0),_erforce(0),_de(0),_drho(0),_mu(0),_lambda(0),_rhoB(0),
+  : _f(0),_fcopy(tid),_fowner(true),_torque(0),_erforce(0),_de(0),_drho(0),_mu(0),_lambda(0),_rhoB(0),
     _D_values(0),_rho(0),_fp(0),_rho1d(0),_drho1d(0),_rho1d_6(0),_drho1d_6(0),
     _tid(tid), _timer(t)
 {
@@ -85,9 +85,11 @@ void ThrData::init_force(int nall, double **f, double **torque,
   eatom_pair=eatom_bond=eatom_angle=eatom_dihed=eatom_imprp=eatom_kspce=NULL;
   vatom_pair=vatom_bond=vatom_angle=vatom_dihed=vatom_imprp=vatom_kspce=NULL;
 
+  // threads may share a copy of the force array, its owner clears it
+
   if (nall >= 0 && f) {
-    _f = f + _tid*nall;
-    memset(&(_f[0][0]),0,nall*3*sizeof(double));
+    _f = f + _fcopy*nall;
+    if (_fowner) memset(&(_f[0][0]),0,nall*3*sizeof(double));
   } else _f = NULL;
 
   if (nall >= 0 && torque) {
@@ -293,11 +295,15 @@ double ThrData::memory_usage()
 // x1,y1,z1,x2,y2,z2,...
 // we need to post a barrier to wait until all threads are done
 // with writing to the array .
-void LAMMPS_NS::data_reduce_thr(double *dall, int nall, int nthreads, int ndim, int tid)
+// if ncopy > 0, only the first ncopy copies hold data, but all
+// nthreads threads share the work of reducing them.
+void LAMMPS_NS::data_reduce_thr(double *dall, int nall, int nthreads, int ndim,
+                                int tid, int ncopy)
 {
 #if defined(_OPENMP)
   // NOOP in single-threaded execution.
   if (nthreads == 1) return;
+  if (ncopy < 0) ncopy = nthreads;
 #pragma omp barrier
   {
     const int nvals = ndim*nall;
@@ -310,7 +316,7 @@ void LAMMPS_NS::data_reduce_thr(double *dall, int nall, int nthreads, int ndim,
       int m = 0;
 
       for (m = ifrom; m < ito; ++m) {
-        for (int n = 1; n < nthreads; ++n) {
+        for (int n = 1; n < ncopy; ++n) {
           dall[m] += dall[n*nvals + m];
           dall[n*nvals + m] = 0.0;
         }
@@ -335,7 +341,7 @@ void LAMMPS_NS::data_reduce_thr(double *dall, int nall, int nthreads, int ndim,
         t5 = dall[m+5];
         t6 = dall[m+6];
         t7 = dall[m+7];
-        for (int n = 1; n < nthreads; ++n) {
+        for (int n = 1; n < ncopy; ++n) {
           t0 += dall[n*nvals + m  ];
           t1 += dall[n*nvals + m+1];
           t2 += dall[n*nvals + m+2];
@@ -364,7 +370,7 @@ void LAMMPS_NS::data_reduce_thr(double *dall, int nall, int nthreads, int ndim,
       }
       // do the last < 8 values
       for (; m < ito; m++) {
-        for (int n = 1; n < nthreads; ++n) {
+        for (int n = 1; n < ncopy; ++n) {
           dall[m] += dall[n*nvals + m];
           dall[n*nvals + m] = 0.0;
         }
@@ -106,6 +106,8 @@ class ThrData {
 
   // these are maintained by atom styles
   double **_f;
+  int _fcopy;                // copy of the force array that _f points to
+  bool _fowner;              // true if this thread clears _f and owns fdotr
   double **_torque;
   double *_erforce;
   double *_de;
@@ -147,6 +149,7 @@ class ThrData {
 //  helper functions operating on data replicated for thread support  //
 ////////////////////////////////////////////////////////////////////////
 // generic per thread data reduction for continous arrays of nthreads*nmax size
-void data_reduce_thr(double *, int, int, int, int);
+// optionally only the first ncopy of the nthreads copies are in use
+void data_reduce_thr(double *, int, int, int, int, int ncopy=-1);
 }
 #endif
@@ -45,7 +45,7 @@ using namespace MathConst;
 /* ---------------------------------------------------------------------- */
 
 ThrOMP::ThrOMP(LAMMPS *ptr, int style)
-  : lmp(ptr), fix(NULL), thr_style(style), thr_error(0)
+  : lmp(ptr), fix(NULL), thr_style(style), thr_error(0), color_allow(0)
 {
   // register fix omp with this class
   int ifix = lmp->modify->find_fix("package_omp");
@@ -174,16 +174,20 @@ void ThrOMP::reduce_thr(void *style, const int eflag, const int vflag,
     if (lmp->force->pair->vflag_fdotr) {
 
       // this is a non-hybrid pair style. compute per thread fdotr
+      // only once for each copy of the force array
       if (fix->last_pair_hybrid == NULL) {
-        if (lmp->neighbor->includegroup == 0)
-          thr->virial_fdotr_compute(x, nlocal, nghost, -1);
-        else
-          thr->virial_fdotr_compute(x, nlocal, nghost, nfirst);
+        if (thr->_fowner) {
+          if (lmp->neighbor->includegroup == 0)
+            thr->virial_fdotr_compute(x, nlocal, nghost, -1);
+          else
+            thr->virial_fdotr_compute(x, nlocal, nghost, nfirst);
+        }
       } else {
         if (style == fix->last_pair_hybrid) {
           // pair_style hybrid will compute fdotr for us
           // but we first need to reduce the forces
-          data_reduce_thr(&(f[0][0]), nall, nthreads, 3, tid);
+          data_reduce_thr(&(f[0][0]), nall, nthreads, 3, tid,
+                          fix->get_ncopy());
           fix->did_reduce();
           need_force_reduce = 0;
         }
@@ -398,7 +402,7 @@ void ThrOMP::reduce_thr(void *style, const int eflag, const int vflag,
 
   if (style == fix->last_omp_style) {
     if (need_force_reduce) {
-      data_reduce_thr(&(f[0][0]), nall, nthreads, 3, tid);
+      data_reduce_thr(&(f[0][0]), nall, nthreads, 3, tid, fix->get_ncopy());
       fix->did_reduce();
     }
 
@@ -43,6 +43,10 @@ class ThrOMP {
   const int thr_style;
   int thr_error;
 
+ public:
+  int color_allow;  // 1 if style only adds forces to atom I and
+                    // its neighbors, so threads can share force copies
+
  public:
   ThrOMP(LAMMPS *, int);
   virtual ~ThrOMP();
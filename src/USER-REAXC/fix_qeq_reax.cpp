@@ -68,7 +68,7 @@ FixQEqReax::FixQEqReax(LAMMPS *lmp, int narg, char **arg) :
 {
   if (lmp->citeme) lmp->citeme->add(cite_fix_qeq_reax);
 
-  if (narg<8 || narg>9) error->all(FLERR,"Illegal fix qeq/reax command");
+  if (narg < 8) error->all(FLERR,"Illegal fix qeq/reax command");
 
   nevery = force->inumeric(FLERR,arg[3]);
   if (nevery <= 0) error->all(FLERR,"Illegal fix qeq/reax command");
@@ -80,13 +80,30 @@ FixQEqReax::FixQEqReax(LAMMPS *lmp, int narg, char **arg) :
   pertype_option = new char[len];
   strcpy(pertype_option,arg[7]);
 
-  // dual CG support only available for USER-OMP variant
-  // check for compatibility is in Fix::post_constructor()
+  // optional args
+  // dual = solve for s and t together, pipeline = dual with overlapped comm
+  // nprev = # of previous solutions used to extrapolate the initial guess
+
   dual_enabled = 0;
-  if (narg == 9) {
-    if (strcmp(arg[8],"dual") == 0) dual_enabled = 1;
-    else error->all(FLERR,"Illegal fix qeq/reax command");
+  pipeline = 0;
+  nprev = 4;
+
+  int iarg = 8;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"dual") == 0) {
+      dual_enabled = 1;
+      iarg++;
+    } else if (strcmp(arg[iarg],"pipeline") == 0) {
+      dual_enabled = pipeline = 1;
+      iarg++;
+    } else if (strcmp(arg[iarg],"nprev") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix qeq/reax command");
+      nprev = force->inumeric(FLERR,arg[iarg+1]);
+      if (nprev < 2) error->all(FLERR,"Illegal fix qeq/reax command");
+      iarg += 2;
+    } else error->all(FLERR,"Illegal fix qeq/reax command");
   }
+
   shld = NULL;
 
   n = n_cap = 0;
@@ -95,7 +112,6 @@ FixQEqReax::FixQEqReax(LAMMPS *lmp, int narg, char **arg) :
   pack_flag = 0;
   s = NULL;
   t = NULL;
-  nprev = 4;
 
   Hdia_inv = NULL;
   b_s = NULL;
@@ -108,6 +124,7 @@ FixQEqReax::FixQEqReax(LAMMPS *lmp, int narg, char **arg) :
   q = NULL;
   r = NULL;
   d = NULL;
+  y = u = w = z = h = NULL;
 
   // H matrix
   H.firstnbr = NULL;
@@ -132,6 +149,16 @@ FixQEqReax::FixQEqReax(LAMMPS *lmp, int narg, char **arg) :
   for (int i = 0; i < atom->nmax; i++)
     for (int j = 0; j < nprev; ++j)
       s_hist[i][j] = t_hist[i][j] = 0;
+
+  // polynomial extrapolation through the last nprev values of s
+  // and the last nprev-1 values of t, weights are (-1)^(k+1) C(n,k)
+  // nprev = 4 is the cubic (s) and quadratic (t) extrapolation
+
+  memory->create(s_extrap,nprev,"qeq:s_extrap");
+  memory->create(t_extrap,nprev,"qeq:t_extrap");
+  extrapolation_weights(s_extrap,nprev);
+  extrapolation_weights(t_extrap,nprev-1);
+  t_extrap[nprev-1] = 0.0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -148,6 +175,8 @@ FixQEqReax::~FixQEqReax()
 
   memory->destroy(s_hist);
   memory->destroy(t_hist);
+  memory->destroy(s_extrap);
+  memory->destroy(t_extrap);
 
   deallocate_storage();
   deallocate_matrix();
@@ -166,8 +195,6 @@ FixQEqReax::~FixQEqReax()
 void FixQEqReax::post_constructor()
 {
   pertype_parameters(pertype_option);
-  if (dual_enabled)
-    error->all(FLERR,"Dual keyword only supported with fix qeq/reax/omp");
 }
 
 /* ---------------------------------------------------------------------- */
@@ -255,6 +282,14 @@ void FixQEqReax::allocate_storage()
   memory->create(q,size,"qeq:q");
   memory->create(r,size,"qeq:r");
   memory->create(d,size,"qeq:d");
+
+  if (dual_enabled) memory->create(y,size,"qeq:y");
+  if (pipeline) {
+    memory->create(u,size,"qeq:u");
+    memory->create(w,size,"qeq:w");
+    memory->create(z,size,"qeq:z");
+    memory->create(h,size,"qeq:h");
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -274,6 +309,12 @@ void FixQEqReax::deallocate_storage()
   memory->destroy( q );
   memory->destroy( r );
   memory->destroy( d );
+
+  memory->destroy( y );
+  memory->destroy( u );
+  memory->destroy( w );
+  memory->destroy( z );
+  memory->destroy( h );
 }
 
 /* ---------------------------------------------------------------------- */
@@ -502,9 +543,13 @@ void FixQEqReax::pre_force(int /*vflag*/)
 
   init_matvec();
 
-  matvecs_s = CG(b_s, s);       // CG on s - parallel
-  matvecs_t = CG(b_t, t);       // CG on t - parallel
-  matvecs = matvecs_s + matvecs_t;
+  if (dual_enabled) {
+    matvecs = dual_CG(b_s, b_t, s, t);
+  } else {
+    matvecs_s = CG(b_s, s);     // CG on s - parallel
+    matvecs_t = CG(b_t, t);     // CG on t - parallel
+    matvecs = matvecs_s + matvecs_t;
+  }
 
   calculate_Q();
 
@@ -535,7 +580,7 @@ void FixQEqReax::init_matvec()
   /* fill-in H matrix */
   compute_H();
 
-  int nn, ii, i;
+  int nn, ii, i, k;
   int *ilist;
 
   if (reaxc) {
@@ -555,11 +600,12 @@ void FixQEqReax::init_matvec()
       b_s[i]      = -chi[ atom->type[i] ];
       b_t[i]      = -1.0;
 
-      /* quadratic extrapolation for s & t from previous solutions */
-      t[i] = t_hist[i][2] + 3 * ( t_hist[i][0] - t_hist[i][1]);
-
-      /* cubic extrapolation for s & t from previous solutions */
-      s[i] = 4*(s_hist[i][0]+s_hist[i][2])-(6*s_hist[i][1]+s_hist[i][3]);
+      /* polynomial extrapolation for s & t from previous solutions */
+      s[i] = t[i] = 0.0;
+      for (k = 0; k < nprev; k++) {
+        s[i] += s_extrap[k] * s_hist[i][k];
+        t[i] += t_extrap[k] * t_hist[i][k];
+      }
     }
   }
 
@@ -569,6 +615,20 @@ void FixQEqReax::init_matvec()
   comm->forward_comm_fix(this); //Dist_vector( t );
 }
 
+/* ----------------------------------------------------------------------
+   weights of a polynomial extrapolation through the last n values
+   weight of the k-th most recent value is (-1)^(k+1) C(n,k), k = 1..n
+------------------------------------------------------------------------- */
+
+void FixQEqReax::extrapolation_weights(double *weight, int n)
+{
+  double binom = 1.0;
+  for (int k = 1; k <= n; k++) {
+    binom = binom * (n-k+1) / k;
+    weight[k-1] = (k % 2) ? binom : -binom;
+  }
+}
+
 /* ---------------------------------------------------------------------- */
 
 void FixQEqReax::compute_H()
@@ -781,6 +841,317 @@ void FixQEqReax::sparse_matvec( sparse_matrix *A, double *x, double *b)
 
 }
 
+/* ----------------------------------------------------------------------
+   solve H s = b_s and H t = b_t together as one block system
+   s and t values of CG vectors are interleaved, so that each iteration
+     needs a single matvec with one forward and one reverse comm
+   single-reduction PCG of Chronopoulos and Gear: both dot products
+     of both systems are summed in one collective per iteration
+   with pipeline set, that collective is posted non-blocking and
+     overlaps the matvec, see Ghysels and Vanroose, Parallel Comput,
+     40, 224 (2014)
+   a system that has converged is frozen while the other one continues
+------------------------------------------------------------------------- */
+
+int FixQEqReax::dual_CG(double *b1, double *b2, double *x1, double *x2)
+{
+  int i, j, jj, k, imax;
+  double alpha[2], beta[2], gamma_old[2], b_norm[2];
+  double my_buf[6], buf[6];
+  int active[2];
+  double *x[2];
+  MPI_Request request;
+
+  int nn;
+  int *ilist;
+  if (reaxc) {
+    nn = reaxc->list->inum;
+    ilist = reaxc->list->ilist;
+  } else {
+    nn = list->inum;
+    ilist = list->ilist;
+  }
+
+  int *mask = atom->mask;
+  x[0] = x1;
+  x[1] = x2;
+
+  // without pipelining, u and w = A u are the forwarded d
+  //   and reverse summed q of the matvec
+  // with pipelining, d and q hold m = M w and n = A m instead
+
+  double *uu = pipeline ? u : d;
+  double *ww = pipeline ? w : q;
+
+  imax = 200;
+
+  // initial residual r = b - A x and u = M r
+
+  pack_flag = 5; // forward 2x d and reverse 2x q
+  dual_sparse_matvec(&H, x1, x2, q);
+  comm->reverse_comm_fix(this); //Coll_Vector( q );
+
+  my_buf[0] = my_buf[1] = 0.0;
+  for (jj = 0; jj < nn; ++jj) {
+    j = ilist[jj];
+    if (mask[j] & groupbit) {
+      int indxJ = 2 * j;
+      r[indxJ  ] = b1[j] - q[indxJ  ];
+      r[indxJ+1] = b2[j] - q[indxJ+1];
+      d[indxJ  ] = r[indxJ  ] * Hdia_inv[j]; //pre-condition
+      d[indxJ+1] = r[indxJ+1] * Hdia_inv[j];
+      p[indxJ] = p[indxJ+1] = y[indxJ] = y[indxJ+1] = 0.0;
+      if (pipeline) z[indxJ] = z[indxJ+1] = h[indxJ] = h[indxJ+1] = 0.0;
+      my_buf[0] += b1[j] * b1[j];
+      my_buf[1] += b2[j] * b2[j];
+    }
+  }
+
+  MPI_Allreduce(my_buf, buf, 2, MPI_DOUBLE, MPI_SUM, world);
+  b_norm[0] = sqrt(buf[0]);
+  b_norm[1] = sqrt(buf[1]);
+
+  // w = A u
+
+  comm->forward_comm_fix(this); //Dist_vector( d );
+  dual_sparse_matvec(&H, d, q);
+  comm->reverse_comm_fix(this); //Coll_vector( q );
+
+  if (pipeline) {
+    for (jj = 0; jj < nn; ++jj) {
+      j = ilist[jj];
+      if (mask[j] & groupbit) {
+        int indxJ = 2 * j;
+        u[indxJ  ] = d[indxJ  ];
+        u[indxJ+1] = d[indxJ+1];
+        w[indxJ  ] = q[indxJ  ];
+        w[indxJ+1] = q[indxJ+1];
+      }
+    }
+  }
+
+  active[0] = active[1] = 1;
+  alpha[0] = alpha[1] = 1.0;
+  gamma_old[0] = gamma_old[1] = 1.0;
+
+  for (i = 1; i < imax; ++i) {
+
+    // gamma = (r,u) and delta = (w,u) for both systems in one reduction
+
+    for (k = 0; k < 4; k++) my_buf[k] = 0.0;
+    for (jj = 0; jj < nn; ++jj) {
+      j = ilist[jj];
+      if (mask[j] & groupbit) {
+        int indxJ = 2 * j;
+        my_buf[0] += r[indxJ  ] * uu[indxJ  ];
+        my_buf[1] += r[indxJ+1] * uu[indxJ+1];
+        my_buf[2] += ww[indxJ  ] * uu[indxJ  ];
+        my_buf[3] += ww[indxJ+1] * uu[indxJ+1];
+      }
+    }
+
+    if (pipeline) {
+      MPI_Iallreduce(my_buf, buf, 4, MPI_DOUBLE, MPI_SUM, world, &request);
+
+      // m = M w and n = A m while the reduction is in flight
+
+      for (jj = 0; jj < nn; ++jj) {
+        j = ilist[jj];
+        if (mask[j] & groupbit) {
+          int indxJ = 2 * j;
+          d[indxJ  ] = w[indxJ  ] * Hdia_inv[j];
+          d[indxJ+1] = w[indxJ+1] * Hdia_inv[j];
+        }
+      }
+
+      comm->forward_comm_fix(this); //Dist_vector( d );
+      dual_sparse_matvec(&H, d, q);
+      comm->reverse_comm_fix(this); //Coll_vector( q );
+
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+    } else MPI_Allreduce(my_buf, buf, 4, MPI_DOUBLE, MPI_SUM, world);
+
+    for (k = 0; k < 2; k++) {
+      if (!active[k]) continue;
+      if (sqrt(buf[k]) / b_norm[k] <= tolerance) {
+        active[k] = 0;
+        alpha[k] = beta[k] = 0.0;
+        continue;
+      }
+      if (i == 1) {
+        beta[k] = 0.0;
+        alpha[k] = buf[k] / buf[2+k];
+      } else {
+        beta[k] = buf[k] / gamma_old[k];
+        alpha[k] = buf[k] / (buf[2+k] - beta[k] * buf[k] / alpha[k]);
+      }
+      gamma_old[k] = buf[k];
+    }
+
+    if (!active[0] && !active[1]) break;
+
+    // update both systems, frozen ones have alpha = beta = 0
+    //   and an active flag of 0
+
+    for (jj = 0; jj < nn; ++jj) {
+      j = ilist[jj];
+      if (mask[j] & groupbit) {
+        for (k = 0; k < 2; k++) {
+          if (!active[k]) continue;
+          int indx = 2 * j + k;
+          p[indx] = uu[indx] + beta[k] * p[indx];
+          y[indx] = ww[indx] + beta[k] * y[indx];
+          x[k][j] += alpha[k] * p[indx];
+          r[indx] -= alpha[k] * y[indx];
+          if (pipeline) {
+            z[indx] = q[indx] + beta[k] * z[indx];
+            h[indx] = d[indx] + beta[k] * h[indx];
+            u[indx] -= alpha[k] * h[indx];
+            w[indx] -= alpha[k] * z[indx];
+          }
+        }
+      }
+    }
+
+    if (pipeline) continue;
+
+    // u = M r and w = A u for the next iteration
+
+    for (jj = 0; jj < nn; ++jj) {
+      j = ilist[jj];
+      if (mask[j] & groupbit) {
+        int indxJ = 2 * j;
+        d[indxJ  ] = r[indxJ  ] * Hdia_inv[j];
+        d[indxJ+1] = r[indxJ+1] * Hdia_inv[j];
+      }
+    }
+
+    comm->forward_comm_fix(this); //Dist_vector( d );
+    dual_sparse_matvec(&H, d, q);
+    comm->reverse_comm_fix(this); //Coll_vector( q );
+  }
+
+  matvecs_s = matvecs_t = i;
+
+  if (i >= imax && comm->me == 0) {
+    char str[128];
+    sprintf(str,"Fix qeq/reax CG convergence failed after %d iterations "
+            "at " BIGINT_FORMAT " step",i,update->ntimestep);
+    error->warning(FLERR,str);
+  }
+
+  return i;
+}
+
+/* ----------------------------------------------------------------------
+   b = A x for separate x1,x2 into interleaved b
+------------------------------------------------------------------------- */
+
+void FixQEqReax::dual_sparse_matvec(sparse_matrix *A, double *x1, double *x2,
+                                    double *b)
+{
+  int i, j, itr_j;
+  int nn, NN, ii;
+  int *ilist;
+  int indxI, indxJ;
+
+  if (reaxc) {
+    nn = reaxc->list->inum;
+    NN = reaxc->list->inum + reaxc->list->gnum;
+    ilist = reaxc->list->ilist;
+  } else {
+    nn = list->inum;
+    NN = list->inum + list->gnum;
+    ilist = list->ilist;
+  }
+
+  for (ii = 0; ii < nn; ++ii) {
+    i = ilist[ii];
+    if (atom->mask[i] & groupbit) {
+      indxI = 2 * i;
+      b[indxI  ] = eta[ atom->type[i] ] * x1[i];
+      b[indxI+1] = eta[ atom->type[i] ] * x2[i];
+    }
+  }
+
+  for (ii = nn; ii < NN; ++ii) {
+    i = ilist[ii];
+    if (atom->mask[i] & groupbit) {
+      indxI = 2 * i;
+      b[indxI] = b[indxI+1] = 0;
+    }
+  }
+
+  for (ii = 0; ii < nn; ++ii) {
+    i = ilist[ii];
+    if (atom->mask[i] & groupbit) {
+      indxI = 2 * i;
+      for (itr_j=A->firstnbr[i]; itr_j<A->firstnbr[i]+A->numnbrs[i]; itr_j++) {
+        j = A->jlist[itr_j];
+        indxJ = 2 * j;
+        b[indxI  ] += A->val[itr_j] * x1[j];
+        b[indxI+1] += A->val[itr_j] * x2[j];
+        b[indxJ  ] += A->val[itr_j] * x1[i];
+        b[indxJ+1] += A->val[itr_j] * x2[i];
+      }
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   b = A x for interleaved x and b
+------------------------------------------------------------------------- */
+
+void FixQEqReax::dual_sparse_matvec(sparse_matrix *A, double *x, double *b)
+{
+  int i, j, itr_j;
+  int nn, NN, ii;
+  int *ilist;
+  int indxI, indxJ;
+
+  if (reaxc) {
+    nn = reaxc->list->inum;
+    NN = reaxc->list->inum + reaxc->list->gnum;
+    ilist = reaxc->list->ilist;
+  } else {
+    nn = list->inum;
+    NN = list->inum + list->gnum;
+    ilist = list->ilist;
+  }
+
+  for (ii = 0; ii < nn; ++ii) {
+    i = ilist[ii];
+    if (atom->mask[i] & groupbit) {
+      indxI = 2 * i;
+      b[indxI  ] = eta[ atom->type[i] ] * x[indxI  ];
+      b[indxI+1] = eta[ atom->type[i] ] * x[indxI+1];
+    }
+  }
+
+  for (ii = nn; ii < NN; ++ii) {
+    i = ilist[ii];
+    if (atom->mask[i] & groupbit) {
+      indxI = 2 * i;
+      b[indxI] = b[indxI+1] = 0;
+    }
+  }
+
+  for (ii = 0; ii < nn; ++ii) {
+    i = ilist[ii];
+    if (atom->mask[i] & groupbit) {
+      indxI = 2 * i;
+      for (itr_j=A->firstnbr[i]; itr_j<A->firstnbr[i]+A->numnbrs[i]; itr_j++) {
+        j = A->jlist[itr_j];
+        indxJ = 2 * j;
+        b[indxI  ] += A->val[itr_j] * x[indxJ  ];
+        b[indxI+1] += A->val[itr_j] * x[indxJ+1];
+        b[indxJ  ] += A->val[itr_j] * x[indxI  ];
+        b[indxJ+1] += A->val[itr_j] * x[indxI+1];
+      }
+    }
+  }
+}
+
 /* ---------------------------------------------------------------------- */
 
 void FixQEqReax::calculate_Q()
@@ -927,6 +1298,10 @@ double FixQEqReax::memory_usage()
 
   if (dual_enabled)
     bytes += atom->nmax*4 * sizeof(double); // double size for q, d, r, and p
+  if (dual_enabled)
+    bytes += atom->nmax*2 * sizeof(double); // y
+  if (pipeline)
+    bytes += atom->nmax*8 * sizeof(double); // u, w, z, and h
 
   return bytes;
 }
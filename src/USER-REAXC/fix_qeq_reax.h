@@ -78,6 +78,7 @@ class FixQEqReax : public Fix {
   double *s, *t;
   double **s_hist, **t_hist;
   int nprev;
+  double *s_extrap, *t_extrap;   // extrapolation weights of s_hist, t_hist
 
   typedef struct{
     int n, m;
@@ -95,6 +96,12 @@ class FixQEqReax : public Fix {
   //CG storage
   double *p, *q, *r, *d;
 
+  // dual CG storage, interleaved s and t values
+  // y = A p, u and w = A u are separate from d and q only when pipelined
+  // z, h = recurrences for A M w and M y in pipelined CG
+
+  double *y, *u, *w, *z, *h;
+
   //GMRES storage
   //double *g,*y;
   //double **v;
@@ -114,6 +121,7 @@ class FixQEqReax : public Fix {
 
   virtual void init_matvec();
   void init_H();
+  void extrapolation_weights(double *, int);
   virtual void compute_H();
   double calculate_H(double,double);
   virtual void calculate_Q();
@@ -122,6 +130,11 @@ class FixQEqReax : public Fix {
   //int GMRES(double*,double*);
   virtual void sparse_matvec(sparse_matrix*,double*,double*);
 
+  // dual CG support
+  virtual int dual_CG(double*,double*,double*,double*);
+  virtual void dual_sparse_matvec(sparse_matrix*,double*,double*,double*);
+  virtual void dual_sparse_matvec(sparse_matrix*,double*,double*);
+
   virtual int pack_forward_comm(int, int *, double *, int, int *);
   virtual void unpack_forward_comm(int, int, double *);
   virtual int pack_reverse_comm(int, int, double *);
@@ -141,6 +154,7 @@ class FixQEqReax : public Fix {
 
   // dual CG support
   int dual_enabled;  // 0: Original, separate s & t optimization; 1: dual optimization
+  int pipeline;      // 1: overlap the dual CG reduction with the matvec
   int matvecs_s, matvecs_t; // Iteration count for each system
 };
 
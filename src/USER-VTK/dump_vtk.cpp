@@ -104,6 +104,8 @@ enum{VTK,VTP,VTU,PVTP,PVTU}; // file formats
 DumpVTK::DumpVTK(LAMMPS *lmp, int narg, char **arg) :
   DumpCustom(lmp, narg, arg)
 {
+  async_allow = 0;
+
   if (narg == 5) error->all(FLERR,"No dump vtk arguments specified");
 
   pack_choice.clear();
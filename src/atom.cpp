@@ -51,6 +51,72 @@ using namespace MathConst;
 #define DELTA_MEMSTR 1024
 #define EPSILON 1.0e-6
 
+// key of a sort bin along a space-filling curve
+
+struct BinKey {
+  uint64_t key;
+  int ibin;
+};
+
+/* ----------------------------------------------------------------------
+   convert grid point in place to transposed Hilbert index
+   J. Skilling, Programming the Hilbert curve, AIP Conf Proc 707, 381 (2004)
+------------------------------------------------------------------------- */
+
+static void hilbert_transpose(unsigned int *x, int n, int nbits)
+{
+  unsigned int m = 1U << (nbits-1);
+  unsigned int p,q,t;
+  int i;
+
+  // inverse undo
+
+  for (q = m; q > 1; q >>= 1) {
+    p = q - 1;
+    for (i = 0; i < n; i++) {
+      if (x[i] & q) x[0] ^= p;
+      else {
+        t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode
+
+  for (i = 1; i < n; i++) x[i] ^= x[i-1];
+  t = 0;
+  for (q = m; q > 1; q >>= 1)
+    if (x[n-1] & q) t ^= q - 1;
+  for (i = 0; i < n; i++) x[i] ^= t;
+}
+
+/* ----------------------------------------------------------------------
+   interleave bits of N coords into one key, MSB of x[0] is MSB of key
+   for untransformed coords this is the Morton (Z-order) index
+------------------------------------------------------------------------- */
+
+static uint64_t interleave_bits(unsigned int *x, int n, int nbits)
+{
+  uint64_t key = 0;
+  for (int b = nbits-1; b >= 0; b--)
+    for (int i = 0; i < n; i++)
+      key = (key << 1) | ((x[i] >> b) & 1);
+  return key;
+}
+
+/* ---------------------------------------------------------------------- */
+
+static int compare_binkey(const void *iptr, const void *jptr)
+{
+  const BinKey *i = (const BinKey *) iptr;
+  const BinKey *j = (const BinKey *) jptr;
+  if (i->key < j->key) return -1;
+  if (i->key > j->key) return 1;
+  return 0;
+}
+
 /* ---------------------------------------------------------------------- */
 
 Atom::Atom(LAMMPS *lmp) : Pointers(lmp)
@@ -66,8 +132,11 @@ Atom::Atom(LAMMPS *lmp) : Pointers(lmp)
   sortfreq = 1000;
   nextsort = 0;
   userbinsize = 0.0;
+  sortstyle = SORT_XYZ;
   maxbin = maxnext = 0;
   binhead = NULL;
+  binorder = NULL;
+  orderstyle = -1;
   next = permute = NULL;
 
   // initialize atom arrays
@@ -246,6 +315,7 @@ Atom::~Atom()
 
   delete [] firstgroupname;
   memory->destroy(binhead);
+  memory->destroy(binorder);
   memory->destroy(next);
   memory->destroy(permute);
 
@@ -399,6 +469,7 @@ void Atom::settings(Atom *old)
   map_style = old->map_style;
   sortfreq = old->sortfreq;
   userbinsize = old->userbinsize;
+  sortstyle = old->sortstyle;
   if (old->firstgroupname) {
     int n = strlen(old->firstgroupname) + 1;
     firstgroupname = new char[n];
@@ -633,6 +704,19 @@ void Atom::modify_params(int narg, char **arg)
         error->all(FLERR,"Atom_modify sort and first options "
                    "cannot be used together");
       iarg += 3;
+      sortstyle = SORT_XYZ;
+      if (iarg < narg) {
+        if (strcmp(arg[iarg],"xyz") == 0) {
+          sortstyle = SORT_XYZ;
+          iarg++;
+        } else if (strcmp(arg[iarg],"morton") == 0) {
+          sortstyle = SORT_MORTON;
+          iarg++;
+        } else if (strcmp(arg[iarg],"hilbert") == 0) {
+          sortstyle = SORT_HILBERT;
+          iarg++;
+        }
+      }
     } else error->all(FLERR,"Illegal atom_modify command");
   }
 }
@@ -873,10 +957,12 @@ void Atom::deallocate_topology()
 /* ----------------------------------------------------------------------
    unpack N lines from Atom section of data file
    call style-specific routine to parse line
+   allflag = 1 to keep all atoms in the box, not just those in my sub-domain
 ------------------------------------------------------------------------- */
 
 void Atom::data_atoms(int n, char *buf, tagint id_offset, tagint mol_offset,
-                      int type_offset, int shiftflag, double *shift)
+                      int type_offset, int shiftflag, double *shift,
+                      int allflag)
 {
   int m,xptr,iptr;
   imageint imagedata;
@@ -919,7 +1005,31 @@ void Atom::data_atoms(int n, char *buf, tagint id_offset, tagint mol_offset,
     sublo[2] = domain->sublo_lamda[2]; subhi[2] = domain->subhi_lamda[2];
   }
 
-  if (comm->layout != Comm::LAYOUT_TILED) {
+  // if allflag, bounds are the global box and caller migrates atoms later
+
+  if (allflag) {
+    if (triclinic == 0) {
+      sublo[0] = domain->boxlo[0]; subhi[0] = domain->boxhi[0];
+      sublo[1] = domain->boxlo[1]; subhi[1] = domain->boxhi[1];
+      sublo[2] = domain->boxlo[2]; subhi[2] = domain->boxhi[2];
+    } else {
+      sublo[0] = sublo[1] = sublo[2] = 0.0;
+      subhi[0] = subhi[1] = subhi[2] = 1.0;
+    }
+    if (domain->xperiodic) {
+      sublo[0] -= epsilon[0];
+      subhi[0] += epsilon[0];
+    }
+    if (domain->yperiodic) {
+      sublo[1] -= epsilon[1];
+      subhi[1] += epsilon[1];
+    }
+    if (domain->zperiodic) {
+      sublo[2] -= epsilon[2];
+      subhi[2] += epsilon[2];
+    }
+
+  } else if (comm->layout != Comm::LAYOUT_TILED) {
     if (domain->xperiodic) {
       if (comm->myloc[0] == 0) sublo[0] -= epsilon[0];
       if (comm->myloc[0] == comm->procgrid[0]-1) subhi[0] += epsilon[0];
@@ -1870,12 +1980,24 @@ void Atom::sort()
   // permute = desired permutation of atoms
   // permute[I] = J means Ith new atom will be Jth old atom
 
+  // for space-filling curves, bins are visited in curve order
+
   n = 0;
-  for (m = 0; m < nbins; m++) {
-    i = binhead[m];
-    while (i >= 0) {
-      permute[n++] = i;
-      i = next[i];
+  if (sortstyle == SORT_XYZ) {
+    for (m = 0; m < nbins; m++) {
+      i = binhead[m];
+      while (i >= 0) {
+        permute[n++] = i;
+        i = next[i];
+      }
+    }
+  } else {
+    for (m = 0; m < nbins; m++) {
+      i = binhead[binorder[m]];
+      while (i >= 0) {
+        permute[n++] = i;
+        i = next[i];
+      }
     }
   }
 
@@ -2023,9 +2145,68 @@ void Atom::setup_sort_bins()
 
   if (nbins > maxbin) {
     memory->destroy(binhead);
+    memory->destroy(binorder);
+    orderstyle = -1;
     maxbin = nbins;
     memory->create(binhead,maxbin,"atom:binhead");
+    if (sortstyle != SORT_XYZ)
+      memory->create(binorder,maxbin,"atom:binorder");
+  } else if (sortstyle != SORT_XYZ && binorder == NULL) {
+    memory->create(binorder,maxbin,"atom:binorder");
+    orderstyle = -1;
   }
+
+  if (sortstyle != SORT_XYZ) setup_sort_order();
+}
+
+/* ----------------------------------------------------------------------
+   set binorder = sort bins in order of a Morton or Hilbert curve
+   curve is defined on a 2^nbits grid covering all bins in each dim,
+     bins are ranked by curve index of their grid point
+   order is kept until the curve or the bin counts change,
+     so cost of qsort() does not matter even if the box changes
+------------------------------------------------------------------------- */
+
+void Atom::setup_sort_order()
+{
+  int i,ix,iy,iz,ibin;
+
+  if (orderstyle == sortstyle && ordernbinx == nbinx &&
+      ordernbiny == nbiny && ordernbinz == nbinz) return;
+
+  int dimension = domain->dimension;
+  int nbinmax = MAX(nbinx,nbiny);
+  nbinmax = MAX(nbinmax,nbinz);
+  int nbits = 1;
+  while ((1 << nbits) < nbinmax) nbits++;
+  if (nbits*dimension > 8*(int)sizeof(uint64_t))
+    error->one(FLERR,"Too many atom sorting bins for space-filling curve");
+
+  BinKey *keys = (BinKey *)
+    memory->smalloc(nbins*sizeof(BinKey),"atom:keys");
+
+  unsigned int coord[3];
+  for (iz = 0; iz < nbinz; iz++)
+    for (iy = 0; iy < nbiny; iy++)
+      for (ix = 0; ix < nbinx; ix++) {
+        ibin = iz*nbiny*nbinx + iy*nbinx + ix;
+        coord[0] = ix;
+        coord[1] = iy;
+        coord[2] = iz;
+        if (sortstyle == SORT_HILBERT) hilbert_transpose(coord,dimension,nbits);
+        keys[ibin].key = interleave_bits(coord,dimension,nbits);
+        keys[ibin].ibin = ibin;
+      }
+
+  qsort(keys,nbins,sizeof(BinKey),compare_binkey);
+
+  for (i = 0; i < nbins; i++) binorder[i] = keys[i].ibin;
+  memory->sfree(keys);
+
+  orderstyle = sortstyle;
+  ordernbinx = nbinx;
+  ordernbiny = nbiny;
+  ordernbinz = nbinz;
 }
 
 /* ----------------------------------------------------------------------
@@ -209,6 +209,8 @@ class Atom : protected Pointers {
   int sortfreq;             // sort atoms every this many steps, 0 = off
   bigint nextsort;          // next timestep to sort on
   double userbinsize;       // requested sort bin size
+  int sortstyle;            // order of sort bins: xyz or space-filling curve
+  enum{SORT_XYZ,SORT_MORTON,SORT_HILBERT};
 
   // indices of atoms with same ID
 
@@ -245,7 +247,8 @@ class Atom : protected Pointers {
 
   void deallocate_topology();
 
-  void data_atoms(int, char *, tagint, tagint, int, int, double *);
+  void data_atoms(int, char *, tagint, tagint, int, int, double *,
+                  int allflag = 0);
   void data_vels(int, char *, tagint);
   void data_bonds(int, char *, int *, tagint, int);
   void data_angles(int, char *, int *, tagint, int);
@@ -336,6 +339,9 @@ class Atom : protected Pointers {
   int maxbin;                     // max # of bins
   int maxnext;                    // max size of next,permute
   int *binhead;                   // 1st atom in each bin
+  int *binorder;                  // bins in order along space-filling curve
+  int orderstyle;                 // sortstyle binorder was set for, -1 if none
+  int ordernbinx,ordernbiny,ordernbinz; // bin counts binorder was set for
   int *next;                      // next atom in bin
   int *permute;                   // permutation vector
   double bininvx,bininvy,bininvz; // inverse actual bin sizes
@@ -345,6 +351,7 @@ class Atom : protected Pointers {
   char *memstr;                   // string of array names already counted
 
   void setup_sort_bins();
+  void setup_sort_order();
   int next_prime(int);
 
  private:
@@ -507,6 +514,12 @@ E: Too many atom sorting bins
 This is likely due to an immense simulation box that has blown up
 to a large size.
 
+E: Too many atom sorting bins for space-filling curve
+
+The curve index of a sort bin must fit in a 64-bit integer, which
+limits the number of bins in one dimension to 2^20 in 3d.  Use a
+larger sort binsize.
+
 U: Cannot set mass for this atom style
 
 This atom style does not support mass settings for each atom type.
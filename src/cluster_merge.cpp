@@ -0,0 +1,500 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include <mpi.h>
+#include <cstdlib>
+#include "cluster_merge.h"
+#include "atom.h"
+#include "comm.h"
+#include "domain.h"
+#include "memory.h"
+
+using namespace LAMMPS_NS;
+
+#define RVOUS 1   // 0 for irregular, 1 for all2all
+#define DELTA 16384
+
+enum{LARGE,SMALL};
+
+/* ---------------------------------------------------------------------- */
+
+ClusterMerge::ClusterMerge(LAMMPS *lmp) : Pointers(lmp)
+{
+  MPI_Comm_rank(world,&me);
+  MPI_Comm_size(world,&nprocs);
+
+  maxatom = 0;
+  parent = flag = NULL;
+  label = NULL;
+
+  nedge = maxedge = 0;
+  edge = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+ClusterMerge::~ClusterMerge()
+{
+  memory->destroy(parent);
+  memory->destroy(flag);
+  memory->destroy(label);
+  memory->destroy(edge);
+}
+
+/* ----------------------------------------------------------------------
+   every owned and ghost atom starts in its own cluster
+   only atoms in group with mask groupbit are assigned cluster IDs
+------------------------------------------------------------------------- */
+
+void ClusterMerge::reset(int *mask_caller, int groupbit_caller)
+{
+  if (atom->nmax > maxatom) {
+    memory->destroy(parent);
+    memory->destroy(flag);
+    memory->destroy(label);
+    maxatom = atom->nmax;
+    memory->create(parent,maxatom,"cluster_merge:parent");
+    memory->create(flag,maxatom,"cluster_merge:flag");
+    memory->create(label,maxatom,"cluster_merge:label");
+  }
+
+  mask = mask_caller;
+  groupbit = groupbit_caller;
+
+  int nall = atom->nlocal + atom->nghost;
+  for (int i = 0; i < nall; i++) parent[i] = i;
+}
+
+/* ----------------------------------------------------------------------
+   assign on-processor cluster IDs after caller has joined atom pairs
+   ghost atoms are first joined to owned atoms with the same atom ID
+   cluster ID = smallest atom ID in the on-processor cluster
+   ID = cluster ID for owned + ghost atoms in group, 0 otherwise
+------------------------------------------------------------------------- */
+
+void ClusterMerge::local_ids(double *ID)
+{
+  int i,k;
+
+  int nlocal = atom->nlocal;
+  int nall = nlocal + atom->nghost;
+  tagint *tag = atom->tag;
+
+  if (atom->map_style) {
+    for (i = nlocal; i < nall; i++) {
+      if (!(mask[i] & groupbit)) continue;
+      k = atom->map(tag[i]);
+      if (k >= 0 && k < nlocal && (mask[k] & groupbit)) join(i,k);
+    }
+  }
+
+  for (i = 0; i < nall; i++) label[i] = MAXTAGINT;
+  for (i = 0; i < nall; i++) {
+    if (!(mask[i] & groupbit)) continue;
+    k = find(i);
+    if (tag[i] < label[k]) label[k] = tag[i];
+  }
+
+  for (i = 0; i < nall; i++)
+    if (mask[i] & groupbit) ID[i] = label[find(i)];
+    else ID[i] = 0.0;
+}
+
+/* ----------------------------------------------------------------------
+   merge on-processor clusters into global clusters
+   caller must have overwritten ghost IDs with the on-processor cluster IDs
+     of their owning procs via forward comm
+   each ghost atom whose owner cluster ID differs from its local one is an
+     edge of a graph whose nodes are on-processor cluster IDs
+   contract graph with alternating large-star and small-star operations
+     via rendezvous comm, until each connected component is a star
+     centered on its smallest node = smallest atom ID in global cluster
+   ID = global cluster ID for owned + ghost atoms in group on return
+------------------------------------------------------------------------- */
+
+void ClusterMerge::global_ids(double *ID)
+{
+  int i;
+  tagint a,b;
+
+  int nlocal = atom->nlocal;
+  int nall = nlocal + atom->nghost;
+
+  nedge = 0;
+  for (i = nlocal; i < nall; i++) {
+    if (!(mask[i] & groupbit)) continue;
+    a = label[find(i)];
+    b = (tagint) ID[i];
+    if (a < b) add_edge(b,a);
+    else if (b < a) add_edge(a,b);
+  }
+
+  bigint nedgeme = nedge;
+  bigint nedgeall;
+  MPI_Allreduce(&nedgeme,&nedgeall,1,MPI_LMP_BIGINT,MPI_SUM,world);
+
+  // no cluster spans procs, restore on-processor IDs of ghost atoms
+
+  if (nedgeall == 0) {
+    for (i = nlocal; i < nall; i++)
+      if (mask[i] & groupbit) ID[i] = label[find(i)];
+    return;
+  }
+
+  // alternate until no proc changes its edges
+  // converges in O(log^2 N) passes for a component with N nodes
+
+  int change,anychange;
+
+  while (1) {
+    change = star(LARGE);
+    change |= star(SMALL);
+    MPI_Allreduce(&change,&anychange,1,MPI_INT,MPI_MAX,world);
+    if (!anychange) break;
+  }
+
+  lookup(ID);
+}
+
+/* ----------------------------------------------------------------------
+   add edge between cluster IDs U and V to list of edges
+------------------------------------------------------------------------- */
+
+void ClusterMerge::add_edge(tagint u, tagint v)
+{
+  if (nedge == maxedge) {
+    maxedge += DELTA;
+    memory->grow(edge,2*maxedge,"cluster_merge:edge");
+  }
+  edge[2*nedge] = u;
+  edge[2*nedge+1] = v;
+  nedge++;
+}
+
+/* ----------------------------------------------------------------------
+   one large-star or small-star operation on current edges
+   each edge is sent to the rendezvous procs of both its nodes
+   new edges are returned by callback in edge list
+   return 1 if edges on this proc changed, else 0
+------------------------------------------------------------------------- */
+
+int ClusterMerge::star(int op)
+{
+  int i;
+
+  int nsend = 2*nedge;
+  int *proclist;
+  memory->create(proclist,nsend,"cluster_merge:proclist");
+  EdgeRvous *inbuf = (EdgeRvous *)
+    memory->smalloc((bigint) nsend*sizeof(EdgeRvous),"cluster_merge:inbuf");
+
+  // setup input buf to rendezvous comm
+  // two datums for each edge, one for each of its nodes
+  // datum = node, neighbor node
+  // each proc assigned every 1/Pth node
+
+  for (i = 0; i < nedge; i++) {
+    inbuf[2*i].node = edge[2*i];
+    inbuf[2*i].nbr = edge[2*i+1];
+    proclist[2*i] = edge[2*i] % nprocs;
+    inbuf[2*i+1].node = edge[2*i+1];
+    inbuf[2*i+1].nbr = edge[2*i];
+    proclist[2*i+1] = edge[2*i+1] % nprocs;
+  }
+
+  // perform rendezvous operation
+  // callback rebuilds edge list
+
+  starop = op;
+  starchange = 0;
+  nedge = 0;
+
+  char *buf;
+  comm->rendezvous(RVOUS,nsend,(char *) inbuf,sizeof(EdgeRvous),0,proclist,
+                   rendezvous_star,0,buf,0,(void *) this);
+
+  memory->destroy(proclist);
+  memory->sfree(inbuf);
+
+  return starchange;
+}
+
+/* ----------------------------------------------------------------------
+   set global cluster IDs of all local clusters that may span procs
+   clusters are flagged if they contain a ghost atom or an owned atom
+     within the ghost cutoff of the sub-domain boundary
+   each flagged cluster ID is sent to its rendezvous proc,
+     along with the final star edges
+   rendezvous proc returns the star center = global cluster ID
+------------------------------------------------------------------------- */
+
+void ClusterMerge::lookup(double *ID)
+{
+  int i,k,m;
+
+  int nlocal = atom->nlocal;
+  int nall = nlocal + atom->nghost;
+  double **x = atom->x;
+  double *cut = comm->cutghost;
+
+  double *lo,*hi,*xone;
+  double lamda[3];
+  if (domain->triclinic == 0) {
+    lo = domain->sublo;
+    hi = domain->subhi;
+  } else {
+    lo = domain->sublo_lamda;
+    hi = domain->subhi_lamda;
+  }
+
+  for (i = 0; i < nall; i++) flag[i] = 0;
+
+  for (i = 0; i < nlocal; i++) {
+    if (!(mask[i] & groupbit)) continue;
+    if (domain->triclinic) {
+      domain->x2lamda(x[i],lamda);
+      xone = lamda;
+    } else xone = x[i];
+    if (xone[0] < lo[0]+cut[0] || xone[0] >= hi[0]-cut[0] ||
+        xone[1] < lo[1]+cut[1] || xone[1] >= hi[1]-cut[1] ||
+        xone[2] < lo[2]+cut[2] || xone[2] >= hi[2]-cut[2])
+      flag[find(i)] = 1;
+  }
+
+  for (i = nlocal; i < nall; i++)
+    if (mask[i] & groupbit) flag[find(i)] = 1;
+
+  int nquery = 0;
+  for (i = 0; i < nall; i++)
+    if (parent[i] == i && flag[i]) nquery++;
+
+  // setup input buf to rendezvous comm
+  // one datum for each flagged cluster: datum = cluster ID, 0, me
+  // one datum for each star edge: datum = leaf, center, -1
+
+  int nsend = nquery + nedge;
+  int *proclist;
+  memory->create(proclist,nsend,"cluster_merge:proclist");
+  LabelRvous *inbuf = (LabelRvous *)
+    memory->smalloc((bigint) nsend*sizeof(LabelRvous),"cluster_merge:inbuf");
+
+  m = 0;
+  for (i = 0; i < nall; i++) {
+    if (parent[i] != i || !flag[i]) continue;
+    inbuf[m].label = label[i];
+    inbuf[m].root = 0;
+    inbuf[m].proc = me;
+    proclist[m] = label[i] % nprocs;
+    m++;
+  }
+
+  for (i = 0; i < nedge; i++) {
+    inbuf[m].label = edge[2*i];
+    inbuf[m].root = edge[2*i+1];
+    inbuf[m].proc = -1;
+    proclist[m] = edge[2*i] % nprocs;
+    m++;
+  }
+
+  // perform rendezvous operation
+
+  char *buf;
+  int nreturn = comm->rendezvous(RVOUS,nsend,(char *) inbuf,
+                                 sizeof(LabelRvous),0,proclist,
+                                 rendezvous_lookup,0,buf,sizeof(LabelRvous),
+                                 (void *) this);
+  LabelRvous *outbuf = (LabelRvous *) buf;
+
+  memory->destroy(proclist);
+  memory->sfree(inbuf);
+
+  // set global cluster ID of every atom in group
+  // via binary search of returned cluster IDs for flagged clusters
+
+  qsort(outbuf,nreturn,sizeof(LabelRvous),compare_label);
+
+  for (i = 0; i < nall; i++) {
+    if (parent[i] != i) continue;
+    if (flag[i]) {
+      int ilo = 0;
+      int ihi = nreturn-1;
+      while (ilo < ihi) {
+        m = (ilo+ihi) / 2;
+        if (outbuf[m].label < label[i]) ilo = m+1;
+        else ihi = m;
+      }
+      label[i] = outbuf[ilo].root;
+    }
+  }
+
+  for (i = 0; i < nall; i++) {
+    if (!(mask[i] & groupbit)) continue;
+    k = find(i);
+    ID[i] = label[k];
+  }
+
+  memory->sfree(outbuf);
+  nedge = 0;
+}
+
+/* ----------------------------------------------------------------------
+   callback from rendezvous operation
+   process all edges of nodes assigned to this proc
+   large-star: connect larger neighbors of node to min of node + neighbors
+   small-star: connect node + smaller neighbors to min of smaller neighbors
+   new edges are stored in edge list of caller, no datums are returned
+------------------------------------------------------------------------- */
+
+int ClusterMerge::rendezvous_star(int n, char *inbuf,
+                                  int &flag, int *& /*proclist*/,
+                                  char *& /*outbuf*/, void *ptr)
+{
+  int i,j,k;
+  tagint u,v,m,prev;
+
+  ClusterMerge *cptr = (ClusterMerge *) ptr;
+  EdgeRvous *in = (EdgeRvous *) inbuf;
+
+  // sort by node, then by neighbor
+  // neighbors of each node are then contiguous and ascending
+
+  qsort(in,n,sizeof(EdgeRvous),compare_edge);
+
+  for (i = 0; i < n; i = j) {
+    u = in[i].node;
+    for (j = i; j < n && in[j].node == u; j++);
+
+    prev = 0;
+    if (cptr->starop == LARGE) {
+      m = MIN(u,in[i].nbr);
+      for (k = i; k < j; k++) {
+        v = in[k].nbr;
+        if (v <= u || v == prev) continue;
+        prev = v;
+        cptr->add_edge(v,m);
+        if (m != u) cptr->starchange = 1;
+      }
+    } else {
+      m = in[i].nbr;
+      if (m > u) continue;
+      cptr->add_edge(u,m);
+      prev = m;
+      for (k = i+1; k < j; k++) {
+        v = in[k].nbr;
+        if (v > u) break;
+        if (v == prev) continue;
+        prev = v;
+        cptr->add_edge(v,m);
+        cptr->starchange = 1;
+      }
+    }
+  }
+
+  flag = 0;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   callback from rendezvous operation
+   process star edges and cluster ID queries assigned to this proc
+   return center of star for each queried cluster ID to querying proc
+   cluster IDs that are not the leaf of a star are their own center
+------------------------------------------------------------------------- */
+
+int ClusterMerge::rendezvous_lookup(int n, char *inbuf,
+                                    int &flag, int *&proclist,
+                                    char *&outbuf, void *ptr)
+{
+  int i,j,k;
+  tagint root;
+
+  ClusterMerge *cptr = (ClusterMerge *) ptr;
+  Memory *memory = cptr->memory;
+  LabelRvous *in = (LabelRvous *) inbuf;
+
+  // sort by cluster ID, then by proc, so star edges come first
+
+  qsort(in,n,sizeof(LabelRvous),compare_label);
+
+  int nout = 0;
+  for (i = 0; i < n; i++)
+    if (in[i].proc >= 0) nout++;
+
+  memory->create(proclist,nout,"cluster_merge:proclist");
+  LabelRvous *out = (LabelRvous *)
+    memory->smalloc((bigint) nout*sizeof(LabelRvous),"cluster_merge:outbuf");
+
+  nout = 0;
+  for (i = 0; i < n; i = j) {
+    root = in[i].label;
+    if (in[i].proc < 0) root = in[i].root;
+    for (j = i; j < n && in[j].label == in[i].label; j++);
+    for (k = i; k < j; k++) {
+      if (in[k].proc < 0) continue;
+      out[nout].label = in[k].label;
+      out[nout].root = root;
+      out[nout].proc = in[k].proc;
+      proclist[nout] = in[k].proc;
+      nout++;
+    }
+  }
+
+  outbuf = (char *) out;
+
+  flag = 2;
+  return nout;
+}
+
+/* ----------------------------------------------------------------------
+   memory usage of union-find arrays and edge list
+------------------------------------------------------------------------- */
+
+double ClusterMerge::memory_usage()
+{
+  double bytes = 2*maxatom * sizeof(int);
+  bytes += maxatom * sizeof(tagint);
+  bytes += 2*maxedge * sizeof(tagint);
+  return bytes;
+}
+
+/* ----------------------------------------------------------------------
+   comparison function invoked by qsort() on edge datums
+   sort by node, then by neighbor node
+------------------------------------------------------------------------- */
+
+int ClusterMerge::compare_edge(const void *iptr, const void *jptr)
+{
+  const EdgeRvous *i = (const EdgeRvous *) iptr;
+  const EdgeRvous *j = (const EdgeRvous *) jptr;
+  if (i->node < j->node) return -1;
+  if (i->node > j->node) return 1;
+  if (i->nbr < j->nbr) return -1;
+  if (i->nbr > j->nbr) return 1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   comparison function invoked by qsort() on cluster ID datums
+   sort by cluster ID, then by proc
+------------------------------------------------------------------------- */
+
+int ClusterMerge::compare_label(const void *iptr, const void *jptr)
+{
+  const LabelRvous *i = (const LabelRvous *) iptr;
+  const LabelRvous *j = (const LabelRvous *) jptr;
+  if (i->label < j->label) return -1;
+  if (i->label > j->label) return 1;
+  if (i->proc < j->proc) return -1;
+  if (i->proc > j->proc) return 1;
+  return 0;
+}
@@ -0,0 +1,92 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifndef LMP_CLUSTER_MERGE_H
+#define LMP_CLUSTER_MERGE_H
+
+#include "pointers.h"
+
+namespace LAMMPS_NS {
+
+class ClusterMerge : protected Pointers {
+ public:
+  ClusterMerge(class LAMMPS *);
+  ~ClusterMerge();
+  void reset(int *, int);
+  void local_ids(double *);
+  void global_ids(double *);
+  double memory_usage();
+
+  // find root of cluster containing atom I, with path halving
+
+  int find(int i) {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  }
+
+  // merge clusters containing atoms I and J, lower index becomes root
+
+  void join(int i, int j) {
+    i = find(i);
+    j = find(j);
+    if (i < j) parent[j] = i;
+    else if (j < i) parent[i] = j;
+  }
+
+ private:
+  int me,nprocs;
+  int maxatom;
+  int *parent;             // union-find forest over owned + ghost atoms
+  int *flag;               // 1 if local cluster may extend to other procs
+  tagint *label;           // smallest atom ID in cluster, stored at root
+  int *mask;
+  int groupbit;
+
+  // data used by rendezvous callback methods
+
+  int nedge,maxedge;
+  tagint *edge;            // pairs of cluster IDs that are in same cluster
+  int starop,starchange;
+
+  struct EdgeRvous {
+    tagint node,nbr;
+  };
+
+  struct LabelRvous {
+    tagint label,root;
+    int proc;
+  };
+
+  // private methods
+
+  void add_edge(tagint, tagint);
+  int star(int);
+  void lookup(double *);
+
+  // callback functions for rendezvous communication
+
+  static int rendezvous_star(int, char *, int &, int *&, char *&, void *);
+  static int rendezvous_lookup(int, char *, int &, int *&, char *&, void *);
+
+  // comparison functions for sorting rendezvous datums
+
+  static int compare_edge(const void *, const void *);
+  static int compare_label(const void *, const void *);
+};
+
+}
+
+#endif
@@ -41,6 +41,10 @@ class Comm : protected Pointers {
   int maxexchange_atom;             // max contribution to exchange from AtomVec
   int maxexchange_fix;              // max contribution to exchange from Fixes
   int nthreads;                     // OpenMP threads per MPI process
+  int overlap;                      // 1 if forward/reverse comm may be staged
+                                    //   to overlap with force computation
+  int persistent;                   // 1 if forward/reverse comm reuses
+                                    //   persistent MPI requests
 
   // public settings specific to layout = UNIFORM, NONUNIFORM
 
@@ -76,6 +80,16 @@ class Comm : protected Pointers {
   virtual void exchange() = 0;                   // move atoms to new procs
   virtual void borders() = 0;                    // setup list of atoms to comm
 
+  // staged forward/reverse comm of coords/forces for overlap with computation
+  // begin() posts 1st stage, next() completes a stage and posts the next one
+  // both return # of stages still pending, 0 = comm is complete
+  // default is to perform the entire comm in begin()
+
+  virtual int forward_comm_begin() {forward_comm(); return 0;}
+  virtual int forward_comm_next() {return 0;}
+  virtual int reverse_comm_begin() {reverse_comm(); return 0;}
+  virtual int reverse_comm_next() {return 0;}
+
   // forward/reverse comm from a Pair, Fix, Compute, Dump
 
   virtual void forward_comm_pair(class Pair *) = 0;
@@ -45,6 +45,7 @@ using namespace LAMMPS_NS;
 #define BUFMIN 1000
 #define BUFEXTRA 1000
 #define BIG 1.0e20
+#define STAGETAG 101            // tag for staged comm, 1 more for odd swaps
 
 /* ---------------------------------------------------------------------- */
 
@@ -81,6 +82,11 @@ CommBrick::~CommBrick()
 
   memory->destroy(buf_send);
   memory->destroy(buf_recv);
+  memory->destroy(buf_stage[0]);
+  memory->destroy(buf_stage[1]);
+
+  persist_free();
+  memory->destroy(buf_persist);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -123,6 +129,18 @@ void CommBrick::init_buffers()
   maxrecv = BUFMIN;
   memory->create(buf_recv,maxrecv,"comm:buf_recv");
 
+  nstage = istage = 0;
+  buf_stage[0] = buf_stage[1] = NULL;
+  maxstage[0] = maxstage[1] = 0;
+  nstage_request = 0;
+
+  npersist = 0;
+  persist_forward_send = persist_forward_recv = NULL;
+  persist_reverse_send = persist_reverse_recv = NULL;
+  persist_x = persist_f = NULL;
+  buf_persist = NULL;
+  maxpersist = 0;
+
   nswap = 0;
   maxswap = 6;
   allocate_swap(maxswap);
@@ -467,6 +485,31 @@ void CommBrick::forward_comm(int /*dummy*/)
   double **x = atom->x;
   double *buf;
 
+  // use persistent requests created by borders() if requested
+  // recreate them if x or f were reallocated since
+
+  if (persistent && comm_x_only) {
+    if (npersist != nswap || persist_x != x || persist_f != atom->f)
+      persist_setup();
+    for (int iswap = 0; iswap < nswap; iswap++) {
+      if (sendproc[iswap] != me) {
+        if (size_forward_recv[iswap])
+          MPI_Start(&persist_forward_recv[iswap]);
+        if (sendnum[iswap]) {
+          avec->pack_comm(sendnum[iswap],sendlist[iswap],
+                          buf_persist,pbc_flag[iswap],pbc[iswap]);
+          MPI_Start(&persist_forward_send[iswap]);
+          MPI_Wait(&persist_forward_send[iswap],MPI_STATUS_IGNORE);
+        }
+        if (size_forward_recv[iswap])
+          MPI_Wait(&persist_forward_recv[iswap],MPI_STATUS_IGNORE);
+      } else if (sendnum[iswap])
+        avec->pack_comm(sendnum[iswap],sendlist[iswap],
+                        x[firstrecv[iswap]],pbc_flag[iswap],pbc[iswap]);
+    }
+    return;
+  }
+
   // exchange data with another proc
   // if other proc is self, just copy
   // if comm_x_only set, exchange or copy directly to x, don't unpack
@@ -534,6 +577,31 @@ void CommBrick::reverse_comm()
   double **f = atom->f;
   double *buf;
 
+  // use persistent requests created by borders() if requested
+  // recreate them if x or f were reallocated since
+
+  if (persistent && comm_f_only) {
+    if (npersist != nswap || persist_x != atom->x || persist_f != f)
+      persist_setup();
+    for (int iswap = nswap-1; iswap >= 0; iswap--) {
+      if (sendproc[iswap] != me) {
+        if (size_reverse_recv[iswap])
+          MPI_Start(&persist_reverse_recv[iswap]);
+        if (size_reverse_send[iswap]) {
+          MPI_Start(&persist_reverse_send[iswap]);
+          MPI_Wait(&persist_reverse_send[iswap],MPI_STATUS_IGNORE);
+        }
+        if (size_reverse_recv[iswap]) {
+          MPI_Wait(&persist_reverse_recv[iswap],MPI_STATUS_IGNORE);
+          avec->unpack_reverse(sendnum[iswap],sendlist[iswap],buf_persist);
+        }
+      } else if (sendnum[iswap])
+        avec->unpack_reverse(sendnum[iswap],sendlist[iswap],
+                             f[firstrecv[iswap]]);
+    }
+    return;
+  }
+
   // exchange data with another proc
   // if other proc is self, just copy
   // if comm_f_only set, exchange or copy directly from f, don't pack
@@ -573,6 +641,245 @@ void CommBrick::reverse_comm()
   }
 }
 
+/* ----------------------------------------------------------------------
+   staged forward communication of atom coords
+   swaps 2k and 2k+1 only send atoms that existed before swap 2k,
+     so each such pair of swaps is one stage that can be in flight at once,
+     while later stages depend on ghost atoms received in earlier stages
+   caller can compute on owned atoms between begin() and next() calls,
+     but must not use ghost coords until next() returns 0
+   only staged if comm_modify overlap is set and only x is communicated,
+     else entire comm is done by begin()
+   staged swaps use their own buffers and tags, so that comm performed
+     by the overlapped computation cannot interfere with them
+------------------------------------------------------------------------- */
+
+int CommBrick::forward_comm_begin()
+{
+  if (!overlap || !comm_x_only || nswap == 0) {
+    forward_comm();
+    return 0;
+  }
+
+  nstage = nswap/2;
+  istage = 0;
+  forward_stage_post(istage);
+  return nstage;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int CommBrick::forward_comm_next()
+{
+  stage_wait();
+  istage++;
+  if (istage == nstage) return 0;
+  forward_stage_post(istage);
+  return nstage - istage;
+}
+
+/* ----------------------------------------------------------------------
+   post both swaps of one stage of forward comm
+   recv directly into x, copy directly into x if other proc is self
+------------------------------------------------------------------------- */
+
+void CommBrick::forward_stage_post(int stage)
+{
+  int n;
+  AtomVec *avec = atom->avec;
+  double **x = atom->x;
+  double *buf;
+
+  for (int iswap = 2*stage; iswap < 2*stage+2; iswap++) {
+    int m = iswap % 2;
+    if (sendproc[iswap] != me) {
+      if (size_forward_recv[iswap])
+        MPI_Irecv(x[firstrecv[iswap]],size_forward_recv[iswap],MPI_DOUBLE,
+                  recvproc[iswap],STAGETAG+m,world,
+                  &stage_request[nstage_request++]);
+      buf = grow_stage(m,sendnum[iswap]*size_forward);
+      n = avec->pack_comm(sendnum[iswap],sendlist[iswap],
+                          buf,pbc_flag[iswap],pbc[iswap]);
+      if (n) MPI_Isend(buf,n,MPI_DOUBLE,sendproc[iswap],STAGETAG+m,world,
+                       &stage_request[nstage_request++]);
+    } else if (sendnum[iswap])
+      avec->pack_comm(sendnum[iswap],sendlist[iswap],
+                      x[firstrecv[iswap]],pbc_flag[iswap],pbc[iswap]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   staged reverse communication of forces
+   stages are the same swap pairs as in forward_comm_begin(), in reverse
+   caller can compute forces on owned atoms between begin() and next() calls,
+     but must not change ghost forces after begin()
+   only staged if comm_modify overlap is set and only f is communicated,
+     else entire comm is done by begin()
+------------------------------------------------------------------------- */
+
+int CommBrick::reverse_comm_begin()
+{
+  if (!overlap || !comm_f_only || nswap == 0) {
+    reverse_comm();
+    return 0;
+  }
+
+  nstage = nswap/2;
+  istage = 0;
+  reverse_stage_post(nstage-1);
+  return nstage;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int CommBrick::reverse_comm_next()
+{
+  int stage = nstage-1 - istage;
+  stage_wait();
+
+  // sum received forces into atoms in my sendlists
+
+  AtomVec *avec = atom->avec;
+  for (int iswap = 2*stage+1; iswap >= 2*stage; iswap--)
+    if (sendproc[iswap] != me && size_reverse_recv[iswap])
+      avec->unpack_reverse(sendnum[iswap],sendlist[iswap],
+                           buf_stage[iswap % 2]);
+
+  istage++;
+  if (istage == nstage) return 0;
+  reverse_stage_post(nstage-1 - istage);
+  return nstage - istage;
+}
+
+/* ----------------------------------------------------------------------
+   post both swaps of one stage of reverse comm
+   send directly from f, sum directly from f if other proc is self
+------------------------------------------------------------------------- */
+
+void CommBrick::reverse_stage_post(int stage)
+{
+  AtomVec *avec = atom->avec;
+  double **f = atom->f;
+  double *buf;
+
+  for (int iswap = 2*stage+1; iswap >= 2*stage; iswap--) {
+    int m = iswap % 2;
+    if (sendproc[iswap] != me) {
+      if (size_reverse_recv[iswap]) {
+        buf = grow_stage(m,size_reverse_recv[iswap]);
+        MPI_Irecv(buf,size_reverse_recv[iswap],MPI_DOUBLE,
+                  sendproc[iswap],STAGETAG+m,world,
+                  &stage_request[nstage_request++]);
+      }
+      if (size_reverse_send[iswap])
+        MPI_Isend(f[firstrecv[iswap]],size_reverse_send[iswap],MPI_DOUBLE,
+                  recvproc[iswap],STAGETAG+m,world,
+                  &stage_request[nstage_request++]);
+    } else if (sendnum[iswap])
+      avec->unpack_reverse(sendnum[iswap],sendlist[iswap],
+                           f[firstrecv[iswap]]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   wait on all outstanding requests of current stage
+------------------------------------------------------------------------- */
+
+void CommBrick::stage_wait()
+{
+  if (nstage_request)
+    MPI_Waitall(nstage_request,stage_request,MPI_STATUS_IGNORE);
+  nstage_request = 0;
+}
+
+/* ----------------------------------------------------------------------
+   create persistent requests for forward comm of x and reverse comm of f
+   called by borders() since swap pattern is fixed until next borders(),
+     also by forward/reverse comm if x or f have been reallocated
+   recv directly into x and send directly from f as non-persistent comm does,
+     packed coords and received forces of all swaps use buf_persist
+------------------------------------------------------------------------- */
+
+void CommBrick::persist_setup()
+{
+  int iswap;
+
+  persist_free();
+
+  int max = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    max = MAX(max,sendnum[iswap]*size_forward);
+    max = MAX(max,size_reverse_recv[iswap]);
+  }
+  if (max > maxpersist) {
+    maxpersist = static_cast<int> (BUFFACTOR * max);
+    memory->destroy(buf_persist);
+    memory->create(buf_persist,maxpersist,"comm:buf_persist");
+  }
+
+  memory->create(persist_forward_send,nswap,"comm:persist_forward_send");
+  memory->create(persist_forward_recv,nswap,"comm:persist_forward_recv");
+  memory->create(persist_reverse_send,nswap,"comm:persist_reverse_send");
+  memory->create(persist_reverse_recv,nswap,"comm:persist_reverse_recv");
+
+  double **x = atom->x;
+  double **f = atom->f;
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    persist_forward_send[iswap] = persist_forward_recv[iswap] =
+      MPI_REQUEST_NULL;
+    persist_reverse_send[iswap] = persist_reverse_recv[iswap] =
+      MPI_REQUEST_NULL;
+    if (sendproc[iswap] == me) continue;
+
+    if (comm_x_only) {
+      if (size_forward_recv[iswap])
+        MPI_Recv_init(x[firstrecv[iswap]],size_forward_recv[iswap],MPI_DOUBLE,
+                      recvproc[iswap],0,world,&persist_forward_recv[iswap]);
+      if (sendnum[iswap])
+        MPI_Send_init(buf_persist,sendnum[iswap]*size_forward,MPI_DOUBLE,
+                      sendproc[iswap],0,world,&persist_forward_send[iswap]);
+    }
+
+    if (comm_f_only) {
+      if (size_reverse_recv[iswap])
+        MPI_Recv_init(buf_persist,size_reverse_recv[iswap],MPI_DOUBLE,
+                      sendproc[iswap],0,world,&persist_reverse_recv[iswap]);
+      if (size_reverse_send[iswap])
+        MPI_Send_init(f[firstrecv[iswap]],size_reverse_send[iswap],MPI_DOUBLE,
+                      recvproc[iswap],0,world,&persist_reverse_send[iswap]);
+    }
+  }
+
+  npersist = nswap;
+  persist_x = x;
+  persist_f = f;
+}
+
+/* ----------------------------------------------------------------------
+   free all persistent requests, none of them are active
+------------------------------------------------------------------------- */
+
+void CommBrick::persist_free()
+{
+  for (int iswap = 0; iswap < npersist; iswap++) {
+    if (persist_forward_send[iswap] != MPI_REQUEST_NULL)
+      MPI_Request_free(&persist_forward_send[iswap]);
+    if (persist_forward_recv[iswap] != MPI_REQUEST_NULL)
+      MPI_Request_free(&persist_forward_recv[iswap]);
+    if (persist_reverse_send[iswap] != MPI_REQUEST_NULL)
+      MPI_Request_free(&persist_reverse_send[iswap]);
+    if (persist_reverse_recv[iswap] != MPI_REQUEST_NULL)
+      MPI_Request_free(&persist_reverse_recv[iswap]);
+  }
+
+  memory->destroy(persist_forward_send);
+  memory->destroy(persist_forward_recv);
+  memory->destroy(persist_reverse_send);
+  memory->destroy(persist_reverse_recv);
+  npersist = 0;
+}
+
 /* ----------------------------------------------------------------------
    exchange: move atoms to correct processors
    atoms exchanged with all 6 stencil neighbors
@@ -873,6 +1180,11 @@ void CommBrick::borders()
   max = MAX(maxforward*rmax,maxreverse*smax);
   if (max > maxrecv) grow_recv(max);
 
+  // swap pattern is now fixed until next borders()
+  // so create persistent requests for forward/reverse comm if requested
+
+  if (persistent) persist_setup();
+
   // reset global->local map
 
   if (map_style) atom->map_set();
@@ -1378,6 +1690,21 @@ void CommBrick::grow_recv(int n)
   memory->create(buf_recv,maxrecv,"comm:buf_recv");
 }
 
+/* ----------------------------------------------------------------------
+   return staged comm buffer M with room for at least N datums
+   realloc with BUFFACTOR if needed, no need to preserve contents
+------------------------------------------------------------------------- */
+
+double *CommBrick::grow_stage(int m, int n)
+{
+  if (n > maxstage[m]) {
+    maxstage[m] = static_cast<int> (BUFFACTOR * n);
+    memory->destroy(buf_stage[m]);
+    memory->create(buf_stage[m],maxstage[m],"comm:buf_stage");
+  }
+  return buf_stage[m];
+}
+
 /* ----------------------------------------------------------------------
    realloc the size of the iswap sendlist as needed with BUFFACTOR
 ------------------------------------------------------------------------- */
@@ -1513,5 +1840,8 @@ bigint CommBrick::memory_usage()
     bytes += memory->usage(sendlist[i],maxsendlist[i]);
   bytes += memory->usage(buf_send,maxsend+bufextra);
   bytes += memory->usage(buf_recv,maxrecv);
+  bytes += memory->usage(buf_stage[0],maxstage[0]);
+  bytes += memory->usage(buf_stage[1],maxstage[1]);
+  bytes += memory->usage(buf_persist,maxpersist);
   return bytes;
 }
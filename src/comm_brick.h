@@ -31,6 +31,11 @@ class CommBrick : public Comm {
   virtual void exchange();                     // move atoms to new procs
   virtual void borders();                      // setup list of atoms to comm
 
+  virtual int forward_comm_begin();            // staged forward comm
+  virtual int forward_comm_next();
+  virtual int reverse_comm_begin();            // staged reverse comm
+  virtual int reverse_comm_next();
+
   virtual void forward_comm_pair(class Pair *);    // forward comm from a Pair
   virtual void reverse_comm_pair(class Pair *);    // reverse comm from a Pair
   virtual void forward_comm_fix(class Fix *, int size=0);
@@ -77,6 +82,20 @@ class CommBrick : public Comm {
   int bufextra;                     // extra space beyond maxsend in send buffer
   int smax,rmax;             // max size in atoms of single borders send/recv
 
+  int nstage,istage;                // # of stages, current stage of staged comm
+  int nstage_request;               // # of requests of current stage
+  MPI_Request stage_request[4];     // outstanding requests of current stage
+  double *buf_stage[2];             // send/recv buffers for staged comm
+  int maxstage[2];                  // current size of staged comm buffers
+
+  int npersist;                     // # of swaps with persistent requests
+  MPI_Request *persist_forward_send,*persist_forward_recv;
+  MPI_Request *persist_reverse_send,*persist_reverse_recv;
+                                    // persistent requests for each swap
+  double **persist_x,**persist_f;   // x,f arrays requests were created for
+  double *buf_persist;              // send/recv buffer for persistent comm
+  int maxpersist;                   // current size of buf_persist
+
   // NOTE: init_buffers is called from a constructor and must not be made virtual
   void init_buffers();
 
@@ -90,6 +109,13 @@ class CommBrick : public Comm {
   virtual void allocate_multi(int);         // allocate multi arrays
   virtual void free_swap();                 // free swap arrays
   virtual void free_multi();                // free multi arrays
+
+  void forward_stage_post(int);             // post swaps of one comm stage
+  void reverse_stage_post(int);
+  void stage_wait();                        // complete swaps of one stage
+  void persist_setup();                     // create persistent requests
+  void persist_free();                      // free persistent requests
+  double *grow_stage(int, int);             // reallocate staged comm buffer
 };
 
 }
@@ -32,6 +32,7 @@
 #include "error.h"
 
 #include "group.h"
+#include "cluster_merge.h"
 
 using namespace LAMMPS_NS;
 
@@ -39,7 +40,7 @@ using namespace LAMMPS_NS;
 
 ComputeAggregateAtom::ComputeAggregateAtom(LAMMPS *lmp, int narg, char **arg) :
   Compute(lmp, narg, arg),
-  aggregateID(NULL)
+  aggregateID(NULL), merge(NULL)
 {
   if (narg != 4) error->all(FLERR,"Illegal compute aggregate/atom command");
 
@@ -52,9 +53,10 @@ ComputeAggregateAtom::ComputeAggregateAtom(LAMMPS *lmp, int narg, char **arg) :
   peratom_flag = 1;
   size_peratom_cols = 0;
   comm_forward = 1;
-  comm_reverse = 1;
 
   nmax = 0;
+
+  merge = new ClusterMerge(lmp);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -62,6 +64,7 @@ ComputeAggregateAtom::ComputeAggregateAtom(LAMMPS *lmp, int narg, char **arg) :
 ComputeAggregateAtom::~ComputeAggregateAtom()
 {
   memory->destroy(aggregateID);
+  delete merge;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -133,11 +136,13 @@ void ComputeAggregateAtom::compute_peratom()
     comm->forward_comm_compute(this);
   }
 
-  // each atom starts in its own aggregate,
+  // each atom starts in its own aggregate
+  // join bonded atoms in group on this proc
+  // then join atoms in group within cutoff of each other on this proc
+  // on-processor aggregateID = lowest atomID in on-processor aggregate
 
   int nlocal = atom->nlocal;
   int inum = list->inum;
-  tagint *tag = atom->tag;
   int *mask = atom->mask;
   int *num_bond = atom->num_bond;
   int **bond_type = atom->bond_type;
@@ -147,85 +152,53 @@ void ComputeAggregateAtom::compute_peratom()
   int **firstneigh = list->firstneigh;
   double **x = atom->x;
 
-  for (i = 0; i < nlocal + atom->nghost; i++)
-    if (mask[i] & groupbit) aggregateID[i] = tag[i];
-    else aggregateID[i] = 0;
+  merge->reset(mask,groupbit);
 
-  // loop until no more changes on any proc:
-  // acquire aggregateIDs of ghost atoms
-  // loop over my atoms, and check atoms bound to it
-  // if both atoms are in aggregate, assign lowest aggregateID to both
-  // then loop over my atoms, checking distance to neighbors
-  // if both atoms are in cluster, assign lowest clusterID to both
-  // iterate until no changes in my atoms
-  // then check if any proc made changes
+  for (i = 0; i < nlocal; i++) {
+    if (!(mask[i] & groupbit)) continue;
 
-  commflag = 1;
+    for (j = 0; j < num_bond[i]; j++) {
+      if (bond_type[i][j] == 0) continue;
+      k = atom->map(bond_atom[i][j]);
+      if (k < 0) continue;
+      if (!(mask[k] & groupbit)) continue;
+      merge->join(i,k);
+    }
+  }
 
-  int change,done,anychange;
+  for (int ii = 0; ii < inum; ii++) {
+    i = ilist[ii];
+    if (!(mask[i] & groupbit)) continue;
+
+    const double xtmp = x[i][0];
+    const double ytmp = x[i][1];
+    const double ztmp = x[i][2];
+    int *jlist = firstneigh[i];
+    const int jnum = numneigh[i];
+
+    for (int jj = 0; jj < jnum; jj++) {
+      j = jlist[jj];
+      j &= NEIGHMASK;
+      if (!(mask[j] & groupbit)) continue;
+
+      const double delx = xtmp - x[j][0];
+      const double dely = ytmp - x[j][1];
+      const double delz = ztmp - x[j][2];
+      const double rsq = delx*delx + dely*dely + delz*delz;
+      if (rsq < cutsq) merge->join(i,j);
+    }
+  }
 
-  while (1) {
-    comm->forward_comm_compute(this);
+  merge->local_ids(aggregateID);
 
-    // reverse communication when bonds are not stored on every processor
-
-    if (force->newton_bond)
-      comm->reverse_comm_compute(this);
-
-    change = 0;
-    while (1) {
-      done = 1;
-      for (i = 0; i < nlocal; i++) {
-        if (!(mask[i] & groupbit)) continue;
-
-        for (j = 0; j < num_bond[i]; j++) {
-          if (bond_type[i][j] == 0) continue;
-          k = atom->map(bond_atom[i][j]);
-          if (k < 0) continue;
-          if (!(mask[k] & groupbit)) continue;
-          if (aggregateID[i] == aggregateID[k]) continue;
-
-          aggregateID[i] = aggregateID[k] = MIN(aggregateID[i],aggregateID[k]);
-          done = 0;
-        }
-      }
-
-      for (int ii = 0; ii < inum; ii++) {
-        i = ilist[ii];
-        if (!(mask[i] & groupbit)) continue;
-
-        const double xtmp = x[i][0];
-        const double ytmp = x[i][1];
-        const double ztmp = x[i][2];
-        int *jlist = firstneigh[i];
-        const int jnum = numneigh[i];
-
-        for (int jj = 0; jj < jnum; jj++) {
-          j = jlist[jj];
-          j &= NEIGHMASK;
-          if (!(mask[j] & groupbit)) continue;
-          if (aggregateID[i] == aggregateID[j]) continue;
-
-          const double delx = xtmp - x[j][0];
-          const double dely = ytmp - x[j][1];
-          const double delz = ztmp - x[j][2];
-          const double rsq = delx*delx + dely*dely + delz*delz;
-          if (rsq < cutsq) {
-            aggregateID[i] = aggregateID[j]
-              = MIN(aggregateID[i],aggregateID[j]);
-            done = 0;
-          }
-        }
-      }
-      if (!done) change = 1;
-      if (done) break;
-    }
+  // acquire on-processor aggregateIDs of ghost atoms from their owners
+  // merge on-processor aggregates that span procs
+  // final aggregateID = lowest atomID in aggregate
 
-    // stop if all procs are done
+  commflag = 1;
+  comm->forward_comm_compute(this);
 
-    MPI_Allreduce(&change,&anychange,1,MPI_INT,MPI_MAX,world);
-    if (!anychange) break;
-  }
+  merge->global_ids(aggregateID);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -261,50 +234,13 @@ void ComputeAggregateAtom::unpack_forward_comm(int n, int first, double *buf)
   m = 0;
   last = first + n;
   if (commflag)
-    for (i = first; i < last; i++) {
-      double x = buf[m++];
-
-      // only overwrite ghost IDs with values lower than current ones
-
-      aggregateID[i] = MIN(x,aggregateID[i]);
-    }
+    for (i = first; i < last; i++) aggregateID[i] = buf[m++];
   else {
     int *mask = atom->mask;
     for (i = first; i < last; i++) mask[i] = (int) ubuf(buf[m++]).i;
   }
 }
 
-/* ---------------------------------------------------------------------- */
-
-int ComputeAggregateAtom::pack_reverse_comm(int n, int first, double *buf)
-{
-  int i,m,last;
-
-  m = 0;
-  last = first + n;
-  for (i = first; i < last; i++) {
-    buf[m++] = aggregateID[i];
-  }
-  return m;
-}
-
-/* ---------------------------------------------------------------------- */
-
-void ComputeAggregateAtom::unpack_reverse_comm(int n, int *list, double *buf)
-{
-  int i,j,m;
-
-  m = 0;
-  for (i = 0; i < n; i++) {
-    j = list[i];
-    double x = buf[m++];
-
-    // only overwrite local IDs with values lower than current ones
-
-    aggregateID[j] = MIN(x,aggregateID[j]);
-  }
-}
-
 /* ----------------------------------------------------------------------
    memory usage of local atom-based array
 ------------------------------------------------------------------------- */
@@ -312,5 +248,6 @@ void ComputeAggregateAtom::unpack_reverse_comm(int n, int *list, double *buf)
 double ComputeAggregateAtom::memory_usage()
 {
   double bytes = nmax * sizeof(double);
+  bytes += merge->memory_usage();
   return bytes;
 }
@@ -33,8 +33,6 @@ class ComputeAggregateAtom : public Compute {
   void compute_peratom();
   int pack_forward_comm(int, int *, double *, int, int *);
   void unpack_forward_comm(int, int, double *);
-  int pack_reverse_comm(int, int, double *);
-  void unpack_reverse_comm(int, int *, double *);
   double memory_usage();
 
  private:
@@ -42,6 +40,7 @@ class ComputeAggregateAtom : public Compute {
   double cutsq;
   class NeighList *list;
   double *aggregateID;
+  class ClusterMerge *merge;
 };
 
 }
@@ -33,8 +33,6 @@
 #include "memory.h"
 #include "error.h"
 
-#include <map>
-
 using namespace LAMMPS_NS;
 using namespace MathConst;
 
@@ -46,7 +44,7 @@ enum{NODISCARD,MIXED,YESDISCARD};
 enum{ONCE,NFREQ,EVERY};              // used in several files
 enum{LIMITMAX,LIMITEXACT};
 
-#define IDMAX 1024*1024
+#define RVOUS 1   // 0 for irregular, 1 for all2all
 #define INVOKED_PERATOM 8
 
 /* ---------------------------------------------------------------------- */
@@ -56,7 +54,7 @@ ComputeChunkAtom::ComputeChunkAtom(LAMMPS *lmp, int narg, char **arg) :
   chunk_volume_vec(NULL), coord(NULL), ichunk(NULL), chunkID(NULL),
   cfvid(NULL), idregion(NULL), region(NULL), cchunk(NULL), fchunk(NULL),
   varatom(NULL), id_fix(NULL), fixstore(NULL), lockfix(NULL), chunk(NULL),
-  exclude(NULL), hash(NULL)
+  exclude(NULL), idown(NULL)
 {
   if (narg < 4) error->all(FLERR,"Illegal compute chunk/atom command");
 
@@ -470,8 +468,9 @@ ComputeChunkAtom::ComputeChunkAtom(LAMMPS *lmp, int narg, char **arg) :
   id_fix = NULL;
   fixstore = NULL;
 
-  if (compress) hash = new std::map<tagint,int>();
-  else hash = NULL;
+  nchunkID = 0;
+  nown = 0;
+  idown = NULL;
 
   maxvar = 0;
   varatom = NULL;
@@ -501,7 +500,7 @@ ComputeChunkAtom::~ComputeChunkAtom()
 
   delete [] idregion;
   delete [] cfvid;
-  delete hash;
+  memory->destroy(idown);
 
   memory->destroy(varatom);
 }
@@ -721,29 +720,33 @@ void ComputeChunkAtom::compute_ichunk()
 
   invoked_ichunk = update->ntimestep;
 
-  // compress chunk IDs via hash of the original uncompressed IDs
+  // compress chunk IDs via sorted list of the original uncompressed IDs
   // also apply discard rule except for binning styles which already did
 
   int nlocal = atom->nlocal;
 
   if (compress) {
+    int id;
     if (binflag) {
       for (i = 0; i < nlocal; i++) {
         if (exclude[i]) continue;
-        if (hash->find(ichunk[i]) == hash->end()) exclude[i] = 1;
-        else ichunk[i] = hash->find(ichunk[i])->second;
+        id = compressed_id(ichunk[i]);
+        if (id == 0) exclude[i] = 1;
+        else ichunk[i] = id;
       }
     } else if (discard == NODISCARD) {
       for (i = 0; i < nlocal; i++) {
         if (exclude[i]) continue;
-        if (hash->find(ichunk[i]) == hash->end()) ichunk[i] = nchunk;
-        else ichunk[i] = hash->find(ichunk[i])->second;
+        id = compressed_id(ichunk[i]);
+        if (id == 0) ichunk[i] = nchunk;
+        else ichunk[i] = id;
       }
     } else {
       for (i = 0; i < nlocal; i++) {
         if (exclude[i]) continue;
-        if (hash->find(ichunk[i]) == hash->end()) exclude[i] = 1;
-        else ichunk[i] = hash->find(ichunk[i])->second;
+        id = compressed_id(ichunk[i]);
+        if (id == 0) exclude[i] = 1;
+        else ichunk[i] = id;
       }
     }
 
@@ -1010,9 +1013,10 @@ void ComputeChunkAtom::assign_chunk_ids()
    current assignment excludes atoms not in group or in optional region
    current Nchunk = max ID
    operation:
-     use hash to store list of populated IDs that I own
-     add new IDs to populated lists communicated from all other procs
-     final hash has global list of populated ideas
+     each proc owns a contiguous range of original IDs
+     send my unique populated IDs to their owners via rendezvous comm
+     each owner keeps a sorted list of unique IDs in its range
+     allgather the owner lists, which are then in ascending order
    reset Nchunk = length of global list
    called by setup_chunks() when setting Nchunk
    remapping of chunk IDs to smaller Nchunk occurs later in compute_ichunk()
@@ -1020,109 +1024,143 @@ void ComputeChunkAtom::assign_chunk_ids()
 
 void ComputeChunkAtom::compress_chunk_ids()
 {
-  hash->clear();
+  int i;
 
-  // put my IDs into hash
+  // create sorted list of my unique populated IDs
 
   int nlocal = atom->nlocal;
-  for (int i = 0; i < nlocal; i++) {
-    if (exclude[i]) continue;
-    if (hash->find(ichunk[i]) == hash->end()) (*hash)[ichunk[i]] = 0;
-  }
+  int *list;
+  memory->create(list,nlocal,"chunk/atom:list");
 
-  // n = # of my populated IDs
-  // nall = n summed across all procs
+  int n = 0;
+  for (i = 0; i < nlocal; i++)
+    if (!exclude[i]) list[n++] = ichunk[i];
+  n = unique_ids(list,n);
 
-  int n = hash->size();
-  bigint nbone = n;
-  bigint nball;
-  MPI_Allreduce(&nbone,&nball,1,MPI_LMP_BIGINT,MPI_SUM,world);
+  // range of original IDs across all procs
 
-  // create my list of populated IDs
+  int lohi[2],lohiall[2];
+  lohi[0] = n ? -list[0] : -MAXSMALLINT;
+  lohi[1] = n ? list[n-1] : -MAXSMALLINT;
+  MPI_Allreduce(lohi,lohiall,2,MPI_INT,MPI_MAX,world);
+  bigint idlo = -lohiall[0];
+  bigint nrange = (bigint) lohiall[1] - idlo + 1;
 
-  int *list = NULL;
-  memory->create(list,n,"chunk/atom:list");
+  // each proc owns every contiguous 1/Pth of the range
 
-  n = 0;
-  std::map<tagint,int>::iterator pos;
-  for (pos = hash->begin(); pos != hash->end(); ++pos)
-    list[n++] = pos->first;
+  int nprocs = comm->nprocs;
+  int *proclist;
+  memory->create(proclist,n,"chunk/atom:proclist");
 
-  // if nall < 1M, just allgather all ID lists on every proc
-  // else perform ring comm
-  // add IDs from all procs to my hash
+  for (i = 0; i < n; i++)
+    proclist[i] = static_cast<int> ((list[i] - idlo) * nprocs / nrange);
 
-  if (nball <= IDMAX) {
+  // perform rendezvous operation
+  // callback stores sorted unique IDs of my range in idown
 
-    // setup for allgatherv
+  char *buf;
+  comm->rendezvous(RVOUS,n,(char *) list,sizeof(int),0,proclist,
+                   rendezvous_ids,0,buf,0,(void *) this);
 
-    int nprocs = comm->nprocs;
-    int nall = nball;
-    int *recvcounts,*displs,*listall;
-    memory->create(recvcounts,nprocs,"chunk/atom:recvcounts");
-    memory->create(displs,nprocs,"chunk/atom:displs");
-    memory->create(listall,nall,"chunk/atom:listall");
+  memory->destroy(proclist);
+  memory->destroy(list);
 
-    MPI_Allgather(&n,1,MPI_INT,recvcounts,1,MPI_INT,world);
+  // nchunk = # of populated IDs across all procs
 
-    displs[0] = 0;
-    for (int iproc = 1; iproc < nprocs; iproc++)
-      displs[iproc] = displs[iproc-1] + recvcounts[iproc-1];
+  int *recvcounts,*displs;
+  memory->create(recvcounts,nprocs,"chunk/atom:recvcounts");
+  memory->create(displs,nprocs,"chunk/atom:displs");
 
-    // allgatherv acquires list of populated IDs from all procs
+  MPI_Allgather(&nown,1,MPI_INT,recvcounts,1,MPI_INT,world);
 
-    MPI_Allgatherv(list,n,MPI_INT,listall,recvcounts,displs,MPI_INT,world);
+  displs[0] = 0;
+  for (int iproc = 1; iproc < nprocs; iproc++)
+    displs[iproc] = displs[iproc-1] + recvcounts[iproc-1];
+  nchunk = displs[nprocs-1] + recvcounts[nprocs-1];
 
-    // add all unique IDs in listall to my hash
+  // chunkID = list of original chunk IDs in ascending order
+  //   index into chunkID + 1 = new compressed chunk ID (1 to Nchunk)
+  //   used by fix ave/chunk and compute property/chunk
 
-    for (int i = 0; i < nall; i++)
-      if (hash->find(listall[i]) == hash->end()) (*hash)[listall[i]] = 0;
+  memory->destroy(chunkID);
+  memory->create(chunkID,nchunk,"chunk/atom:chunkID");
+  nchunkID = nchunk;
 
-    // clean up
+  MPI_Allgatherv(idown,nown,MPI_INT,chunkID,recvcounts,displs,MPI_INT,world);
 
-    memory->destroy(recvcounts);
-    memory->destroy(displs);
-    memory->destroy(listall);
+  memory->destroy(recvcounts);
+  memory->destroy(displs);
+  memory->destroy(idown);
+  nown = 0;
+}
 
-  } else {
-    comm->ring(n,sizeof(int),list,1,idring,NULL,(void *)this,0);
-  }
+/* ----------------------------------------------------------------------
+   callback from rendezvous operation
+   inbuf = list of N populated chunk IDs in the range owned by this proc
+   store the sorted unique IDs in idown, no datums are returned
+------------------------------------------------------------------------- */
 
-  memory->destroy(list);
+int ComputeChunkAtom::rendezvous_ids(int n, char *inbuf,
+                                     int &flag, int *& /*proclist*/,
+                                     char *& /*outbuf*/, void *ptr)
+{
+  ComputeChunkAtom *cptr = (ComputeChunkAtom *) ptr;
+  Memory *memory = cptr->memory;
 
-  // nchunk = length of hash containing populated IDs from all procs
+  memory->destroy(cptr->idown);
+  memory->create(cptr->idown,n,"chunk/atom:idown");
+  if (n) memcpy(cptr->idown,inbuf,n*sizeof(int));
+  cptr->nown = cptr->unique_ids(cptr->idown,n);
 
-  nchunk = hash->size();
+  flag = 0;
+  return 0;
+}
 
-  // reset hash value of each original chunk ID to ordered index
-  //   ordered index = new compressed chunk ID (1 to Nchunk)
-  //   leverages fact that map stores keys in ascending order
-  // also allocate and set chunkID = list of original chunk IDs
-  //   used by fix ave/chunk and compute property/chunk
+/* ----------------------------------------------------------------------
+   sort list of N chunk IDs and remove duplicates
+   return # of unique IDs, which are stored at start of list
+------------------------------------------------------------------------- */
 
-  memory->destroy(chunkID);
-  memory->create(chunkID,nchunk,"chunk/atom:chunkID");
+int ComputeChunkAtom::unique_ids(int *list, int n)
+{
+  if (n == 0) return 0;
+  qsort(list,n,sizeof(int),compare_ids);
+
+  int m = 1;
+  for (int i = 1; i < n; i++)
+    if (list[i] != list[m-1]) list[m++] = list[i];
+  return m;
+}
 
-  n = 0;
-  for (pos = hash->begin(); pos != hash->end(); ++pos) {
-    chunkID[n] = pos->first;
-    (*hash)[pos->first] = ++n;
+/* ----------------------------------------------------------------------
+   compressed chunk ID of an original chunk ID, via binary search of chunkID
+   return 0 if original ID is not populated
+------------------------------------------------------------------------- */
+
+int ComputeChunkAtom::compressed_id(int id)
+{
+  int lo = 0;
+  int hi = nchunkID-1;
+  while (lo <= hi) {
+    int mid = (lo+hi) / 2;
+    if (chunkID[mid] < id) lo = mid+1;
+    else if (chunkID[mid] > id) hi = mid-1;
+    else return mid+1;
   }
+  return 0;
 }
 
 /* ----------------------------------------------------------------------
-   callback from comm->ring()
-   cbuf = list of N chunk IDs from another proc
-   loop over the list, add each to my hash
-   hash ends up storing all unique IDs across all procs
+   comparison function invoked by qsort() on chunk IDs
 ------------------------------------------------------------------------- */
 
-void ComputeChunkAtom::idring(int n, char *cbuf, void *ptr)
+int ComputeChunkAtom::compare_ids(const void *iptr, const void *jptr)
 {
-  ComputeChunkAtom *cptr = (ComputeChunkAtom *)ptr;
-  tagint *list = (tagint *) cbuf;
-  std::map<tagint,int> *hash = cptr->hash;
-  for (int i = 0; i < n; i++) (*hash)[list[i]] = 0;
+  int i = *((const int *) iptr);
+  int j = *((const int *) jptr);
+  if (i < j) return -1;
+  if (i > j) return 1;
+  return 0;
 }
 
 /* ----------------------------------------------------------------------
@@ -1151,7 +1189,7 @@ void ComputeChunkAtom::check_molecules()
     int molid;
     for (int i = 0; i < nlocal; i++) {
       molid = static_cast<int> (molecule[i]);
-      if (hash->find(molid) != hash->end() && ichunk[i] == 0) flag = 1;
+      if (compressed_id(molid) && ichunk[i] == 0) flag = 1;
     }
   }
 
@@ -21,7 +21,6 @@ ComputeStyle(chunk/atom,ComputeChunkAtom)
 #define LMP_COMPUTE_CHUNK_ATOM_H
 
 #include "compute.h"
-#include <map>
 
 namespace LAMMPS_NS {
 
@@ -105,14 +104,22 @@ class ComputeChunkAtom : public Compute {
 
   int molcheck;              // one-time check if all molecule atoms in chunk
   int *exclude;              // 1 if atom is not assigned to any chunk
-  std::map<tagint,int> *hash;   // store original chunks IDs before compression
+  int nchunkID;              // length of chunkID list of original IDs
+  int nown;                  // # of original IDs in idown
+  int *idown;                // populated original IDs in range I own
 
-  // callback function for ring communication
+  // callback function for rendezvous communication
 
-  static void idring(int, char *, void *);
+  static int rendezvous_ids(int, char *, int &, int *&, char *&, void *);
+
+  // comparison function for sorting chunk IDs
+
+  static int compare_ids(const void *, const void *);
 
   void assign_chunk_ids();
   void compress_chunk_ids();
+  int unique_ids(int *, int);
+  int compressed_id(int);
   void check_molecules();
   int setup_xyz_bins();
   int setup_sphere_bins();
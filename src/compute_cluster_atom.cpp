@@ -28,6 +28,7 @@
 #include "error.h"
 
 #include "group.h"
+#include "cluster_merge.h"
 
 using namespace LAMMPS_NS;
 
@@ -37,7 +38,7 @@ enum{CLUSTER,MASK,COORDS};
 
 ComputeClusterAtom::ComputeClusterAtom(LAMMPS *lmp, int narg, char **arg) :
   Compute(lmp, narg, arg),
-  clusterID(NULL)
+  clusterID(NULL), merge(NULL)
 {
   if (narg != 4) error->all(FLERR,"Illegal compute cluster/atom command");
 
@@ -49,6 +50,8 @@ ComputeClusterAtom::ComputeClusterAtom(LAMMPS *lmp, int narg, char **arg) :
   comm_forward = 3;
 
   nmax = 0;
+
+  merge = new ClusterMerge(lmp);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -56,6 +59,7 @@ ComputeClusterAtom::ComputeClusterAtom(LAMMPS *lmp, int narg, char **arg) :
 ComputeClusterAtom::~ComputeClusterAtom()
 {
   memory->destroy(clusterID);
+  delete merge;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -140,70 +144,48 @@ void ComputeClusterAtom::compute_peratom()
     comm->forward_comm_compute(this);
   }
 
-  // every atom starts in its own cluster, with clusterID = atomID
+  // every atom starts in its own cluster
+  // join atoms in group within cutoff of each other on this proc
+  // on-processor clusterID = lowest atomID in on-processor cluster
 
-  tagint *tag = atom->tag;
   int *mask = atom->mask;
+  double **x = atom->x;
+
+  merge->reset(mask,groupbit);
 
   for (ii = 0; ii < inum; ii++) {
     i = ilist[ii];
-    if (mask[i] & groupbit) clusterID[i] = tag[i];
-    else clusterID[i] = 0;
+    if (!(mask[i] & groupbit)) continue;
+
+    xtmp = x[i][0];
+    ytmp = x[i][1];
+    ztmp = x[i][2];
+    jlist = firstneigh[i];
+    jnum = numneigh[i];
+
+    for (jj = 0; jj < jnum; jj++) {
+      j = jlist[jj];
+      j &= NEIGHMASK;
+      if (!(mask[j] & groupbit)) continue;
+
+      delx = xtmp - x[j][0];
+      dely = ytmp - x[j][1];
+      delz = ztmp - x[j][2];
+      rsq = delx*delx + dely*dely + delz*delz;
+      if (rsq < cutsq) merge->join(i,j);
+    }
   }
 
-  // loop until no more changes on any proc:
-  // acquire clusterIDs of ghost atoms
-  // loop over my atoms, checking distance to neighbors
-  // if both atoms are in cluster, assign lowest clusterID to both
-  // iterate until no changes in my atoms
-  // then check if any proc made changes
-
-  commflag = CLUSTER;
-  double **x = atom->x;
+  merge->local_ids(clusterID);
 
-  int change,done,anychange;
+  // acquire on-processor clusterIDs of ghost atoms from their owners
+  // merge on-processor clusters that span procs
+  // final clusterID = lowest atomID in cluster
 
-  while (1) {
-    comm->forward_comm_compute(this);
-
-    change = 0;
-    while (1) {
-      done = 1;
-      for (ii = 0; ii < inum; ii++) {
-        i = ilist[ii];
-        if (!(mask[i] & groupbit)) continue;
-
-        xtmp = x[i][0];
-        ytmp = x[i][1];
-        ztmp = x[i][2];
-        jlist = firstneigh[i];
-        jnum = numneigh[i];
-
-        for (jj = 0; jj < jnum; jj++) {
-          j = jlist[jj];
-          j &= NEIGHMASK;
-          if (!(mask[j] & groupbit)) continue;
-          if (clusterID[i] == clusterID[j]) continue;
-
-          delx = xtmp - x[j][0];
-          dely = ytmp - x[j][1];
-          delz = ztmp - x[j][2];
-          rsq = delx*delx + dely*dely + delz*delz;
-          if (rsq < cutsq) {
-            clusterID[i] = clusterID[j] = MIN(clusterID[i],clusterID[j]);
-            done = 0;
-          }
-        }
-      }
-      if (!done) change = 1;
-      if (done) break;
-    }
-
-    // stop if all procs are done
+  commflag = CLUSTER;
+  comm->forward_comm_compute(this);
 
-    MPI_Allreduce(&change,&anychange,1,MPI_INT,MPI_MAX,world);
-    if (!anychange) break;
-  }
+  merge->global_ids(clusterID);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -268,5 +250,6 @@ void ComputeClusterAtom::unpack_forward_comm(int n, int first, double *buf)
 double ComputeClusterAtom::memory_usage()
 {
   double bytes = nmax * sizeof(double);
+  bytes += merge->memory_usage();
   return bytes;
 }
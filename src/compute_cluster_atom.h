@@ -40,6 +40,7 @@ class ComputeClusterAtom : public Compute {
   double cutsq;
   class NeighList *list;
   double *clusterID;
+  class ClusterMerge *merge;
 };
 
 }
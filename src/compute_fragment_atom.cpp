@@ -27,6 +27,7 @@
 #include "error.h"
 
 #include "group.h"
+#include "cluster_merge.h"
 
 using namespace LAMMPS_NS;
 
@@ -34,7 +35,7 @@ using namespace LAMMPS_NS;
 
 ComputeFragmentAtom::ComputeFragmentAtom(LAMMPS *lmp, int narg, char **arg) :
   Compute(lmp, narg, arg),
-  fragmentID(NULL)
+  fragmentID(NULL), merge(NULL)
 {
   if (narg != 3) error->all(FLERR,"Illegal compute fragment/atom command");
 
@@ -44,9 +45,10 @@ ComputeFragmentAtom::ComputeFragmentAtom(LAMMPS *lmp, int narg, char **arg) :
   peratom_flag = 1;
   size_peratom_cols = 0;
   comm_forward = 1;
-  comm_reverse = 1;
 
   nmax = 0;
+
+  merge = new ClusterMerge(lmp);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -54,6 +56,7 @@ ComputeFragmentAtom::ComputeFragmentAtom(LAMMPS *lmp, int narg, char **arg) :
 ComputeFragmentAtom::~ComputeFragmentAtom()
 {
   memory->destroy(fragmentID);
+  delete merge;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -96,64 +99,40 @@ void ComputeFragmentAtom::compute_peratom()
     comm->forward_comm_compute(this);
   }
 
-  // each atom starts in its own fragment,
+  // each atom starts in its own fragment
+  // join bonded atoms in group on this proc
+  // on-processor fragmentID = lowest atomID in on-processor fragment
 
   int nlocal = atom->nlocal;
-  tagint *tag = atom->tag;
   int *mask = atom->mask;
   int *num_bond = atom->num_bond;
   int **bond_type = atom->bond_type;
   tagint **bond_atom = atom->bond_atom;
 
-  for (i = 0; i < nlocal + atom->nghost; i++)
-    if (mask[i] & groupbit) fragmentID[i] = tag[i];
-    else fragmentID[i] = 0;
+  merge->reset(mask,groupbit);
 
-  // loop until no more changes on any proc:
-  // acquire fragmentIDs of ghost atoms
-  // loop over my atoms, and check atoms bound to it
-  // if both atoms are in fragment, assign lowest fragmentID to both
-  // iterate until no changes in my atoms
-  // then check if any proc made changes
+  for (i = 0; i < nlocal; i++) {
+    if (!(mask[i] & groupbit)) continue;
 
-  commflag = 1;
+    for (j = 0; j < num_bond[i]; j++) {
+      if (bond_type[i][j] == 0) continue;
+      k = atom->map(bond_atom[i][j]);
+      if (k < 0) continue;
+      if (!(mask[k] & groupbit)) continue;
+      merge->join(i,k);
+    }
+  }
 
-  int change,done,anychange;
+  merge->local_ids(fragmentID);
 
-  while (1) {
-    comm->forward_comm_compute(this);
+  // acquire on-processor fragmentIDs of ghost atoms from their owners
+  // merge on-processor fragments that span procs
+  // final fragmentID = lowest atomID in fragment
 
-    // reverse communication when bonds are not stored on every processor
-
-    if (force->newton_bond)
-      comm->reverse_comm_compute(this);
-
-    change = 0;
-    while (1) {
-      done = 1;
-      for (i = 0; i < nlocal; i++) {
-        if (!(mask[i] & groupbit)) continue;
-
-        for (j = 0; j < num_bond[i]; j++) {
-          if (bond_type[i][j] == 0) continue;
-          k = atom->map(bond_atom[i][j]);
-          if (k < 0) continue;
-          if (!(mask[k] & groupbit)) continue;
-          if (fragmentID[i] == fragmentID[k]) continue;
-
-          fragmentID[i] = fragmentID[k] = MIN(fragmentID[i],fragmentID[k]);
-          done = 0;
-        }
-      }
-      if (!done) change = 1;
-      if (done) break;
-    }
-
-    // stop if all procs are done
+  commflag = 1;
+  comm->forward_comm_compute(this);
 
-    MPI_Allreduce(&change,&anychange,1,MPI_INT,MPI_MAX,world);
-    if (!anychange) break;
-  }
+  merge->global_ids(fragmentID);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -189,50 +168,13 @@ void ComputeFragmentAtom::unpack_forward_comm(int n, int first, double *buf)
   m = 0;
   last = first + n;
   if (commflag)
-    for (i = first; i < last; i++) {
-      double x = buf[m++];
-
-      // only overwrite ghost IDs with values lower than current ones
-
-      fragmentID[i] = MIN(x,fragmentID[i]);
-    }
+    for (i = first; i < last; i++) fragmentID[i] = buf[m++];
   else {
     int *mask = atom->mask;
     for (i = first; i < last; i++) mask[i] = (int) ubuf(buf[m++]).i;
   }
 }
 
-/* ---------------------------------------------------------------------- */
-
-int ComputeFragmentAtom::pack_reverse_comm(int n, int first, double *buf)
-{
-  int i,m,last;
-
-  m = 0;
-  last = first + n;
-  for (i = first; i < last; i++) {
-    buf[m++] = fragmentID[i];
-  }
-  return m;
-}
-
-/* ---------------------------------------------------------------------- */
-
-void ComputeFragmentAtom::unpack_reverse_comm(int n, int *list, double *buf)
-{
-  int i,j,m;
-
-  m = 0;
-  for (i = 0; i < n; i++) {
-    j = list[i];
-    double x = buf[m++];
-
-    // only overwrite local IDs with values lower than current ones
-
-    fragmentID[j] = MIN(x,fragmentID[j]);
-  }
-}
-
 /* ----------------------------------------------------------------------
    memory usage of local atom-based array
 ------------------------------------------------------------------------- */
@@ -240,5 +182,6 @@ void ComputeFragmentAtom::unpack_reverse_comm(int n, int *list, double *buf)
 double ComputeFragmentAtom::memory_usage()
 {
   double bytes = nmax * sizeof(double);
+  bytes += merge->memory_usage();
   return bytes;
 }
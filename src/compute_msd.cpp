@@ -11,6 +11,7 @@
    See the README file in the top-level LAMMPS directory.
 ------------------------------------------------------------------------- */
 
+#include <cstdio>
 #include <cstring>
 #include "compute_msd.h"
 #include "atom.h"
@@ -19,6 +20,9 @@
 #include "domain.h"
 #include "modify.h"
 #include "fix_store.h"
+#include "correlator.h"
+#include "force.h"
+#include "memory.h"
 #include "error.h"
 
 using namespace LAMMPS_NS;
@@ -27,7 +31,7 @@ using namespace LAMMPS_NS;
 
 ComputeMSD::ComputeMSD(LAMMPS *lmp, int narg, char **arg) :
   Compute(lmp, narg, arg),
-  id_fix(NULL)
+  id_fix(NULL), correlator(NULL)
 {
   if (narg < 3) error->all(FLERR,"Illegal compute msd command");
 
@@ -41,6 +45,7 @@ ComputeMSD::ComputeMSD(LAMMPS *lmp, int narg, char **arg) :
 
   comflag = 0;
   avflag = 0;
+  nlevel = 0;
 
   int iarg = 3;
   while (iarg < narg) {
@@ -56,9 +61,38 @@ ComputeMSD::ComputeMSD(LAMMPS *lmp, int narg, char **arg) :
       else if (strcmp(arg[iarg+1],"yes") == 0) avflag = 1;
       else error->all(FLERR,"Illegal compute msd command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"multitau") == 0) {
+      if (iarg+4 > narg) error->all(FLERR,"Illegal compute msd command");
+      npoint = force->inumeric(FLERR,arg[iarg+1]);
+      nlevel = force->inumeric(FLERR,arg[iarg+2]);
+      nblock = force->inumeric(FLERR,arg[iarg+3]);
+      if (nlevel <= 0 || nblock < 2 || npoint < nblock || npoint % nblock)
+        error->all(FLERR,"Illegal compute msd command");
+      iarg += 4;
     } else error->all(FLERR,"Illegal compute msd command");
   }
 
+  if (avflag && nlevel)
+    error->all(FLERR,"Compute msd average and multitau cannot both be used");
+
+  // multiple-tau correlator of displacements, one channel per dimension
+  // per-atom correlator state is stored after the reference positions
+
+  nstate = 0;
+  if (nlevel) {
+    correlator = new Correlator(lmp,npoint,nblock,nlevel,3,
+                                Correlator::DIFFERENCE);
+    nstate = correlator->size_state(0);
+
+    array_flag = 1;
+    size_array_rows = correlator->nlag;
+    size_array_cols = 6;
+    extarray = 0;
+    memory->create(array,size_array_rows,size_array_cols,"msd:array");
+    last_sample = -1;
+    sample_every = 0;
+  }
+
   // create a new fix STORE style for reference positions
   // id = compute-ID + COMPUTE_STORE, fix group = compute group
 
@@ -67,19 +101,31 @@ ComputeMSD::ComputeMSD(LAMMPS *lmp, int narg, char **arg) :
   strcpy(id_fix,id);
   strcat(id_fix,"_COMPUTE_STORE");
 
+  char ncolumn[16];
+  snprintf(ncolumn,16,"%d",3 + 3*nstate);
+
   char **newarg = new char*[6];
   newarg[0] = id_fix;
   newarg[1] = group->names[igroup];
   newarg[2] = (char *) "STORE";
   newarg[3] = (char *) "peratom";
   newarg[4] = (char *) "1";
-  newarg[5] = (char *) "3";
+  newarg[5] = ncolumn;
   modify->add_fix(6,newarg);
   fix = (FixStore *) modify->fix[modify->nfix-1];
   delete [] newarg;
 
   // calculate xu,yu,zu for fix store array
   // skip if reset from restart file
+  // correlator history is not restarted, so always clear it
+
+  if (correlator) {
+    double **xoriginal = fix->astore;
+    int nlocal = atom->nlocal;
+    for (int i = 0; i < nlocal; i++)
+      for (int k = 0; k < 3; k++)
+        correlator->clear_state(&xoriginal[i][3+k*nstate],0);
+  }
 
   if (fix->restart_reset) fix->restart_reset = 0;
   else {
@@ -128,6 +174,8 @@ ComputeMSD::~ComputeMSD()
 
   delete [] id_fix;
   delete [] vector;
+  delete correlator;
+  memory->destroy(array);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -152,6 +200,8 @@ void ComputeMSD::compute_vector()
 {
   invoked_vector = update->ntimestep;
 
+  if (correlator) sample();
+
   // cm = current center of mass
 
   double cm[3];
@@ -267,4 +317,76 @@ void ComputeMSD::set_arrays(int i)
   xoriginal[i][0] = x[i][0];
   xoriginal[i][1] = x[i][1];
   xoriginal[i][2] = x[i][2];
+  if (correlator)
+    for (int k = 0; k < 3; k++)
+      correlator->clear_state(&xoriginal[i][3+k*nstate],0);
+}
+
+/* ----------------------------------------------------------------------
+   add current unwrapped positions as a new sample of the
+     multiple-tau correlator
+   the first two samples set the sampling interval,
+     accesses in between samples are ignored
+------------------------------------------------------------------------- */
+
+void ComputeMSD::sample()
+{
+  if (update->ntimestep == last_sample) return;
+  if (last_sample >= 0) {
+    bigint delta = update->ntimestep - last_sample;
+    if (sample_every == 0) sample_every = delta;
+    else if (delta < sample_every) return;
+    else if (delta > sample_every)
+      error->all(FLERR,"Compute msd multitau is not invoked "
+                 "at a constant interval");
+  }
+  last_sample = update->ntimestep;
+
+  // positions relative to center of mass if comflag is set
+
+  double cm[3];
+  if (comflag) group->xcm(igroup,masstotal,cm);
+  else cm[0] = cm[1] = cm[2] = 0.0;
+
+  double **xoriginal = fix->astore;
+  double **x = atom->x;
+  int *mask = atom->mask;
+  imageint *image = atom->image;
+  int nlocal = atom->nlocal;
+  double unwrap[3];
+
+  correlator->begin();
+  for (int i = 0; i < nlocal; i++)
+    if (mask[i] & groupbit) {
+      domain->unmap(x[i],image[i],unwrap);
+      for (int k = 0; k < 3; k++)
+        correlator->add(&xoriginal[i][3+k*nstate],unwrap[k]-cm[k],k);
+    }
+  correlator->end();
+}
+
+/* ----------------------------------------------------------------------
+   output averages of the multiple-tau correlator
+------------------------------------------------------------------------- */
+
+void ComputeMSD::compute_array()
+{
+  invoked_array = update->ntimestep;
+
+  sample();
+
+  // lag in timesteps, # of time origins, MSD per dimension and total
+
+  correlator->evaluate(1);
+
+  double norm = nmsd ? 1.0/nmsd : 0.0;
+  double every = sample_every ? sample_every : 1;
+  for (int m = 0; m < size_array_rows; m++) {
+    array[m][0] = correlator->lag[m]*every;
+    array[m][1] = correlator->count(m);
+    array[m][2] = correlator->value(0,m)*norm;
+    array[m][3] = correlator->value(1,m)*norm;
+    array[m][4] = correlator->value(2,m)*norm;
+    array[m][5] = array[m][2] + array[m][3] + array[m][4];
+  }
 }
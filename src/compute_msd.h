@@ -30,6 +30,7 @@ class ComputeMSD : public Compute {
   virtual ~ComputeMSD();
   void init();
   virtual void compute_vector();
+  virtual void compute_array();
   void set_arrays(int);
 
  protected:
@@ -40,6 +41,14 @@ class ComputeMSD : public Compute {
   double masstotal;
   char *id_fix;
   class FixStore *fix;
+
+  int npoint,nlevel,nblock;     // multiple-tau settings, nlevel = 0 if off
+  int nstate;                   // per-atom correlator state per dimension
+  class Correlator *correlator;
+  bigint last_sample;           // timestep of last correlator sample
+  bigint sample_every;          // # of timesteps between samples
+
+  void sample();
 };
 
 }
@@ -59,4 +68,15 @@ E: Could not find compute msd fix ID
 
 Self-explanatory.
 
+E: Compute msd average and multitau cannot both be used
+
+The multiple-tau correlator averages over all time origins and does
+not use a reference position.
+
+E: Compute msd multitau is not invoked at a constant interval
+
+The multiple-tau correlator adds a sample each time the compute is
+invoked on a new timestep.  No sample may be skipped once the
+interval between the first two samples is set.
+
 */
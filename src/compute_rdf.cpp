@@ -29,6 +29,8 @@
 #include "neigh_request.h"
 #include "neigh_list.h"
 #include "group.h"
+#include "modify.h"
+#include "fix.h"
 #include "math_const.h"
 #include "memory.h"
 #include "error.h"
@@ -37,13 +39,15 @@
 using namespace LAMMPS_NS;
 using namespace MathConst;
 
+#define BIG 1.0e20
+
 /* ---------------------------------------------------------------------- */
 
 ComputeRDF::ComputeRDF(LAMMPS *lmp, int narg, char **arg) :
   Compute(lmp, narg, arg),
   rdfpair(NULL), nrdfpair(NULL), ilo(NULL), ihi(NULL), jlo(NULL), jhi(NULL),
   hist(NULL), histall(NULL), typecount(NULL), icount(NULL), jcount(NULL),
-  duplicates(NULL)
+  duplicates(NULL), id_fix(NULL)
 {
   if (narg < 4) error->all(FLERR,"Illegal compute rdf command");
 
@@ -57,10 +61,12 @@ ComputeRDF::ComputeRDF(LAMMPS *lmp, int narg, char **arg) :
   // nargpair = # of pairwise args, starting at iarg = 4
 
   cutflag = 0;
+  nevery_sample = 0;
 
   int iarg;
   for (iarg = 4; iarg < narg; iarg++)
-    if (strcmp(arg[iarg],"cutoff") == 0) break;
+    if (strcmp(arg[iarg],"cutoff") == 0 ||
+        strcmp(arg[iarg],"accumulate") == 0) break;
 
   int nargpair = iarg - 4;
 
@@ -71,6 +77,11 @@ ComputeRDF::ComputeRDF(LAMMPS *lmp, int narg, char **arg) :
       if (cutoff_user <= 0.0) cutflag = 0;
       else cutflag = 1;
       iarg += 2;
+    } else if (strcmp(arg[iarg],"accumulate") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal compute rdf command");
+      nevery_sample = force->inumeric(FLERR,arg[iarg+1]);
+      if (nevery_sample < 0) error->all(FLERR,"Illegal compute rdf command");
+      iarg += 2;
     } else error->all(FLERR,"Illegal compute rdf command");
   }
 
@@ -130,12 +141,42 @@ ComputeRDF::ComputeRDF(LAMMPS *lmp, int narg, char **arg) :
 
   dynamic = 0;
   natoms_old = 0;
+  nsample = 0;
+  last_sample = -1;
+
+  // with accumulate, create a new fix RDF_SAMPLE style
+  //   which adds a sample to the histograms every Nevery steps
+  // id = compute-ID + COMPUTE_SAMPLE, fix group = compute group
+
+  if (nevery_sample) {
+    int n = strlen(id) + strlen("_COMPUTE_SAMPLE") + 1;
+    id_fix = new char[n];
+    strcpy(id_fix,id);
+    strcat(id_fix,"_COMPUTE_SAMPLE");
+
+    char nevery[16];
+    snprintf(nevery,16,"%d",nevery_sample);
+
+    char **newarg = new char*[5];
+    newarg[0] = id_fix;
+    newarg[1] = group->names[igroup];
+    newarg[2] = (char *) "RDF_SAMPLE";
+    newarg[3] = id;
+    newarg[4] = nevery;
+    modify->add_fix(5,newarg);
+    delete [] newarg;
+  }
 }
 
 /* ---------------------------------------------------------------------- */
 
 ComputeRDF::~ComputeRDF()
 {
+  // check nfix in case all fixes have already been deleted
+
+  if (id_fix && modify->nfix) modify->delete_fix(id_fix);
+  delete [] id_fix;
+
   memory->destroy(rdfpair);
   memory->destroy(nrdfpair);
   delete [] ilo;
@@ -173,14 +214,30 @@ void ComputeRDF::init()
     if (mycutneigh > cutghost)
       error->all(FLERR,"Compute rdf cutoff exceeds ghost atom range - "
                  "use comm_modify cutoff command");
-    if (force->pair && mycutneigh < force->pair->cutforce + skin)
-      if (comm->me == 0)
-        error->warning(FLERR,"Compute rdf cutoff less than neighbor cutoff - "
-                       "forcing a needless neighbor list build");
 
     delr = cutoff_user / nbin;
   } else delr = force->pair->cutforce / nbin;
 
+  // the pair neighbor list can be used if it includes all pairs
+  //   within the RDF cutoff, i.e. for the pair cutoff of every type pair
+
+  perpetual = 0;
+  if (force->pair && !cutflag) perpetual = 1;
+  else if (force->pair && force->pair->cutsq) {
+    double cutsqmin = BIG;
+    int ntypes = atom->ntypes;
+    for (int i = 1; i <= ntypes; i++)
+      for (int j = i; j <= ntypes; j++)
+        cutsqmin = MIN(cutsqmin,force->pair->cutsq[i][j]);
+    if (cutoff_user*cutoff_user <= cutsqmin) perpetual = 1;
+  }
+
+  if (cutflag && !perpetual && force->pair &&
+      mycutneigh < force->pair->cutforce + neighbor->skin)
+    if (comm->me == 0)
+      error->warning(FLERR,"Compute rdf cutoff less than neighbor cutoff - "
+                     "forcing a needless neighbor list build");
+
   delrinv = 1.0/delr;
 
   // set 1st column of output array to bin coords
@@ -195,7 +252,19 @@ void ComputeRDF::init()
   if (dynamic_user) dynamic = 1;
   init_norm();
 
-  // need an occasional half neighbor list
+  // samples accumulated in a previous run are discarded
+
+  if (nevery_sample) {
+    for (int i = 0; i < npairs; i++)
+      for (int j = 0; j < nbin; j++)
+        hist[i][j] = 0.0;
+    nsample = 0;
+    last_sample = -1;
+  }
+
+  // if the pair neighbor list can be used, need a perpetual half list
+  //   which Neighbor will copy or derive from the pair list
+  // else need an occasional half neighbor list
   // if user specified, request a cutoff = cutoff_user + skin
   // skin is included b/c Neighbor uses this value similar
   //   to its cutneighmax = force cutoff + skin
@@ -206,10 +275,12 @@ void ComputeRDF::init()
   int irequest = neighbor->request(this,instance_me);
   neighbor->requests[irequest]->pair = 0;
   neighbor->requests[irequest]->compute = 1;
-  neighbor->requests[irequest]->occasional = 1;
-  if (cutflag) {
-    neighbor->requests[irequest]->cut = 1;
-    neighbor->requests[irequest]->cutoff = mycutneigh;
+  if (!perpetual) {
+    neighbor->requests[irequest]->occasional = 1;
+    if (cutflag) {
+      neighbor->requests[irequest]->cut = 1;
+      neighbor->requests[irequest]->cutoff = mycutneigh;
+    }
   }
 }
 
@@ -266,10 +337,7 @@ void ComputeRDF::init_norm()
 
 void ComputeRDF::compute_array()
 {
-  int i,j,m,ii,jj,inum,jnum,itype,jtype,ipair,jpair,ibin,ihisto;
-  double xtmp,ytmp,ztmp,delx,dely,delz,r;
-  int *ilist,*jlist,*numneigh,**firstneigh;
-  double factor_lj,factor_coul;
+  int i,j,m,ibin;
 
   if (natoms_old != atom->natoms) {
     dynamic = 1;
@@ -284,21 +352,121 @@ void ComputeRDF::compute_array()
 
   invoked_array = update->ntimestep;
 
+  // with accumulate, use samples added since the last invocation
+  //   done if already invoked on this step, since array is current
+  //   add this step if it is a sampling step or if there are none
+  //   the summed histograms are averaged over samples and then reset
+  // else tally the RDF for this step only
+
+  if (nevery_sample) {
+    if (nsample == 0 && last_sample == update->ntimestep) return;
+    if (nsample == 0 || update->ntimestep % nevery_sample == 0) sample();
+  } else {
+    for (i = 0; i < npairs; i++)
+      for (j = 0; j < nbin; j++)
+        hist[i][j] = 0.0;
+    tally();
+  }
+
+  // sum histograms across procs
+
+  MPI_Allreduce(hist[0],histall[0],npairs*nbin,MPI_DOUBLE,MPI_SUM,world);
+
+  if (nevery_sample) {
+    double scale = 1.0/nsample;
+    for (i = 0; i < npairs; i++)
+      for (j = 0; j < nbin; j++) {
+        histall[i][j] *= scale;
+        hist[i][j] = 0.0;
+      }
+    nsample = 0;
+  }
+
+  // convert counts to g(r) and coord(r) and copy into output array
+  // vfrac = fraction of volume in shell m
+  // npairs = number of pairs, corrected for duplicates
+  // duplicates = pairs in which both atoms are the same
+
+  double constant,vfrac,gr,ncoord,rlower,rupper,normfac;
+
+  if (domain->dimension == 3) {
+    constant = 4.0*MY_PI / (3.0*domain->xprd*domain->yprd*domain->zprd);
+
+    for (m = 0; m < npairs; m++) {
+      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
+                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
+      ncoord = 0.0;
+      for (ibin = 0; ibin < nbin; ibin++) {
+        rlower = ibin*delr;
+        rupper = (ibin+1)*delr;
+        vfrac = constant * (rupper*rupper*rupper - rlower*rlower*rlower);
+        if (vfrac * normfac != 0.0)
+          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
+        else gr = 0.0;
+        if (icount[m] != 0)
+          ncoord += gr * vfrac * normfac;
+        array[ibin][1+2*m] = gr;
+        array[ibin][2+2*m] = ncoord;
+      }
+    }
+
+  } else {
+    constant = MY_PI / (domain->xprd*domain->yprd);
+
+    for (m = 0; m < npairs; m++) {
+      ncoord = 0.0;
+      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
+                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
+      for (ibin = 0; ibin < nbin; ibin++) {
+        rlower = ibin*delr;
+        rupper = (ibin+1)*delr;
+        vfrac = constant * (rupper*rupper - rlower*rlower);
+        if (vfrac * normfac != 0.0)
+          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
+        else gr = 0.0;
+        if (icount[m] != 0)
+          ncoord += gr * vfrac * normfac;
+        array[ibin][1+2*m] = gr;
+        array[ibin][2+2*m] = ncoord;
+      }
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   add a sample to the accumulated histograms, at most once per step
+   called every Nevery steps by fix RDF_SAMPLE
+------------------------------------------------------------------------- */
+
+void ComputeRDF::sample()
+{
+  if (last_sample == update->ntimestep) return;
+  last_sample = update->ntimestep;
+  tally();
+  nsample++;
+}
+
+/* ----------------------------------------------------------------------
+   add pair counts of current configuration to histograms on this proc
+------------------------------------------------------------------------- */
+
+void ComputeRDF::tally()
+{
+  int i,j,m,ii,jj,inum,jnum,itype,jtype,ipair,jpair,ibin,ihisto;
+  double xtmp,ytmp,ztmp,delx,dely,delz,r;
+  int *ilist,*jlist,*numneigh,**firstneigh;
+  double factor_lj,factor_coul;
+
   // invoke half neighbor list (will copy or build if necessary)
+  // perpetual list is current on any step
 
-  neighbor->build_one(list);
+  if (!perpetual) neighbor->build_one(list);
 
   inum = list->inum;
   ilist = list->ilist;
   numneigh = list->numneigh;
   firstneigh = list->firstneigh;
 
-  // zero the histogram counts
-
-  for (i = 0; i < npairs; i++)
-    for (j = 0; j < nbin; j++)
-      hist[i][j] = 0;
-
   // tally the RDF
   // both atom i and j must be in fix group
   // itype,jtype must have been specified by user
@@ -361,58 +529,4 @@ void ComputeRDF::compute_array()
       }
     }
   }
-
-  // sum histograms across procs
-
-  MPI_Allreduce(hist[0],histall[0],npairs*nbin,MPI_DOUBLE,MPI_SUM,world);
-
-  // convert counts to g(r) and coord(r) and copy into output array
-  // vfrac = fraction of volume in shell m
-  // npairs = number of pairs, corrected for duplicates
-  // duplicates = pairs in which both atoms are the same
-
-  double constant,vfrac,gr,ncoord,rlower,rupper,normfac;
-
-  if (domain->dimension == 3) {
-    constant = 4.0*MY_PI / (3.0*domain->xprd*domain->yprd*domain->zprd);
-
-    for (m = 0; m < npairs; m++) {
-      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
-                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
-      ncoord = 0.0;
-      for (ibin = 0; ibin < nbin; ibin++) {
-        rlower = ibin*delr;
-        rupper = (ibin+1)*delr;
-        vfrac = constant * (rupper*rupper*rupper - rlower*rlower*rlower);
-        if (vfrac * normfac != 0.0)
-          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
-        else gr = 0.0;
-        if (icount[m] != 0)
-          ncoord += gr * vfrac * normfac;
-        array[ibin][1+2*m] = gr;
-        array[ibin][2+2*m] = ncoord;
-      }
-    }
-
-  } else {
-    constant = MY_PI / (domain->xprd*domain->yprd);
-
-    for (m = 0; m < npairs; m++) {
-      ncoord = 0.0;
-      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
-                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
-      for (ibin = 0; ibin < nbin; ibin++) {
-        rlower = ibin*delr;
-        rupper = (ibin+1)*delr;
-        vfrac = constant * (rupper*rupper - rlower*rlower);
-        if (vfrac * normfac != 0.0)
-          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
-        else gr = 0.0;
-        if (icount[m] != 0)
-          ncoord += gr * vfrac * normfac;
-        array[ibin][1+2*m] = gr;
-        array[ibin][2+2*m] = ncoord;
-      }
-    }
-  }
 }
@@ -32,6 +32,7 @@ class ComputeRDF : public Compute {
   void init();
   void init_list(int, class NeighList *);
   void compute_array();
+  void sample();
 
  private:
   int nbin;              // # of rdf bins
@@ -51,7 +52,15 @@ class ComputeRDF : public Compute {
   int *duplicates;
 
   class NeighList *list; // half neighbor list
+  int perpetual;         // 1 if list is derived from pair neighbor list
+
+  int nevery_sample;     // add sample every this many steps, 0 if not
+  int nsample;           // # of samples summed in hist
+  bigint last_sample;    // last timestep a sample was added
+  char *id_fix;          // ID of fix RDF_SAMPLE
+
   void init_norm();
+  void tally();
   bigint natoms_old;
 };
 
@@ -47,7 +47,8 @@ ComputeReduce::ComputeReduce(LAMMPS *lmp, int narg, char **arg) :
   Compute(lmp, narg, arg),
   nvalues(0), which(NULL), argindex(NULL), flavor(NULL),
   value2index(NULL), ids(NULL), onevec(NULL), replace(NULL), indices(NULL),
-  owner(NULL), idregion(NULL), varatom(NULL)
+  owner(NULL), idregion(NULL), varatom(NULL), select(NULL), reducebuf(NULL),
+  pairbuf(NULL)
 {
   int iarg = 0;
   if (strcmp(style,"reduce") == 0) {
@@ -301,6 +302,15 @@ ComputeReduce::ComputeReduce(LAMMPS *lmp, int narg, char **arg) :
 
   maxatom = 0;
   varatom = NULL;
+
+  maxselect = 0;
+  nselect = 0;
+  select = NULL;
+
+  // buffers for reducing all values with a single collective operation
+
+  reducebuf = new double[4*nvalues];
+  pairbuf = new Pair[nvalues];
 }
 
 /* ---------------------------------------------------------------------- */
@@ -322,6 +332,9 @@ ComputeReduce::~ComputeReduce()
   delete [] owner;
 
   memory->destroy(varatom);
+  memory->destroy(select);
+  delete [] reducebuf;
+  delete [] pairbuf;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -367,6 +380,7 @@ double ComputeReduce::compute_scalar()
 {
   invoked_scalar = update->ntimestep;
 
+  select_atoms();
   double one = compute_one(0,-1);
 
   if (mode == SUM || mode == SUMSQ) {
@@ -376,67 +390,61 @@ double ComputeReduce::compute_scalar()
   } else if (mode == MAXX) {
     MPI_Allreduce(&one,&scalar,1,MPI_DOUBLE,MPI_MAX,world);
   } else if (mode == AVE || mode == AVESQ) {
-    MPI_Allreduce(&one,&scalar,1,MPI_DOUBLE,MPI_SUM,world);
-    bigint n = count(0);
-    if (n) scalar /= n;
+    reducebuf[0] = one;
+    reducebuf[1] = count(0);
+    MPI_Allreduce(reducebuf,&reducebuf[2],2,MPI_DOUBLE,MPI_SUM,world);
+    scalar = reducebuf[2];
+    if (reducebuf[3] > 0.0) scalar /= reducebuf[3];
   }
 
   return scalar;
 }
 
-/* ---------------------------------------------------------------------- */
+/* ----------------------------------------------------------------------
+   all values are reduced across procs by a single MPI_Allreduce()
+   except for values replaced by the value of the min/max atom of another
+------------------------------------------------------------------------- */
 
 void ComputeReduce::compute_vector()
 {
+  int m;
+
   invoked_vector = update->ntimestep;
 
-  for (int m = 0; m < nvalues; m++)
+  select_atoms();
+
+  for (m = 0; m < nvalues; m++)
     if (!replace || replace[m] < 0) {
       onevec[m] = compute_one(m,-1);
       indices[m] = index;
     }
 
   if (mode == SUM || mode == SUMSQ) {
-    for (int m = 0; m < nvalues; m++)
-      MPI_Allreduce(&onevec[m],&vector[m],1,MPI_DOUBLE,MPI_SUM,world);
-
-  } else if (mode == MINN) {
-    if (!replace) {
-      for (int m = 0; m < nvalues; m++)
-        MPI_Allreduce(&onevec[m],&vector[m],1,MPI_DOUBLE,MPI_MIN,world);
-
-    } else {
-      for (int m = 0; m < nvalues; m++)
-        if (replace[m] < 0) {
-          pairme.value = onevec[m];
-          pairme.proc = me;
-          MPI_Allreduce(&pairme,&pairall,1,MPI_DOUBLE_INT,MPI_MINLOC,world);
-          vector[m] = pairall.value;
-          owner[m] = pairall.proc;
-        }
-      for (int m = 0; m < nvalues; m++)
-        if (replace[m] >= 0) {
-          if (me == owner[replace[m]])
-            vector[m] = compute_one(m,indices[replace[m]]);
-          MPI_Bcast(&vector[m],1,MPI_DOUBLE,owner[replace[m]],world);
-        }
-    }
+    MPI_Allreduce(onevec,vector,nvalues,MPI_DOUBLE,MPI_SUM,world);
 
-  } else if (mode == MAXX) {
+  } else if (mode == MINN || mode == MAXX) {
     if (!replace) {
-      for (int m = 0; m < nvalues; m++)
-        MPI_Allreduce(&onevec[m],&vector[m],1,MPI_DOUBLE,MPI_MAX,world);
+      if (mode == MINN)
+        MPI_Allreduce(onevec,vector,nvalues,MPI_DOUBLE,MPI_MIN,world);
+      else MPI_Allreduce(onevec,vector,nvalues,MPI_DOUBLE,MPI_MAX,world);
 
     } else {
-      for (int m = 0; m < nvalues; m++)
+      for (m = 0; m < nvalues; m++) {
+        if (replace[m] < 0) pairbuf[m].value = onevec[m];
+        else pairbuf[m].value = (mode == MINN) ? BIG : -BIG;
+        pairbuf[m].proc = me;
+      }
+      Pair *pairall = (Pair *) reducebuf;
+      if (mode == MINN)
+        MPI_Allreduce(pairbuf,pairall,nvalues,MPI_DOUBLE_INT,MPI_MINLOC,world);
+      else
+        MPI_Allreduce(pairbuf,pairall,nvalues,MPI_DOUBLE_INT,MPI_MAXLOC,world);
+      for (m = 0; m < nvalues; m++)
         if (replace[m] < 0) {
-          pairme.value = onevec[m];
-          pairme.proc = me;
-          MPI_Allreduce(&pairme,&pairall,1,MPI_DOUBLE_INT,MPI_MAXLOC,world);
-          vector[m] = pairall.value;
-          owner[m] = pairall.proc;
+          vector[m] = pairall[m].value;
+          owner[m] = pairall[m].proc;
         }
-      for (int m = 0; m < nvalues; m++)
+      for (m = 0; m < nvalues; m++)
         if (replace[m] >= 0) {
           if (me == owner[replace[m]])
             vector[m] = compute_one(m,indices[replace[m]]);
@@ -445,14 +453,48 @@ void ComputeReduce::compute_vector()
     }
 
   } else if (mode == AVE || mode == AVESQ) {
-    for (int m = 0; m < nvalues; m++) {
-      MPI_Allreduce(&onevec[m],&vector[m],1,MPI_DOUBLE,MPI_SUM,world);
-      bigint n = count(m);
-      if (n) vector[m] /= n;
+    double *sumall = &reducebuf[2*nvalues];
+    for (m = 0; m < nvalues; m++) {
+      reducebuf[m] = onevec[m];
+      reducebuf[nvalues+m] = count(m);
+    }
+    MPI_Allreduce(reducebuf,sumall,2*nvalues,MPI_DOUBLE,MPI_SUM,world);
+    for (m = 0; m < nvalues; m++) {
+      vector[m] = sumall[m];
+      if (sumall[nvalues+m] > 0.0) vector[m] /= sumall[nvalues+m];
     }
   }
 }
 
+/* ----------------------------------------------------------------------
+   create list of local atoms that contribute to per-atom values
+   done once per invocation and shared by all values
+   atoms must be in group
+------------------------------------------------------------------------- */
+
+void ComputeReduce::select_atoms()
+{
+  int *mask = atom->mask;
+  int nlocal = atom->nlocal;
+
+  grow_select();
+
+  nselect = 0;
+  for (int i = 0; i < nlocal; i++)
+    if (mask[i] & groupbit) select[nselect++] = i;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ComputeReduce::grow_select()
+{
+  if (atom->nmax > maxselect) {
+    maxselect = atom->nmax;
+    memory->destroy(select);
+    memory->create(select,maxselect,"reduce:select");
+  }
+}
+
 /* ----------------------------------------------------------------------
    calculate reduced value for one input M and return it
    if flag = -1:
@@ -464,7 +506,7 @@ void ComputeReduce::compute_vector()
 
 double ComputeReduce::compute_one(int m, int flag)
 {
-  int i;
+  int i,ii;
 
   // invoke the appropriate attribute,compute,fix,variable
   // for flag = -1, compute scalar quantity by scanning over atom properties
@@ -482,8 +524,6 @@ double ComputeReduce::compute_one(int m, int flag)
   }
 
   int aidx = argindex[m];
-  int *mask = atom->mask;
-  int nlocal = atom->nlocal;
 
   double one = 0.0;
   if (mode == MINN) one = BIG;
@@ -492,20 +532,26 @@ double ComputeReduce::compute_one(int m, int flag)
   if (which[m] == X) {
     double **x = atom->x;
     if (flag < 0) {
-      for (i = 0; i < nlocal; i++)
-        if (mask[i] & groupbit) combine(one,x[i][aidx],i);
+      for (ii = 0; ii < nselect; ii++) {
+        i = select[ii];
+        combine(one,x[i][aidx],i);
+      }
     } else one = x[flag][aidx];
   } else if (which[m] == V) {
     double **v = atom->v;
     if (flag < 0) {
-      for (i = 0; i < nlocal; i++)
-        if (mask[i] & groupbit) combine(one,v[i][aidx],i);
+      for (ii = 0; ii < nselect; ii++) {
+        i = select[ii];
+        combine(one,v[i][aidx],i);
+      }
     } else one = v[flag][aidx];
   } else if (which[m] == F) {
     double **f = atom->f;
     if (flag < 0) {
-      for (i = 0; i < nlocal; i++)
-        if (mask[i] & groupbit) combine(one,f[i][aidx],i);
+      for (ii = 0; ii < nselect; ii++) {
+        i = select[ii];
+        combine(one,f[i][aidx],i);
+      }
     } else one = f[flag][aidx];
 
   // invoke compute if not previously invoked
@@ -521,18 +567,20 @@ double ComputeReduce::compute_one(int m, int flag)
 
       if (aidx == 0) {
         double *comp_vec = compute->vector_atom;
-        int n = nlocal;
         if (flag < 0) {
-          for (i = 0; i < n; i++)
-            if (mask[i] & groupbit) combine(one,comp_vec[i],i);
+          for (ii = 0; ii < nselect; ii++) {
+            i = select[ii];
+            combine(one,comp_vec[i],i);
+          }
         } else one = comp_vec[flag];
       } else {
         double **carray_atom = compute->array_atom;
-        int n = nlocal;
         int aidxm1 = aidx - 1;
         if (flag < 0) {
-          for (i = 0; i < n; i++)
-            if (mask[i] & groupbit) combine(one,carray_atom[i][aidxm1],i);
+          for (ii = 0; ii < nselect; ii++) {
+            i = select[ii];
+            combine(one,carray_atom[i][aidxm1],i);
+          }
         } else one = carray_atom[flag][aidxm1];
       }
 
@@ -571,17 +619,20 @@ double ComputeReduce::compute_one(int m, int flag)
     if (flavor[m] == PERATOM) {
       if (aidx == 0) {
         double *fix_vector = fix->vector_atom;
-        int n = nlocal;
         if (flag < 0) {
-          for (i = 0; i < n; i++)
-            if (mask[i] & groupbit) combine(one,fix_vector[i],i);
+          for (ii = 0; ii < nselect; ii++) {
+            i = select[ii];
+            combine(one,fix_vector[i],i);
+          }
         } else one = fix_vector[flag];
       } else {
         double **fix_array = fix->array_atom;
         int aidxm1 = aidx - 1;
         if (flag < 0) {
-          for (i = 0; i < nlocal; i++)
-            if (mask[i] & groupbit) combine(one,fix_array[i][aidxm1],i);
+          for (ii = 0; ii < nselect; ii++) {
+            i = select[ii];
+            combine(one,fix_array[i][aidxm1],i);
+          }
         } else one = fix_array[flag][aidxm1];
       }
 
@@ -615,47 +666,29 @@ double ComputeReduce::compute_one(int m, int flag)
 
     input->variable->compute_atom(vidx,igroup,varatom,1,0);
     if (flag < 0) {
-      for (i = 0; i < nlocal; i++)
-        if (mask[i] & groupbit) combine(one,varatom[i],i);
+      for (ii = 0; ii < nselect; ii++) {
+        i = select[ii];
+        combine(one,varatom[i],i);
+      }
     } else one = varatom[flag];
   }
 
   return one;
 }
 
-/* ---------------------------------------------------------------------- */
+/* ----------------------------------------------------------------------
+   # of local values that contribute to reduced value for one input M
+------------------------------------------------------------------------- */
 
 bigint ComputeReduce::count(int m)
 {
   int vidx = value2index[m];
 
-  if (which[m] == X || which[m] == V || which[m] == F)
-    return group->count(igroup);
-  else if (which[m] == COMPUTE) {
-    Compute *compute = modify->compute[vidx];
-    if (flavor[m] == PERATOM) {
-      return group->count(igroup);
-    } else if (flavor[m] == LOCAL) {
-      bigint ncount = compute->size_local_rows;
-      bigint ncountall;
-      MPI_Allreduce(&ncount,&ncountall,1,MPI_LMP_BIGINT,MPI_SUM,world);
-      return ncountall;
-    }
-  } else if (which[m] == FIX) {
-    Fix *fix = modify->fix[vidx];
-    if (flavor[m] == PERATOM) {
-      return group->count(igroup);
-    } else if (flavor[m] == LOCAL) {
-      bigint ncount = fix->size_local_rows;
-      bigint ncountall;
-      MPI_Allreduce(&ncount,&ncountall,1,MPI_LMP_BIGINT,MPI_SUM,world);
-      return ncountall;
-    }
-  } else if (which[m] == VARIABLE)
-    return group->count(igroup);
-
-  bigint dummy = 0;
-  return dummy;
+  if (flavor[m] == LOCAL) {
+    if (which[m] == COMPUTE) return modify->compute[vidx]->size_local_rows;
+    if (which[m] == FIX) return modify->fix[vidx]->size_local_rows;
+  }
+  return nselect;
 }
 
 /* ----------------------------------------------------------------------
@@ -681,11 +714,12 @@ void ComputeReduce::combine(double &one, double two, int i)
 }
 
 /* ----------------------------------------------------------------------
-   memory usage of varatom
+   memory usage of varatom and atom list
 ------------------------------------------------------------------------- */
 
 double ComputeReduce::memory_usage()
 {
   double bytes = maxatom * sizeof(double);
+  bytes += maxselect * sizeof(int);
   return bytes;
 }
@@ -46,14 +46,20 @@ class ComputeReduce : public Compute {
   int maxatom;
   double *varatom;
 
+  int nselect,maxselect;
+  int *select;          // local atoms contributing to per-atom values
+
   struct Pair {
     double value;
     int proc;
   };
-  Pair pairme,pairall;
+  double *reducebuf;
+  Pair *pairbuf;
 
-  virtual double compute_one(int, int);
-  virtual bigint count(int);
+  virtual void select_atoms();
+  void grow_select();
+  double compute_one(int, int);
+  bigint count(int);
   void combine(double &, double, int);
 };
 
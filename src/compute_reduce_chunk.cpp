@@ -39,7 +39,8 @@ enum{UNKNOWN=-1,COMPUTE,FIX,VARIABLE};
 ComputeReduceChunk::ComputeReduceChunk(LAMMPS *lmp, int narg, char **arg) :
   Compute(lmp, narg, arg),
   which(NULL), argindex(NULL), value2index(NULL), idchunk(NULL), ids(NULL),
-  vlocal(NULL), vglobal(NULL), alocal(NULL), aglobal(NULL), varatom(NULL)
+  vlocal(NULL), vglobal(NULL), alocal(NULL), aglobal(NULL), varatom(NULL),
+  select(NULL), cindex(NULL)
 {
   if (narg < 6) error->all(FLERR,"Illegal compute reduce/chunk command");
 
@@ -196,6 +197,7 @@ ComputeReduceChunk::ComputeReduceChunk(LAMMPS *lmp, int narg, char **arg) :
 
   maxatom = 0;
   varatom = NULL;
+  maxselect = nselect = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -216,6 +218,8 @@ ComputeReduceChunk::~ComputeReduceChunk()
   memory->destroy(aglobal);
 
   memory->destroy(varatom);
+  memory->destroy(select);
+  memory->destroy(cindex);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -289,6 +293,7 @@ void ComputeReduceChunk::compute_vector()
 
   // perform local reduction of single peratom value
 
+  select_atoms();
   compute_one(0,vlocal,1);
 
   // reduce the per-chunk values across all procs
@@ -328,7 +333,9 @@ void ComputeReduceChunk::compute_array()
   }
 
   // perform local reduction of all peratom values
+  // over a single list of selected atoms shared by all values
 
+  select_atoms();
   for (int m = 0; m < nvalues; m++) compute_one(m,&alocal[0][m],nvalues);
 
   // reduce the per-chunk values across all procs
@@ -350,15 +357,12 @@ void ComputeReduceChunk::compute_one(int m, double *vchunk, int nstride)
 {
   // initialize per-chunk values in accumulation vector
 
-  for (int i = 0; i < nchunk; i += nstride) vchunk[i] = initvalue;
+  for (int i = 0; i < nchunk; i++) vchunk[i*nstride] = initvalue;
 
-  // loop over my atoms
-  // use peratom input and chunk ID of each atom to update vector
+  // loop over my selected atoms
+  // use peratom input and chunk index of each atom to update vector
 
-  int *mask = atom->mask;
-  int nlocal = atom->nlocal;
-
-  int index = -1;
+  int i,ii;
   int vidx = value2index[m];
 
   // initialization in case it has not yet been run, e.g. when
@@ -379,20 +383,16 @@ void ComputeReduceChunk::compute_one(int m, double *vchunk, int nstride)
 
     if (argindex[m] == 0) {
       double *vcompute = compute->vector_atom;
-      for (int i = 0; i < nlocal; i++) {
-        if (!(mask[i] & groupbit)) continue;
-        index = ichunk[i]-1;
-        if (index < 0) continue;
-        combine(vchunk[index*nstride],vcompute[i]);
+      for (ii = 0; ii < nselect; ii++) {
+        i = select[ii];
+        combine(vchunk[cindex[ii]*nstride],vcompute[i]);
       }
     } else {
       double **acompute = compute->array_atom;
       int argindexm1 = argindex[m] - 1;
-      for (int i = 0; i < nlocal; i++) {
-        if (!(mask[i] & groupbit)) continue;
-        index = ichunk[i]-1;
-        if (index < 0) continue;
-        combine(vchunk[index*nstride],acompute[i][argindexm1]);
+      for (ii = 0; ii < nselect; ii++) {
+        i = select[ii];
+        combine(vchunk[cindex[ii]*nstride],acompute[i][argindexm1]);
       }
     }
 
@@ -406,20 +406,16 @@ void ComputeReduceChunk::compute_one(int m, double *vchunk, int nstride)
 
     if (argindex[m] == 0) {
       double *vfix = fix->vector_atom;
-      for (int i = 0; i < nlocal; i++) {
-        if (!(mask[i] & groupbit)) continue;
-        index = ichunk[i]-1;
-        if (index < 0) continue;
-        combine(vchunk[index*nstride],vfix[i]);
+      for (ii = 0; ii < nselect; ii++) {
+        i = select[ii];
+        combine(vchunk[cindex[ii]*nstride],vfix[i]);
       }
     } else {
       double **afix = fix->array_atom;
       int argindexm1 = argindex[m] - 1;
-      for (int i = 0; i < nlocal; i++) {
-        if (!(mask[i] & groupbit)) continue;
-        index = ichunk[i]-1;
-        if (index < 0) continue;
-        combine(vchunk[index*nstride],afix[i][argindexm1]);
+      for (ii = 0; ii < nselect; ii++) {
+        i = select[ii];
+        combine(vchunk[cindex[ii]*nstride],afix[i][argindexm1]);
       }
     }
 
@@ -433,15 +429,39 @@ void ComputeReduceChunk::compute_one(int m, double *vchunk, int nstride)
     }
 
     input->variable->compute_atom(vidx,igroup,varatom,1,0);
-    for (int i = 0; i < nlocal; i++) {
-      if (!(mask[i] & groupbit)) continue;
-      index = ichunk[i]-1;
-      if (index < 0) continue;
-      combine(vchunk[index*nstride],varatom[i]);
+    for (ii = 0; ii < nselect; ii++) {
+      i = select[ii];
+      combine(vchunk[cindex[ii]*nstride],varatom[i]);
     }
   }
 }
 
+/* ----------------------------------------------------------------------
+   create list of local atoms in group and assigned to a chunk
+   along with their chunk indices, shared by all values
+------------------------------------------------------------------------- */
+
+void ComputeReduceChunk::select_atoms()
+{
+  int *mask = atom->mask;
+  int nlocal = atom->nlocal;
+
+  if (atom->nmax > maxselect) {
+    memory->destroy(select);
+    memory->destroy(cindex);
+    maxselect = atom->nmax;
+    memory->create(select,maxselect,"reduce/chunk:select");
+    memory->create(cindex,maxselect,"reduce/chunk:cindex");
+  }
+
+  nselect = 0;
+  for (int i = 0; i < nlocal; i++) {
+    if (!(mask[i] & groupbit) || ichunk[i] <= 0) continue;
+    select[nselect] = i;
+    cindex[nselect++] = ichunk[i]-1;
+  }
+}
+
 /* ----------------------------------------------------------------------
    combine two values according to reduction mode
 ------------------------------------------------------------------------- */
@@ -519,6 +539,7 @@ void ComputeReduceChunk::unlock(Fix *fixptr)
 double ComputeReduceChunk::memory_usage()
 {
   double bytes = (bigint) maxatom * sizeof(double);
+  bytes += (bigint) maxselect * 2 * sizeof(int);
   if (nvalues == 1) bytes += (bigint) maxchunk * 2 * sizeof(double);
   else bytes += (bigint) maxchunk * nvalues * 2 * sizeof(double);
   return bytes;
@@ -53,10 +53,15 @@ class ComputeReduceChunk : public Compute {
   double **alocal,**aglobal;
   double *varatom;
 
+  int maxselect,nselect;
+  int *select;              // local atoms in group and in a chunk
+  int *cindex;              // chunk index of each selected atom
+
   class ComputeChunkAtom *cchunk;
   int *ichunk;
 
   void init_chunk();
+  void select_atoms();
   void compute_one(int, double *, int);
   void combine(double &, double);
 };
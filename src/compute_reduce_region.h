@@ -30,8 +30,7 @@ class ComputeReduceRegion : public ComputeReduce {
   ~ComputeReduceRegion() {}
 
  private:
-  double compute_one(int, int);
-  bigint count(int);
+  void select_atoms();
 };
 
 }
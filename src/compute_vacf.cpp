@@ -11,6 +11,7 @@
    See the README file in the top-level LAMMPS directory.
 ------------------------------------------------------------------------- */
 
+#include <cstdio>
 #include <cstring>
 #include "compute_vacf.h"
 #include "atom.h"
@@ -18,6 +19,9 @@
 #include "group.h"
 #include "modify.h"
 #include "fix_store.h"
+#include "correlator.h"
+#include "force.h"
+#include "memory.h"
 #include "error.h"
 
 using namespace LAMMPS_NS;
@@ -26,7 +30,7 @@ using namespace LAMMPS_NS;
 
 ComputeVACF::ComputeVACF(LAMMPS *lmp, int narg, char **arg) :
   Compute(lmp, narg, arg),
-  id_fix(NULL)
+  id_fix(NULL), correlator(NULL)
 {
   if (narg < 3) error->all(FLERR,"Illegal compute vacf command");
 
@@ -35,6 +39,41 @@ ComputeVACF::ComputeVACF(LAMMPS *lmp, int narg, char **arg) :
   extvector = 0;
   create_attribute = 1;
 
+  // optional args
+
+  nlevel = 0;
+
+  int iarg = 3;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"multitau") == 0) {
+      if (iarg+4 > narg) error->all(FLERR,"Illegal compute vacf command");
+      npoint = force->inumeric(FLERR,arg[iarg+1]);
+      nlevel = force->inumeric(FLERR,arg[iarg+2]);
+      nblock = force->inumeric(FLERR,arg[iarg+3]);
+      if (nlevel <= 0 || nblock < 2 || npoint < nblock || npoint % nblock)
+        error->all(FLERR,"Illegal compute vacf command");
+      iarg += 4;
+    } else error->all(FLERR,"Illegal compute vacf command");
+  }
+
+  // multiple-tau correlator of velocities, one channel per dimension
+  // per-atom correlator state is stored after the original velocities
+
+  nstate = 0;
+  if (nlevel) {
+    correlator = new Correlator(lmp,npoint,nblock,nlevel,3,
+                                Correlator::PRODUCT);
+    nstate = correlator->size_state(0);
+
+    array_flag = 1;
+    size_array_rows = correlator->nlag;
+    size_array_cols = 6;
+    extarray = 0;
+    memory->create(array,size_array_rows,size_array_cols,"vacf:array");
+    last_sample = -1;
+    sample_every = 0;
+  }
+
   // create a new fix STORE style
   // id = compute-ID + COMPUTE_STORE, fix group = compute group
 
@@ -43,19 +82,31 @@ ComputeVACF::ComputeVACF(LAMMPS *lmp, int narg, char **arg) :
   strcpy(id_fix,id);
   strcat(id_fix,"_COMPUTE_STORE");
 
+  char ncolumn[16];
+  snprintf(ncolumn,16,"%d",3 + 3*nstate);
+
   char **newarg = new char*[6];
   newarg[0] = id_fix;
   newarg[1] = group->names[igroup];
   newarg[2] = (char *) "STORE";
   newarg[3] = (char *) "peratom";
   newarg[4] = (char *) "1";
-  newarg[5] = (char *) "3";
+  newarg[5] = ncolumn;
   modify->add_fix(6,newarg);
   fix = (FixStore *) modify->fix[modify->nfix-1];
   delete [] newarg;
 
   // store current velocities in fix store array
   // skip if reset from restart file
+  // correlator history is not restarted, so always clear it
+
+  if (correlator) {
+    double **voriginal = fix->astore;
+    int nlocal = atom->nlocal;
+    for (int i = 0; i < nlocal; i++)
+      for (int k = 0; k < 3; k++)
+        correlator->clear_state(&voriginal[i][3+k*nstate],0);
+  }
 
   if (fix->restart_reset) fix->restart_reset = 0;
   else {
@@ -88,6 +139,8 @@ ComputeVACF::~ComputeVACF()
 
   delete [] id_fix;
   delete [] vector;
+  delete correlator;
+  memory->destroy(array);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -111,6 +164,8 @@ void ComputeVACF::compute_vector()
 {
   invoked_vector = update->ntimestep;
 
+  if (correlator) sample();
+
   double **voriginal = fix->astore;
 
   double **v = atom->v;
@@ -152,5 +207,66 @@ void ComputeVACF::set_arrays(int i)
   voriginal[i][0] = v[i][0];
   voriginal[i][1] = v[i][1];
   voriginal[i][2] = v[i][2];
+  if (correlator)
+    for (int k = 0; k < 3; k++)
+      correlator->clear_state(&voriginal[i][3+k*nstate],0);
+}
+
+/* ----------------------------------------------------------------------
+   add current velocities as a new sample of the multiple-tau correlator
+   the first two samples set the sampling interval,
+     accesses in between samples are ignored
+------------------------------------------------------------------------- */
+
+void ComputeVACF::sample()
+{
+  if (update->ntimestep == last_sample) return;
+  if (last_sample >= 0) {
+    bigint delta = update->ntimestep - last_sample;
+    if (sample_every == 0) sample_every = delta;
+    else if (delta < sample_every) return;
+    else if (delta > sample_every)
+      error->all(FLERR,"Compute vacf multitau is not invoked "
+                 "at a constant interval");
+  }
+  last_sample = update->ntimestep;
+
+  double **voriginal = fix->astore;
+  double **v = atom->v;
+  int *mask = atom->mask;
+  int nlocal = atom->nlocal;
+
+  correlator->begin();
+  for (int i = 0; i < nlocal; i++)
+    if (mask[i] & groupbit)
+      for (int k = 0; k < 3; k++)
+        correlator->add(&voriginal[i][3+k*nstate],v[i][k],k);
+  correlator->end();
+}
+
+/* ----------------------------------------------------------------------
+   output averages of the multiple-tau correlator
+------------------------------------------------------------------------- */
+
+void ComputeVACF::compute_array()
+{
+  invoked_array = update->ntimestep;
+
+  sample();
+
+  // lag in timesteps, # of time origins, VACF per dimension and total
+
+  correlator->evaluate(1);
+
+  double norm = nvacf ? 1.0/nvacf : 0.0;
+  double every = sample_every ? sample_every : 1;
+  for (int m = 0; m < size_array_rows; m++) {
+    array[m][0] = correlator->lag[m]*every;
+    array[m][1] = correlator->count(m);
+    array[m][2] = correlator->value(0,m)*norm;
+    array[m][3] = correlator->value(1,m)*norm;
+    array[m][4] = correlator->value(2,m)*norm;
+    array[m][5] = array[m][2] + array[m][3] + array[m][4];
+  }
 }
 
@@ -30,12 +30,21 @@ class ComputeVACF : public Compute {
   ~ComputeVACF();
   void init();
   virtual void compute_vector();
+  virtual void compute_array();
   void set_arrays(int);
 
  protected:
   bigint nvacf;
   char *id_fix;
   class FixStore *fix;
+
+  int npoint,nlevel,nblock;     // multiple-tau settings, nlevel = 0 if off
+  int nstate;                   // per-atom correlator state per dimension
+  class Correlator *correlator;
+  bigint last_sample;           // timestep of last correlator sample
+  bigint sample_every;          // # of timesteps between samples
+
+  void sample();
 };
 
 }
@@ -55,4 +64,10 @@ E: Could not find compute vacf fix ID
 
 Self-explanatory.
 
+E: Compute vacf multitau is not invoked at a constant interval
+
+The multiple-tau correlator adds a sample each time the compute is
+invoked on a new timestep.  No sample may be skipped once the
+interval between the first two samples is set.
+
 */
@@ -0,0 +1,289 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------
+   multiple-tau correlator with block averaging of older values,
+   see Ramirez et al, J Chem Phys, 133, 154103 (2010)
+   level 0 stores the last Npoint values and computes lags 0 to Npoint-1
+   level K > 0 stores averages of Nblock^K consecutive values
+     and computes lags J*Nblock^K for J = Npoint/Nblock to Npoint-1
+   per-channel shift registers are stored by the caller, so that
+     per-atom channels can migrate with their atoms
+------------------------------------------------------------------------- */
+
+#include <mpi.h>
+#include <cstring>
+#include "correlator.h"
+#include "memory.h"
+
+using namespace LAMMPS_NS;
+
+/* ---------------------------------------------------------------------- */
+
+Correlator::Correlator(LAMMPS *lmp, int npoint_caller, int nblock_caller,
+                       int nlevel_caller, int nout_caller, int style_caller) :
+  Pointers(lmp)
+{
+  npoint = npoint_caller;
+  nblock = nblock_caller;
+  nlevel = nlevel_caller;
+  nout = nout_caller;
+  style = style_caller;
+
+  memory->create(nvalue,nlevel,"correlator:nvalue");
+  memory->create(insert,nlevel,"correlator:insert");
+  memory->create(first,nlevel,"correlator:first");
+  memory->create(last,nlevel,"correlator:last");
+  memory->create(sum,nout*nlevel*npoint,"correlator:sum");
+  memory->create(sumall,nout*nlevel*npoint,"correlator:sumall");
+  memory->create(ncount,nlevel*npoint,"correlator:ncount");
+
+  // list of lags, level 0 has all of its lags, higher levels skip the
+  // lags that overlap with the next lower level
+
+  nlag = npoint + (nlevel-1)*(npoint - npoint/nblock);
+  memory->create(lag,nlag,"correlator:lag");
+  memory->create(lagindex,nlag,"correlator:lagindex");
+
+  int ilag = 0;
+  double factor = 1.0;
+  for (int k = 0; k < nlevel; k++) {
+    for (int j = (k ? npoint/nblock : 0); j < npoint; j++) {
+      lag[ilag] = j*factor;
+      lagindex[ilag] = k*npoint + j;
+      ilag++;
+    }
+    factor *= nblock;
+  }
+
+  restart();
+}
+
+/* ---------------------------------------------------------------------- */
+
+Correlator::~Correlator()
+{
+  memory->destroy(nvalue);
+  memory->destroy(insert);
+  memory->destroy(first);
+  memory->destroy(last);
+  memory->destroy(sum);
+  memory->destroy(sumall);
+  memory->destroy(ncount);
+  memory->destroy(lag);
+  memory->destroy(lagindex);
+}
+
+/* ----------------------------------------------------------------------
+   # of doubles of state for one channel
+   crossflag = 1 for a cross-correlation with two inputs
+------------------------------------------------------------------------- */
+
+int Correlator::size_state(int crossflag)
+{
+  if (crossflag) return nlevel*(2*npoint+2);
+  return nlevel*(npoint+1);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Correlator::clear_state(double *state, int crossflag)
+{
+  int n = size_state(crossflag);
+  for (int i = 0; i < n; i++) state[i] = 0.0;
+}
+
+/* ----------------------------------------------------------------------
+   zero accumulated correlations, keep history of values
+------------------------------------------------------------------------- */
+
+void Correlator::reset()
+{
+  int n = nlevel*npoint;
+  for (int i = 0; i < nout*n; i++) sum[i] = sumall[i] = 0.0;
+  for (int i = 0; i < n; i++) ncount[i] = 0.0;
+}
+
+/* ----------------------------------------------------------------------
+   zero accumulated correlations and history of values
+   caller must also clear the state of all channels
+------------------------------------------------------------------------- */
+
+void Correlator::restart()
+{
+  reset();
+  nsample = 0;
+  for (int k = 0; k < nlevel; k++) nvalue[k] = 0;
+}
+
+/* ----------------------------------------------------------------------
+   start a new sample, must be followed by add() for every channel
+   and then by end()
+   level K receives a value in every Nblock^K-th sample
+------------------------------------------------------------------------- */
+
+void Correlator::begin()
+{
+  bigint n = nsample+1;
+  nactive = 1;
+  while (nactive < nlevel && n % nblock == 0) {
+    nactive++;
+    n /= nblock;
+  }
+
+  for (int k = 0; k < nactive; k++) {
+    insert[k] = nvalue[k] % npoint;
+    first[k] = k ? npoint/nblock : 0;
+    last[k] = (nvalue[k] < npoint) ? nvalue[k] : npoint-1;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   add new value X of one channel with a single input
+   correlation is accumulated into output IOUT
+   PRODUCT accumulates x(t)*x(t+lag), DIFFERENCE (x(t+lag)-x(t))^2
+------------------------------------------------------------------------- */
+
+void Correlator::add(double *state, double x, int iout)
+{
+  int j,k,ind,ind2;
+  double *shift,*corr;
+  double delta;
+
+  const int nstride = npoint+1;
+  double w = x;
+
+  for (k = 0; k < nactive; k++) {
+    shift = &state[k*nstride];
+    corr = &sum[(iout*nlevel + k)*npoint];
+    ind = insert[k];
+    shift[ind] = w;
+
+    if (style == PRODUCT) {
+      for (j = first[k]; j <= last[k]; j++) {
+        ind2 = ind - j;
+        if (ind2 < 0) ind2 += npoint;
+        corr[j] += shift[ind2]*w;
+      }
+    } else {
+      for (j = first[k]; j <= last[k]; j++) {
+        ind2 = ind - j;
+        if (ind2 < 0) ind2 += npoint;
+        delta = w - shift[ind2];
+        corr[j] += delta*delta;
+      }
+    }
+
+    // accumulate block average, pass it to next level when complete
+
+    if (k+1 < nactive) {
+      w = (shift[npoint] + w) / nblock;
+      shift[npoint] = 0.0;
+    } else if (k+1 < nlevel) shift[npoint] += w;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   add new values X,Y of one channel with two inputs
+   correlation x(t)*y(t+lag) is accumulated into output IOUT
+------------------------------------------------------------------------- */
+
+void Correlator::add(double *state, double x, double y, int iout)
+{
+  int j,k,ind,ind2;
+  double *shiftx,*shifty,*corr;
+
+  const int nstride = 2*npoint+2;
+  double wx = x;
+  double wy = y;
+
+  for (k = 0; k < nactive; k++) {
+    shiftx = &state[k*nstride];
+    shifty = &shiftx[npoint+1];
+    corr = &sum[(iout*nlevel + k)*npoint];
+    ind = insert[k];
+    shiftx[ind] = wx;
+    shifty[ind] = wy;
+
+    for (j = first[k]; j <= last[k]; j++) {
+      ind2 = ind - j;
+      if (ind2 < 0) ind2 += npoint;
+      corr[j] += shiftx[ind2]*wy;
+    }
+
+    if (k+1 < nactive) {
+      wx = (shiftx[npoint] + wx) / nblock;
+      wy = (shifty[npoint] + wy) / nblock;
+      shiftx[npoint] = shifty[npoint] = 0.0;
+    } else if (k+1 < nlevel) {
+      shiftx[npoint] += wx;
+      shifty[npoint] += wy;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   finish current sample
+------------------------------------------------------------------------- */
+
+void Correlator::end()
+{
+  for (int k = 0; k < nactive; k++) {
+    for (int j = first[k]; j <= last[k]; j++) ncount[k*npoint+j] += 1.0;
+    nvalue[k]++;
+  }
+  nsample++;
+}
+
+/* ----------------------------------------------------------------------
+   make accumulated correlations available via value()
+   sumflag = 1 to sum over procs, if channels are distributed
+------------------------------------------------------------------------- */
+
+void Correlator::evaluate(int sumflag)
+{
+  int n = nout*nlevel*npoint;
+  if (sumflag) MPI_Allreduce(sum,sumall,n,MPI_DOUBLE,MPI_SUM,world);
+  else memcpy(sumall,sum,n*sizeof(double));
+}
+
+/* ----------------------------------------------------------------------
+   correlation of output IOUT at lag ILAG, averaged over time origins
+   summed over channels adding into the same output
+------------------------------------------------------------------------- */
+
+double Correlator::value(int iout, int ilag)
+{
+  int m = lagindex[ilag];
+  if (ncount[m] == 0.0) return 0.0;
+  return sumall[iout*nlevel*npoint + m] / ncount[m];
+}
+
+/* ----------------------------------------------------------------------
+   # of time origins accumulated at lag ILAG
+------------------------------------------------------------------------- */
+
+double Correlator::count(int ilag)
+{
+  return ncount[lagindex[ilag]];
+}
+
+/* ---------------------------------------------------------------------- */
+
+double Correlator::memory_usage()
+{
+  double bytes = (2*nout+1)*nlevel*npoint * sizeof(double);
+  bytes += nlag * (sizeof(double) + sizeof(int));
+  bytes += nlevel * (sizeof(bigint) + 3*sizeof(int));
+  return bytes;
+}
@@ -0,0 +1,64 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifndef LMP_CORRELATOR_H
+#define LMP_CORRELATOR_H
+
+#include "pointers.h"
+
+namespace LAMMPS_NS {
+
+class Correlator : protected Pointers {
+ public:
+  enum{PRODUCT,DIFFERENCE};
+
+  int nlag;                 // # of lags at which correlation is computed
+  double *lag;              // lag of each point in units of samples
+
+  Correlator(class LAMMPS *, int, int, int, int, int);
+  ~Correlator();
+  int size_state(int);
+  void clear_state(double *, int);
+  void reset();
+  void restart();
+  void begin();
+  void add(double *, double, int);
+  void add(double *, double, double, int);
+  void end();
+  void evaluate(int);
+  double value(int, int);
+  double count(int);
+  double memory_usage();
+
+ private:
+  int npoint;               // # of points in each level
+  int nblock;               // # of values averaged when passing to next level
+  int nlevel;               // # of levels
+  int nout;                 // # of correlation functions
+  int style;                // PRODUCT or DIFFERENCE
+
+  bigint nsample;           // # of samples added so far
+  bigint *nvalue;           // # of values added to each level so far
+  int nactive;              // # of levels receiving a value in this sample
+  int *insert;              // index in shift register of new value per level
+  int *first,*last;         // range of lags updated per level in this sample
+
+  int *lagindex;            // index of each lag into sum and ncount
+  double *sum;              // sum of products for each output, level, lag
+  double *sumall;           // sum over procs, set by evaluate()
+  double *ncount;           // # of products summed for each level, lag
+};
+
+}
+
+#endif
@@ -87,6 +87,8 @@ Dump::Dump(LAMMPS *lmp, int /*narg*/, char **arg) : Pointers(lmp)
   append_flag = 0;
   buffer_allow = 0;
   buffer_flag = 0;
+  async_allow = 0;
+  async_flag = 0;
   padflag = 0;
   pbcflag = 0;
   delay_flag = 0;
@@ -109,6 +111,18 @@ Dump::Dump(LAMMPS *lmp, int /*narg*/, char **arg) : Pointers(lmp)
   xpbc = vpbc = NULL;
   imagepbc = NULL;
 
+  maxabuf = 0;
+  abuf = NULL;
+  maxasbuf = 0;
+  asbuf = NULL;
+  acount = NULL;
+  async_close = 0;
+
+#if defined(LAMMPS_ASYNC_DUMP)
+  async_state = ASYNC_IDLE;
+  async_running = 0;
+#endif
+
   // parse filename for special syntax
   // if contains '%', write one file per proc and replace % with proc-ID
   // if contains '*', write one file per timestep and replace * with timestep
@@ -158,6 +172,10 @@ Dump::Dump(LAMMPS *lmp, int /*narg*/, char **arg) : Pointers(lmp)
 
 Dump::~Dump()
 {
+  // let I/O thread finish the last snapshot before anything is freed
+
+  async_stop();
+
   delete [] id;
   delete [] style;
   delete [] filename;
@@ -183,6 +201,9 @@ Dump::~Dump()
   delete irregular;
 
   memory->destroy(sbuf);
+  memory->destroy(abuf);
+  memory->sfree(asbuf);
+  memory->destroy(acount);
 
   if (pbcflag) {
     memory->destroy(xpbc);
@@ -216,6 +237,8 @@ Dump::~Dump()
 
 void Dump::init()
 {
+  async_wait();
+
   init_style();
 
   if (!sort_flag) {
@@ -338,6 +361,11 @@ void Dump::write()
 
   if (delay_flag && update->ntimestep < delaystep) return;
 
+  // if I/O thread is still writing the previous snapshot, wait for it
+  // fp, buffers, and all format settings are then mine again
+
+  if (async_flag) async_wait();
+
   // if file per timestep, open new file
 
   if (multifile) openfile();
@@ -442,8 +470,9 @@ void Dump::write()
   // if buffering, convert doubles into strings
   // insure sbuf is sized for communicating
   // cannot buffer if output is to binary file
+  // if async, the conversion is done when gathering the snapshot
 
-  if (buffer_flag && !binary) {
+  if (buffer_flag && !binary && !async_flag) {
     nsme = convert_string(nme,buf);
     int nsmin,nsmax;
     MPI_Allreduce(&nsme,&nsmin,1,MPI_INT,MPI_MIN,world);
@@ -465,9 +494,13 @@ void Dump::write()
   MPI_Status status;
   MPI_Request request;
 
+  // async = gather buf of doubles into abuf, I/O thread does the output
+
+  if (async_flag) async_gather(nheader);
+
   // comm and output buf of doubles
 
-  if (buffer_flag == 0 || binary) {
+  else if (buffer_flag == 0 || binary) {
     if (filewriter) {
       for (int iproc = 0; iproc < nclusterprocs; iproc++) {
         if (iproc) {
@@ -523,8 +556,9 @@ void Dump::write()
   if (refreshflag) modify->compute[irefresh]->refresh();
 
   // if file per timestep, close file if I am filewriter
+  // if async, I/O thread closes it after writing the snapshot
 
-  if (multifile) {
+  if (multifile && !async_flag) {
     if (compressed) {
       if (filewriter && fp != NULL) pclose(fp);
     } else {
@@ -534,6 +568,201 @@ void Dump::write()
   }
 }
 
+/* ----------------------------------------------------------------------
+   gather packed buf of each proc in my cluster into abuf of filewriter
+   if buffering, filewriter converts each chunk into one string in asbuf
+   filewriter then hands abuf or asbuf to I/O thread and returns
+   non-filewriter procs send buf as for a synchronous dump
+------------------------------------------------------------------------- */
+
+void Dump::async_gather(bigint nheader)
+{
+  int tmp,nlines;
+  MPI_Status status;
+  MPI_Request request;
+
+  if (!filewriter) {
+    MPI_Recv(&tmp,0,MPI_INT,fileproc,0,world,MPI_STATUS_IGNORE);
+    MPI_Rsend(buf,nme*size_one,MPI_DOUBLE,fileproc,0,world);
+    return;
+  }
+
+  if (nheader*size_one > maxabuf) {
+    maxabuf = nheader*size_one;
+    memory->destroy(abuf);
+    memory->create(abuf,maxabuf,"dump:abuf");
+  }
+  if (acount == NULL) memory->create(acount,nclusterprocs,"dump:acount");
+
+  bigint offset = 0;
+  for (int iproc = 0; iproc < nclusterprocs; iproc++) {
+    if (iproc) {
+      int nrecv = MIN(maxbuf*size_one,maxabuf-offset);
+      MPI_Irecv(&abuf[offset],nrecv,MPI_DOUBLE,me+iproc,0,world,&request);
+      MPI_Send(&tmp,0,MPI_INT,me+iproc,0,world);
+      MPI_Wait(&request,&status);
+      MPI_Get_count(&status,MPI_DOUBLE,&nlines);
+      nlines /= size_one;
+    } else {
+      nlines = nme;
+      if (nme) memcpy(abuf,buf,(bigint) nme*size_one*sizeof(double));
+    }
+    acount[iproc] = nlines;
+    offset += (bigint) nlines*size_one;
+  }
+
+  // convert on this thread, since convert_string() may grow sbuf
+  // I/O thread then only writes the strings, acount = # of chars per proc
+
+  if (buffer_flag && !binary) {
+    bigint soffset = 0;
+    offset = 0;
+    for (int iproc = 0; iproc < nclusterprocs; iproc++) {
+      nlines = acount[iproc];
+      int nchars = convert_string(nlines,&abuf[offset]);
+      if (nchars < 0)
+        error->one(FLERR,
+                   "Too much buffered per-proc info for dump_modify async");
+      if (soffset + nchars > maxasbuf) {
+        maxasbuf = soffset + nchars;
+        asbuf = (char *) memory->srealloc(asbuf,maxasbuf,"dump:asbuf");
+      }
+      if (nchars) memcpy(&asbuf[soffset],sbuf,nchars);
+      acount[iproc] = nchars;
+      soffset += nchars;
+      offset += (bigint) nlines*size_one;
+    }
+  }
+
+  async_close = multifile;
+  async_post();
+}
+
+/* ----------------------------------------------------------------------
+   hand snapshot in abuf to I/O thread, start thread on first use
+   without thread support the snapshot is written right away
+------------------------------------------------------------------------- */
+
+void Dump::async_post()
+{
+#if defined(LAMMPS_ASYNC_DUMP)
+  if (!async_running) {
+    pthread_mutex_init(&async_mutex,NULL);
+    pthread_cond_init(&async_cond,NULL);
+    async_state = ASYNC_IDLE;
+    if (pthread_create(&async_thread,NULL,&Dump::async_worker,this))
+      error->one(FLERR,"Cannot create I/O thread for dump_modify async");
+    async_running = 1;
+  }
+
+  pthread_mutex_lock(&async_mutex);
+  async_state = ASYNC_BUSY;
+  pthread_cond_broadcast(&async_cond);
+  pthread_mutex_unlock(&async_mutex);
+#else
+  async_snapshot();
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   block until I/O thread is done with the previous snapshot
+------------------------------------------------------------------------- */
+
+void Dump::async_wait()
+{
+#if defined(LAMMPS_ASYNC_DUMP)
+  if (async_running) {
+    pthread_mutex_lock(&async_mutex);
+    while (async_state == ASYNC_BUSY)
+      pthread_cond_wait(&async_cond,&async_mutex);
+    pthread_mutex_unlock(&async_mutex);
+  }
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   finish pending snapshot and terminate I/O thread
+------------------------------------------------------------------------- */
+
+void Dump::async_stop()
+{
+#if defined(LAMMPS_ASYNC_DUMP)
+  if (!async_running) return;
+
+  pthread_mutex_lock(&async_mutex);
+  while (async_state == ASYNC_BUSY)
+    pthread_cond_wait(&async_cond,&async_mutex);
+  async_state = ASYNC_EXIT;
+  pthread_cond_broadcast(&async_cond);
+  pthread_mutex_unlock(&async_mutex);
+
+  pthread_join(async_thread,NULL);
+  pthread_cond_destroy(&async_cond);
+  pthread_mutex_destroy(&async_mutex);
+  async_running = 0;
+#endif
+}
+
+#if defined(LAMMPS_ASYNC_DUMP)
+
+/* ----------------------------------------------------------------------
+   I/O thread loop, writes each posted snapshot until told to exit
+   must not make any MPI calls
+------------------------------------------------------------------------- */
+
+void *Dump::async_worker(void *ptr)
+{
+  Dump *dump = (Dump *) ptr;
+
+  pthread_mutex_lock(&dump->async_mutex);
+  while (1) {
+    while (dump->async_state == ASYNC_IDLE)
+      pthread_cond_wait(&dump->async_cond,&dump->async_mutex);
+    if (dump->async_state == ASYNC_EXIT) break;
+    pthread_mutex_unlock(&dump->async_mutex);
+
+    dump->async_snapshot();
+
+    pthread_mutex_lock(&dump->async_mutex);
+    dump->async_state = ASYNC_IDLE;
+    pthread_cond_broadcast(&dump->async_cond);
+  }
+  pthread_mutex_unlock(&dump->async_mutex);
+
+  return NULL;
+}
+
+#endif
+
+/* ----------------------------------------------------------------------
+   write snapshot in abuf or asbuf to file, one chunk per proc in my cluster
+   called by I/O thread, so may not make any MPI calls or allocate memory
+------------------------------------------------------------------------- */
+
+void Dump::async_snapshot()
+{
+  bigint offset = 0;
+  for (int iproc = 0; iproc < nclusterprocs; iproc++) {
+    if (buffer_flag && !binary) {
+      write_data(acount[iproc],(double *) &asbuf[offset]);
+      offset += acount[iproc];
+    } else {
+      write_data(acount[iproc],&abuf[offset]);
+      offset += (bigint) acount[iproc]*size_one;
+    }
+  }
+  if (flush_flag && fp) fflush(fp);
+
+  if (async_close) {
+    if (compressed) {
+      if (fp != NULL) pclose(fp);
+    } else {
+      if (fp != NULL) fclose(fp);
+    }
+    fp = NULL;
+  }
+}
+
 /* ----------------------------------------------------------------------
    generic opening of a dump file
    ASCII or binary or gzipped
@@ -915,6 +1144,10 @@ void Dump::modify_params(int narg, char **arg)
 {
   if (narg == 0) error->all(FLERR,"Illegal dump_modify command");
 
+  // settings may not change while I/O thread writes a snapshot
+
+  async_wait();
+
   int iarg = 0;
   while (iarg < narg) {
     if (strcmp(arg[iarg],"append") == 0) {
@@ -924,6 +1157,20 @@ void Dump::modify_params(int narg, char **arg)
       else error->all(FLERR,"Illegal dump_modify command");
       iarg += 2;
 
+    } else if (strcmp(arg[iarg],"async") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal dump_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) async_flag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) async_flag = 0;
+      else error->all(FLERR,"Illegal dump_modify command");
+      if (async_flag && async_allow == 0)
+        error->all(FLERR,"Dump_modify async yes not allowed for this style");
+#if !defined(LAMMPS_ASYNC_DUMP)
+      if (async_flag)
+        error->all(FLERR,"Dump_modify async yes requires LAMMPS "
+                   "be built with -DLAMMPS_ASYNC_DUMP");
+#endif
+      iarg += 2;
+
     } else if (strcmp(arg[iarg],"buffer") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal dump_modify command");
       if (strcmp(arg[iarg+1],"yes") == 0) buffer_flag = 1;
@@ -1152,6 +1399,8 @@ bigint Dump::memory_usage()
 {
   bigint bytes = memory->usage(buf,size_one*maxbuf);
   bytes += memory->usage(sbuf,maxsbuf);
+  bytes += memory->usage(abuf,maxabuf);
+  bytes += maxasbuf;
   if (sort_flag) {
     if (sortcol == 0) bytes += memory->usage(ids,maxids);
     bytes += memory->usage(bufsort,size_one*maxsort);
@@ -18,6 +18,10 @@
 #include <cstdio>
 #include "pointers.h"
 
+#if defined(LAMMPS_ASYNC_DUMP)
+#include <pthread.h>
+#endif
+
 namespace LAMMPS_NS {
 
 class Dump : protected Pointers {
@@ -71,6 +75,8 @@ class Dump : protected Pointers {
   int append_flag;           // 1 if open file in append mode, 0 if not
   int buffer_allow;          // 1 if style allows for buffer_flag, 0 if not
   int buffer_flag;           // 1 if buffer output as one big string, 0 if not
+  int async_allow;           // 1 if style allows for async_flag, 0 if not
+  int async_flag;            // 1 if file writes are done by an I/O thread
   int padflag;               // timestep padding in filename
   int pbcflag;               // 1 if remap dumped atoms via PBC, 0 if not
   int singlefile_opened;     // 1 = one big file, already opened, else 0
@@ -136,6 +142,28 @@ class Dump : protected Pointers {
 
   class Irregular *irregular;
 
+  // dump_modify async, used by filewriter procs only
+  // abuf holds the snapshot of my cluster, acount the # of lines per proc
+  // if buffering, asbuf holds it as strings, acount the # of chars per proc
+  // abuf/asbuf are written by the I/O thread while buf is packed for the next
+
+  double *abuf;              // gathered snapshot of doubles
+  bigint maxabuf;            // size of abuf
+  char *asbuf;               // gathered snapshot converted to strings
+  bigint maxasbuf;           // size of asbuf
+  int *acount;               // # of lines or chars from each proc in cluster
+  int async_close;           // 1 if I/O thread closes fp after the snapshot
+
+#if defined(LAMMPS_ASYNC_DUMP)
+  enum{ASYNC_IDLE,ASYNC_BUSY,ASYNC_EXIT};
+  int async_state;           // state of the snapshot handed to the I/O thread
+  int async_running;         // 1 if the I/O thread was started
+  pthread_t async_thread;
+  pthread_mutex_t async_mutex;
+  pthread_cond_t async_cond;
+  static void *async_worker(void *);
+#endif
+
   virtual void init_style() = 0;
   virtual void openfile();
   virtual int modify_param(int, char **) {return 0;}
@@ -146,6 +174,12 @@ class Dump : protected Pointers {
   virtual void write_data(int, double *) = 0;
   void pbc_allocate();
 
+  void async_gather(bigint);
+  void async_post();
+  void async_wait();
+  void async_stop();
+  void async_snapshot();
+
   void sort();
 #if defined(LMP_QSORT)
   static int idcompare(const void *, const void *);
@@ -219,6 +253,25 @@ E: Dump_modify buffer yes not allowed for this style
 
 Self-explanatory.
 
+E: Dump_modify async yes not allowed for this style
+
+Only the atom, custom, cfg, local, and xyz dump styles can hand their
+file output to an I/O thread.
+
+E: Dump_modify async yes requires LAMMPS be built with -DLAMMPS_ASYNC_DUMP
+
+The I/O thread uses POSIX threads, which must be enabled when LAMMPS
+is built.
+
+E: Too much buffered per-proc info for dump_modify async
+
+The snapshot of a proc could not be converted into one string,
+because it would not fit in a 32-bit integer.
+
+E: Cannot create I/O thread for dump_modify async
+
+The pthread_create() call failed.
+
 E: Cannot use dump_modify fileper without % in dump file name
 
 Self-explanatory.
@@ -86,6 +86,7 @@ DumpCustom::DumpCustom(LAMMPS *lmp, int narg, char **arg) :
   memory->create(argindex,nfield,"dump:argindex");
 
   buffer_allow = 1;
+  async_allow = 1;
   buffer_flag = 1;
   iregion = -1;
   idregion = NULL;
@@ -56,6 +56,8 @@ DumpImage::DumpImage(LAMMPS *lmp, int narg, char **arg) :
   avec_line(NULL), avec_tri(NULL), avec_body(NULL), fixptr(NULL), image(NULL),
   chooseghost(NULL), bufcopy(NULL)
 {
+  async_allow = 0;
+
   if (binary || multiproc) error->all(FLERR,"Invalid dump image filename");
 
   // force binary flag on to avoid corrupted output on Windows
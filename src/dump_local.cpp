@@ -68,6 +68,7 @@ DumpLocal::DumpLocal(LAMMPS *lmp, int narg, char **arg) :
   vtype = new int[nfield];
 
   buffer_allow = 1;
+  async_allow = 1;
   buffer_flag = 1;
 
   // computes & fixes which the dump accesses
@@ -22,6 +22,7 @@
 #include "modify.h"
 #include "compute.h"
 #include "compute_chunk_atom.h"
+#include "comm.h"
 #include "input.h"
 #include "variable.h"
 #include "memory.h"
@@ -37,6 +38,7 @@ enum{NOSCALE,ATOM};
 enum{ONE,RUNNING,WINDOW};
 
 #define INVOKED_PERATOM 8
+#define RVOUS 1   // 0 for irregular, 1 for all2all
 
 /* ---------------------------------------------------------------------- */
 
@@ -165,6 +167,8 @@ FixAveChunk::FixAveChunk(LAMMPS *lmp, int narg, char **arg) :
   adof = domain->dimension;
   cdof = 0.0;
   overwrite = 0;
+  sparse = 0;
+  int fileflag = 0;
   format_user = NULL;
   format = (char *) " %g";
   char *title1 = NULL;
@@ -228,10 +232,17 @@ FixAveChunk::FixAveChunk(LAMMPS *lmp, int narg, char **arg) :
           error->one(FLERR,str);
         }
       }
+      fileflag = 1;
       iarg += 2;
     } else if (strcmp(arg[iarg],"overwrite") == 0) {
       overwrite = 1;
       iarg += 1;
+    } else if (strcmp(arg[iarg],"sparse") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix ave/chunk command");
+      if (strcmp(arg[iarg+1],"no") == 0) sparse = 0;
+      else if (strcmp(arg[iarg+1],"yes") == 0) sparse = 1;
+      else error->all(FLERR,"Illegal fix ave/chunk command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"format") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal fix ave/chunk command");
       delete [] format_user;
@@ -272,6 +283,8 @@ FixAveChunk::FixAveChunk(LAMMPS *lmp, int narg, char **arg) :
     error->all(FLERR,"Illegal fix ave/chunk command");
   if (ave != RUNNING && overwrite)
     error->all(FLERR,"Illegal fix ave/chunk command");
+  if (sparse && !fileflag)
+    error->all(FLERR,"Fix ave/chunk sparse yes requires file keyword");
 
   if (biasflag) {
     int i = modify->find_compute(id_bias);
@@ -389,14 +402,15 @@ FixAveChunk::FixAveChunk(LAMMPS *lmp, int narg, char **arg) :
     memory->sfree(earg);
   }
 
-  // this fix produces a global array
+  // this fix produces a global array, unless sparse is set
+  //   since then averaged values are only gathered to proc 0 for output
   // size_array_rows is variable and set by allocate()
 
   int compress = cchunk->compress;
   int ncoord = cchunk->ncoord;
   colextra = compress + ncoord;
 
-  array_flag = 1;
+  if (!sparse) array_flag = 1;
   size_array_cols = colextra + 1 + nvalues;
   size_array_rows_variable = 1;
   extarray = 0;
@@ -811,7 +825,8 @@ void FixAveChunk::end_of_step()
         values_many[m][j] += values_one[m][j];
     }
   } else if (normflag == SAMPLE) {
-    MPI_Allreduce(count_one,count_many,nchunk,MPI_DOUBLE,MPI_SUM,world);
+    if (sparse) sparse_count();
+    else MPI_Allreduce(count_one,count_many,nchunk,MPI_DOUBLE,MPI_SUM,world);
 
     if (cchunk->chunk_volume_vec) {
       volflag = VECTOR;
@@ -841,7 +856,8 @@ void FixAveChunk::end_of_step()
             values_many[m][j] += values_one[m][j]/count_many[m];
           }
         }
-      count_sum[m] += count_many[m];
+      if (sparse) count_sum[m] += count_one[m];
+      else count_sum[m] += count_many[m];
     }
   }
 
@@ -876,12 +892,23 @@ void FixAveChunk::end_of_step()
   //     check last so other options can take precedence
   // if normflag = SAMPLE, final is sum of ave / repeat
 
+  // if sparse is set, sum over procs only on proc 0
+  //   remaining operations are only needed for output by proc 0
+
   double repeat = nrepeat;
 
+  if (sparse) {
+    if (normflag == ALL) sparse_sum(count_many,values_many);
+    else sparse_sum(count_sum,values_many);
+    if (me) return;
+  }
+
   if (normflag == ALL) {
-    MPI_Allreduce(count_many,count_sum,nchunk,MPI_DOUBLE,MPI_SUM,world);
-    MPI_Allreduce(&values_many[0][0],&values_sum[0][0],nchunk*nvalues,
-                  MPI_DOUBLE,MPI_SUM,world);
+    if (!sparse) {
+      MPI_Allreduce(count_many,count_sum,nchunk,MPI_DOUBLE,MPI_SUM,world);
+      MPI_Allreduce(&values_many[0][0],&values_sum[0][0],nchunk*nvalues,
+                    MPI_DOUBLE,MPI_SUM,world);
+    }
 
     if (cchunk->chunk_volume_vec) {
       volflag = VECTOR;
@@ -913,8 +940,9 @@ void FixAveChunk::end_of_step()
       count_sum[m] /= repeat;
     }
   } else if (normflag == SAMPLE) {
-    MPI_Allreduce(&values_many[0][0],&values_sum[0][0],nchunk*nvalues,
-                  MPI_DOUBLE,MPI_SUM,world);
+    if (!sparse)
+      MPI_Allreduce(&values_many[0][0],&values_sum[0][0],nchunk*nvalues,
+                    MPI_DOUBLE,MPI_SUM,world);
     for (m = 0; m < nchunk; m++) {
       for (j = 0; j < nvalues; j++) values_sum[m][j] /= repeat;
       count_sum[m] /= repeat;
@@ -1059,6 +1087,239 @@ void FixAveChunk::end_of_step()
   }
 }
 
+/* ----------------------------------------------------------------------
+   sparse alternative to MPI_Allreduce() of count_one into count_many
+   only chunks with atoms on this proc are sent to their rendezvous proc,
+     which returns the summed count to each proc that sent the chunk
+   count_many is only set for chunks with atoms on this proc, else 0.0
+------------------------------------------------------------------------- */
+
+void FixAveChunk::sparse_count()
+{
+  int i,m;
+
+  int n = 0;
+  for (m = 0; m < nchunk; m++)
+    if (count_one[m] > 0.0) n++;
+
+  // setup input buf to rendezvous comm
+  // one datum for each chunk with atoms: datum = chunk index, me, count
+  // each proc assigned every Pth chunk
+
+  int nprocs = comm->nprocs;
+
+  int *proclist;
+  memory->create(proclist,n,"ave/chunk:proclist");
+  CountRvous *inbuf =
+    (CountRvous *) memory->smalloc((bigint) n*sizeof(CountRvous),
+                                   "ave/chunk:inbuf");
+
+  n = 0;
+  for (m = 0; m < nchunk; m++) {
+    if (count_one[m] == 0.0) continue;
+    proclist[n] = m % nprocs;
+    inbuf[n].chunk = m;
+    inbuf[n].proc = me;
+    inbuf[n].count = count_one[m];
+    n++;
+  }
+
+  // perform rendezvous operation
+
+  char *buf;
+  int nreturn = comm->rendezvous(RVOUS,n,(char *) inbuf,sizeof(CountRvous),0,
+                                 proclist,rendezvous_count,0,buf,
+                                 sizeof(CountRvous),(void *) this);
+  CountRvous *outbuf = (CountRvous *) buf;
+
+  memory->destroy(proclist);
+  memory->sfree(inbuf);
+
+  for (m = 0; m < nchunk; m++) count_many[m] = 0.0;
+  for (i = 0; i < nreturn; i++) count_many[outbuf[i].chunk] = outbuf[i].count;
+
+  memory->sfree(outbuf);
+}
+
+/* ----------------------------------------------------------------------
+   sparse alternative to MPI_Allreduce() of count and values_many
+     into count_sum and values_sum
+   only chunks with a count on this proc are sent to their rendezvous proc,
+     which sums them and sends the sums to proc 0
+   count_sum and values_sum are only set on proc 0
+------------------------------------------------------------------------- */
+
+void FixAveChunk::sparse_sum(double *count, double **values)
+{
+  int i,j,m;
+
+  int n = 0;
+  for (m = 0; m < nchunk; m++)
+    if (count[m] > 0.0) n++;
+
+  // setup input buf to rendezvous comm
+  // one datum for each chunk with a count: datum = chunk index, count, values
+  // each proc assigned every Pth chunk
+
+  int nprocs = comm->nprocs;
+  int nrow = 2 + nvalues;
+
+  int *proclist;
+  double *inbuf;
+  memory->create(proclist,n,"ave/chunk:proclist");
+  memory->create(inbuf,n*nrow,"ave/chunk:inbuf");
+
+  n = 0;
+  for (m = 0; m < nchunk; m++) {
+    if (count[m] == 0.0) continue;
+    proclist[n] = m % nprocs;
+    double *row = &inbuf[n*nrow];
+    row[0] = m;
+    row[1] = count[m];
+    for (j = 0; j < nvalues; j++) row[2+j] = values[m][j];
+    n++;
+  }
+
+  // perform rendezvous operation
+
+  char *buf;
+  int nreturn = comm->rendezvous(RVOUS,n,(char *) inbuf,nrow*sizeof(double),
+                                 0,proclist,rendezvous_sum,0,buf,
+                                 nrow*sizeof(double),(void *) this);
+  double *outbuf = (double *) buf;
+
+  memory->destroy(proclist);
+  memory->destroy(inbuf);
+
+  if (me == 0) {
+    for (m = 0; m < nchunk; m++) {
+      count_sum[m] = 0.0;
+      for (j = 0; j < nvalues; j++) values_sum[m][j] = 0.0;
+    }
+
+    for (i = 0; i < nreturn; i++) {
+      double *row = &outbuf[i*nrow];
+      m = static_cast<int> (row[0]);
+      count_sum[m] = row[1];
+      for (j = 0; j < nvalues; j++) values_sum[m][j] = row[2+j];
+    }
+  }
+
+  memory->sfree(outbuf);
+}
+
+/* ----------------------------------------------------------------------
+   callback from rendezvous operation
+   sum counts of each chunk assigned to this proc
+   return summed count to each proc that sent the chunk
+------------------------------------------------------------------------- */
+
+int FixAveChunk::rendezvous_count(int n, char *inbuf,
+                                  int &flag, int *&proclist, char *&outbuf,
+                                  void *ptr)
+{
+  int i,j,k;
+  double sum;
+
+  FixAveChunk *fptr = (FixAveChunk *) ptr;
+  Memory *memory = fptr->memory;
+  CountRvous *in = (CountRvous *) inbuf;
+
+  qsort(in,n,sizeof(CountRvous),compare_count);
+
+  memory->create(proclist,n,"ave/chunk:proclist");
+  CountRvous *out =
+    (CountRvous *) memory->smalloc((bigint) n*sizeof(CountRvous),
+                                   "ave/chunk:outbuf");
+
+  for (i = 0; i < n; i = j) {
+    sum = 0.0;
+    for (j = i; j < n && in[j].chunk == in[i].chunk; j++) sum += in[j].count;
+    for (k = i; k < j; k++) {
+      proclist[k] = in[k].proc;
+      out[k].chunk = in[k].chunk;
+      out[k].proc = in[k].proc;
+      out[k].count = sum;
+    }
+  }
+
+  outbuf = (char *) out;
+  flag = 2;
+  return n;
+}
+
+/* ----------------------------------------------------------------------
+   callback from rendezvous operation
+   sum count and values of each chunk assigned to this proc
+   return one summed datum per chunk to proc 0
+------------------------------------------------------------------------- */
+
+int FixAveChunk::rendezvous_sum(int n, char *inbuf,
+                                int &flag, int *&proclist, char *&outbuf,
+                                void *ptr)
+{
+  int i,j,m;
+
+  FixAveChunk *fptr = (FixAveChunk *) ptr;
+  Memory *memory = fptr->memory;
+  int nrow = 2 + fptr->nvalues;
+  double *in = (double *) inbuf;
+
+  qsort(in,n,nrow*sizeof(double),compare_row);
+
+  int nout = 0;
+  for (i = 0; i < n; i = j) {
+    for (j = i+1; j < n && in[j*nrow] == in[i*nrow]; j++);
+    nout++;
+  }
+
+  double *out;
+  memory->create(proclist,nout,"ave/chunk:proclist");
+  out = (double *) memory->smalloc((bigint) nout*nrow*sizeof(double),
+                                   "ave/chunk:outbuf");
+
+  nout = 0;
+  for (i = 0; i < n; i = j) {
+    double *row = &out[nout*nrow];
+    for (m = 0; m < nrow; m++) row[m] = in[i*nrow+m];
+    for (j = i+1; j < n && in[j*nrow] == in[i*nrow]; j++)
+      for (m = 1; m < nrow; m++) row[m] += in[j*nrow+m];
+    proclist[nout++] = 0;
+  }
+
+  outbuf = (char *) out;
+  flag = 2;
+  return nout;
+}
+
+/* ----------------------------------------------------------------------
+   comparison function invoked by qsort() on count datums
+   sort by chunk index
+------------------------------------------------------------------------- */
+
+int FixAveChunk::compare_count(const void *iptr, const void *jptr)
+{
+  const CountRvous *i = (const CountRvous *) iptr;
+  const CountRvous *j = (const CountRvous *) jptr;
+  if (i->chunk < j->chunk) return -1;
+  if (i->chunk > j->chunk) return 1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   comparison function invoked by qsort() on rows of doubles
+   sort by chunk index stored in first value of row
+------------------------------------------------------------------------- */
+
+int FixAveChunk::compare_row(const void *iptr, const void *jptr)
+{
+  const double *i = (const double *) iptr;
+  const double *j = (const double *) jptr;
+  if (i[0] < j[0]) return -1;
+  if (i[0] > j[0]) return 1;
+  return 0;
+}
+
 /* ----------------------------------------------------------------------
    allocate all per-chunk vectors
 ------------------------------------------------------------------------- */
@@ -40,6 +40,7 @@ class FixAveChunk : public Fix {
   int me,nvalues;
   int nrepeat,nfreq,irepeat;
   int normflag,scaleflag,overwrite,biasflag,colextra;
+  int sparse;             // 1 if per-chunk sums are reduced via rendezvous
   bigint nvalid,nvalid_last;
   double adof,cdof;
   char *format,*format_user;
@@ -77,6 +78,21 @@ class FixAveChunk : public Fix {
 
   void allocate();
   bigint nextvalid();
+
+  // data and methods for sparse reduction via rendezvous comm
+
+  struct CountRvous {
+    int chunk,proc;
+    double count;
+  };
+
+  void sparse_count();
+  void sparse_sum(double *, double **);
+
+  static int rendezvous_count(int, char *, int &, int *&, char *&, void *);
+  static int rendezvous_sum(int, char *, int &, int *&, char *&, void *);
+  static int compare_count(const void *, const void *);
+  static int compare_row(const void *, const void *);
 };
 
 }
@@ -101,6 +117,11 @@ E: Cannot open fix ave/chunk file %s
 The specified file cannot be opened.  Check that the path and name are
 correct.
 
+E: Fix ave/chunk sparse yes requires file keyword
+
+With sparse yes, the averaged values are only gathered to proc 0
+for output to a file, so a file must be specified.
+
 E: Could not find compute ID for temperature bias
 
 Self-explanatory.
@@ -29,6 +29,7 @@
 #include "memory.h"
 #include "error.h"
 #include "force.h"
+#include "correlator.h"
 
 using namespace LAMMPS_NS;
 using namespace FixConst;
@@ -46,7 +47,8 @@ enum{AUTO,UPPER,LOWER,AUTOUPPER,AUTOLOWER,FULL};
 FixAveCorrelate::FixAveCorrelate(LAMMPS * lmp, int narg, char **arg):
   Fix (lmp, narg, arg),
   nvalues(0), which(NULL), argindex(NULL), value2index(NULL), ids(NULL), fp(NULL),
-  count(NULL), values(NULL), corr(NULL), save_count(NULL), save_corr(NULL)
+  count(NULL), values(NULL), corr(NULL), save_count(NULL), save_corr(NULL),
+  correlator(NULL), mtstate(NULL)
 {
   if (narg < 7) error->all(FLERR,"Illegal fix ave/correlate command");
 
@@ -114,6 +116,8 @@ FixAveCorrelate::FixAveCorrelate(LAMMPS * lmp, int narg, char **arg):
   prefactor = 1.0;
   fp = NULL;
   overwrite = 0;
+  nlevel = 0;
+  nblock = 2;
   char *title1 = NULL;
   char *title2 = NULL;
   char *title3 = NULL;
@@ -157,6 +161,13 @@ FixAveCorrelate::FixAveCorrelate(LAMMPS * lmp, int narg, char **arg):
     } else if (strcmp(arg[iarg],"overwrite") == 0) {
       overwrite = 1;
       iarg += 1;
+    } else if (strcmp(arg[iarg],"multitau") == 0) {
+      if (iarg+3 > narg) error->all(FLERR,"Illegal fix ave/correlate command");
+      nlevel = force->inumeric(FLERR,arg[iarg+1]);
+      nblock = force->inumeric(FLERR,arg[iarg+2]);
+      if (nlevel <= 0 || nblock < 2)
+        error->all(FLERR,"Illegal fix ave/correlate command");
+      iarg += 3;
     } else if (strcmp(arg[iarg],"title1") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal fix ave/correlate command");
       delete [] title1;
@@ -188,7 +199,9 @@ FixAveCorrelate::FixAveCorrelate(LAMMPS * lmp, int narg, char **arg):
     error->all(FLERR,"Illegal fix ave/correlate command");
   if (nfreq % nevery)
     error->all(FLERR,"Illegal fix ave/correlate command");
-  if (ave == ONE && nfreq < (nrepeat-1)*nevery)
+  if (ave == ONE && nlevel == 0 && nfreq < (nrepeat-1)*nevery)
+    error->all(FLERR,"Illegal fix ave/correlate command");
+  if (nlevel && (nrepeat < nblock || nrepeat % nblock))
     error->all(FLERR,"Illegal fix ave/correlate command");
   if (ave != RUNNING && overwrite)
     error->all(FLERR,"Illegal fix ave/correlate command");
@@ -300,24 +313,41 @@ FixAveCorrelate::FixAveCorrelate(LAMMPS * lmp, int narg, char **arg):
   // allocate and initialize memory for averaging
   // set count and corr to zero since they accumulate
   // also set save versions to zero in case accessed via compute_array()
+  // multiple-tau correlator keeps its own history and accumulators,
+  //   with Nrepeat points in each of its Nlevel levels
+
+  if (nlevel) {
+    correlator = new Correlator(lmp,nrepeat,nblock,nlevel,npair,
+                                Correlator::PRODUCT);
+    nrow = correlator->nlag;
+    int nstate = correlator->size_state(1);
+    memory->create(mtstate,npair,nstate,"ave/correlate:mtstate");
+    for (int i = 0; i < npair; i++) correlator->clear_state(mtstate[i],1);
+    memory->create(values,1,nvalues,"ave/correlate:values");
+  } else {
+    nrow = nrepeat;
+    memory->create(values,nrepeat,nvalues,"ave/correlate:values");
+    memory->create(count,nrepeat,"ave/correlate:count");
+    memory->create(corr,nrepeat,npair,"ave/correlate:corr");
+    for (int i = 0; i < nrepeat; i++) {
+      count[i] = 0;
+      for (int j = 0; j < npair; j++) corr[i][j] = 0.0;
+    }
+  }
 
-  memory->create(values,nrepeat,nvalues,"ave/correlate:values");
-  memory->create(count,nrepeat,"ave/correlate:count");
-  memory->create(save_count,nrepeat,"ave/correlate:save_count");
-  memory->create(corr,nrepeat,npair,"ave/correlate:corr");
-  memory->create(save_corr,nrepeat,npair,"ave/correlate:save_corr");
+  memory->create(save_count,nrow,"ave/correlate:save_count");
+  memory->create(save_corr,nrow,npair,"ave/correlate:save_corr");
 
   int i,j;
-  for (i = 0; i < nrepeat; i++) {
-    save_count[i] = count[i] = 0;
-    for (j = 0; j < npair; j++)
-      save_corr[i][j] = corr[i][j] = 0.0;
+  for (i = 0; i < nrow; i++) {
+    save_count[i] = 0;
+    for (j = 0; j < npair; j++) save_corr[i][j] = 0.0;
   }
 
   // this fix produces a global array
 
   array_flag = 1;
-  size_array_rows = nrepeat;
+  size_array_rows = nrow;
   size_array_cols = npair+2;
   extarray = 0;
 
@@ -349,6 +379,8 @@ FixAveCorrelate::~FixAveCorrelate()
   memory->destroy(save_count);
   memory->destroy(corr);
   memory->destroy(save_corr);
+  memory->destroy(mtstate);
+  delete correlator;
 
   if (fp && me == 0) fclose(fp);
 }
@@ -395,6 +427,10 @@ void FixAveCorrelate::init()
     lastindex = -1;
     firstindex = 0;
     nsample = 0;
+    if (correlator) {
+      correlator->restart();
+      for (int i = 0; i < npair; i++) correlator->clear_state(mtstate[i],1);
+    }
     nvalid = nextvalid();
     modify->addstep_compute_all(nvalid);
   }
@@ -431,9 +467,10 @@ void FixAveCorrelate::end_of_step()
   modify->clearstep_compute();
 
   // lastindex = index in values ring of latest time sample
+  // multiple-tau correlator only needs latest sample
 
   lastindex++;
-  if (lastindex == nrepeat) lastindex = 0;
+  if (lastindex == nrepeat || correlator) lastindex = 0;
 
   for (i = 0; i < nvalues; i++) {
     m = value2index[i];
@@ -501,14 +538,23 @@ void FixAveCorrelate::end_of_step()
 
   // save results in save_count and save_corr
 
-  for (i = 0; i < nrepeat; i++) {
-    save_count[i] = count[i];
-    if (count[i])
-      for (j = 0; j < npair; j++)
-        save_corr[i][j] = prefactor*corr[i][j]/count[i];
-    else
+  if (correlator) {
+    correlator->evaluate(0);
+    for (i = 0; i < nrow; i++) {
+      save_count[i] = static_cast<int> (correlator->count(i));
       for (j = 0; j < npair; j++)
-        save_corr[i][j] = 0.0;
+        save_corr[i][j] = prefactor*correlator->value(j,i);
+    }
+  } else {
+    for (i = 0; i < nrepeat; i++) {
+      save_count[i] = count[i];
+      if (count[i])
+        for (j = 0; j < npair; j++)
+          save_corr[i][j] = prefactor*corr[i][j]/count[i];
+      else
+        for (j = 0; j < npair; j++)
+          save_corr[i][j] = 0.0;
+    }
   }
 
   // output result to file
@@ -516,12 +562,12 @@ void FixAveCorrelate::end_of_step()
   if (fp && me == 0) {
     clearerr(fp);
     if (overwrite) fseek(fp,filepos,SEEK_SET);
-    fprintf(fp,BIGINT_FORMAT " %d\n",ntimestep,nrepeat);
-    for (i = 0; i < nrepeat; i++) {
-      fprintf(fp,"%d %d %d",i+1,i*nevery,count[i]);
-      if (count[i])
+    fprintf(fp,BIGINT_FORMAT " %d\n",ntimestep,nrow);
+    for (i = 0; i < nrow; i++) {
+      fprintf(fp,"%d %.15g %d",i+1,delta(i),save_count[i]);
+      if (save_count[i])
         for (j = 0; j < npair; j++)
-          fprintf(fp," %g",prefactor*corr[i][j]/count[i]);
+          fprintf(fp," %g",save_corr[i][j]);
       else
         for (j = 0; j < npair; j++)
           fprintf(fp," 0.0");
@@ -540,8 +586,14 @@ void FixAveCorrelate::end_of_step()
 
   // zero accumulation if requested
   // recalculate Cij(0)
-
-  if (ave == ONE) {
+  // multiple-tau correlator also clears history of values on all levels,
+  //   so no pair of values spans two Nfreq windows, as for direct sums
+
+  if (ave == ONE && correlator) {
+    correlator->restart();
+    for (i = 0; i < npair; i++) correlator->clear_state(mtstate[i],1);
+    accumulate_multitau();
+  } else if (ave == ONE) {
     for (i = 0; i < nrepeat; i++) {
       count[i] = 0;
       for (j = 0; j < npair; j++)
@@ -560,6 +612,11 @@ void FixAveCorrelate::accumulate()
 {
   int i,j,k,m,n,ipair;
 
+  if (correlator) {
+    accumulate_multitau();
+    return;
+  }
+
   for (k = 0; k < nsample; k++) count[k]++;
 
   if (type == AUTO) {
@@ -625,13 +682,76 @@ void FixAveCorrelate::accumulate()
   }
 }
 
+/* ----------------------------------------------------------------------
+   add latest values to multiple-tau correlator
+   one correlator channel per pair, same pair order as accumulate()
+------------------------------------------------------------------------- */
+
+void FixAveCorrelate::accumulate_multitau()
+{
+  int i,j,ipair;
+  double *v = values[0];
+
+  correlator->begin();
+
+  ipair = 0;
+  if (type == AUTO) {
+    for (i = 0; i < nvalues; i++) {
+      correlator->add(mtstate[ipair],v[i],ipair);
+      ipair++;
+    }
+  } else if (type == UPPER) {
+    for (i = 0; i < nvalues; i++)
+      for (j = i+1; j < nvalues; j++) {
+        correlator->add(mtstate[ipair],v[i],v[j],ipair);
+        ipair++;
+      }
+  } else if (type == LOWER) {
+    for (i = 0; i < nvalues; i++)
+      for (j = 0; j < i; j++) {
+        correlator->add(mtstate[ipair],v[i],v[j],ipair);
+        ipair++;
+      }
+  } else if (type == AUTOUPPER) {
+    for (i = 0; i < nvalues; i++)
+      for (j = i; j < nvalues; j++) {
+        correlator->add(mtstate[ipair],v[i],v[j],ipair);
+        ipair++;
+      }
+  } else if (type == AUTOLOWER) {
+    for (i = 0; i < nvalues; i++)
+      for (j = 0; j <= i; j++) {
+        correlator->add(mtstate[ipair],v[i],v[j],ipair);
+        ipair++;
+      }
+  } else if (type == FULL) {
+    for (i = 0; i < nvalues; i++)
+      for (j = 0; j < nvalues; j++) {
+        correlator->add(mtstate[ipair],v[i],v[j],ipair);
+        ipair++;
+      }
+  }
+
+  correlator->end();
+}
+
+/* ----------------------------------------------------------------------
+   time delta of row I of output
+------------------------------------------------------------------------- */
+
+double FixAveCorrelate::delta(int i)
+{
+  if (correlator) return correlator->lag[i]*nevery;
+  return 1.0*i*nevery;
+}
+
 /* ----------------------------------------------------------------------
    return I,J array value
 ------------------------------------------------------------------------- */
 
 double FixAveCorrelate::compute_array(int i, int j)
 {
-  if (j == 0) return 1.0*i*nevery;
+  if (j == 0) return delta(i);
   else if (j == 1) return 1.0*save_count[i];
   else if (save_count[i]) return save_corr[i][j-2];
   return 0.0;
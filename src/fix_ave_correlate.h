@@ -58,7 +58,14 @@ class FixAveCorrelate : public Fix {
   int *save_count;     // saved values at Nfreq for output via compute_array()
   double **save_corr;
 
+  int nlevel,nblock;   // multiple-tau correlator settings, nlevel = 0 if off
+  int nrow;            // # of output rows = # of lags
+  class Correlator *correlator;
+  double **mtstate;    // correlator state for each pair
+
   void accumulate();
+  void accumulate_multitau();
+  double delta(int);
   bigint nextvalid();
 };
 
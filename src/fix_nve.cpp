@@ -19,6 +19,7 @@
 #include "update.h"
 #include "respa.h"
 #include "error.h"
+#include "memory.h"
 
 using namespace LAMMPS_NS;
 using namespace FixConst;
@@ -33,6 +34,15 @@ FixNVE::FixNVE(LAMMPS *lmp, int narg, char **arg) :
 
   dynamic_group_allow = 1;
   time_integrate = 1;
+
+  dtfm_type = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+FixNVE::~FixNVE()
+{
+  memory->destroy(dtfm_type);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -78,6 +88,35 @@ void FixNVE::initial_integrate(int /*vflag*/)
   int nlocal = atom->nlocal;
   if (igroup == atom->firstgroup) nlocal = atom->nfirst;
 
+  // group all: no mask test, sweep x,v,f as flat 3*nlocal blocks
+  //   so the compiler can vectorize the update
+
+  if (igroup == 0) {
+    double * _noalias const xx = x[0];
+    double * _noalias const vv = v[0];
+    const double * _noalias const ff = f[0];
+
+    if (rmass) {
+      for (int i = 0; i < nlocal; i++) {
+        dtfm = dtf / rmass[i];
+        for (int k = 3*i; k < 3*i+3; k++) {
+          vv[k] += dtfm * ff[k];
+          xx[k] += dtv * vv[k];
+        }
+      }
+    } else {
+      setup_dtfm_type();
+      for (int i = 0; i < nlocal; i++) {
+        dtfm = dtfm_type[type[i]];
+        for (int k = 3*i; k < 3*i+3; k++) {
+          vv[k] += dtfm * ff[k];
+          xx[k] += dtv * vv[k];
+        }
+      }
+    }
+    return;
+  }
+
   if (rmass) {
     for (int i = 0; i < nlocal; i++)
       if (mask[i] & groupbit) {
@@ -121,6 +160,25 @@ void FixNVE::final_integrate()
   int nlocal = atom->nlocal;
   if (igroup == atom->firstgroup) nlocal = atom->nfirst;
 
+  if (igroup == 0) {
+    double * _noalias const vv = v[0];
+    const double * _noalias const ff = f[0];
+
+    if (rmass) {
+      for (int i = 0; i < nlocal; i++) {
+        dtfm = dtf / rmass[i];
+        for (int k = 3*i; k < 3*i+3; k++) vv[k] += dtfm * ff[k];
+      }
+    } else {
+      setup_dtfm_type();
+      for (int i = 0; i < nlocal; i++) {
+        dtfm = dtfm_type[type[i]];
+        for (int k = 3*i; k < 3*i+3; k++) vv[k] += dtfm * ff[k];
+      }
+    }
+    return;
+  }
+
   if (rmass) {
     for (int i = 0; i < nlocal; i++)
       if (mask[i] & groupbit) {
@@ -141,6 +199,21 @@ void FixNVE::final_integrate()
   }
 }
 
+/* ----------------------------------------------------------------------
+   per-type dtf/mass so the group-all loops need no division per atom
+   recomputed each call since dtf changes between rRESPA levels
+------------------------------------------------------------------------- */
+
+void FixNVE::setup_dtfm_type()
+{
+  int ntypes = atom->ntypes;
+  double *mass = atom->mass;
+
+  if (dtfm_type == NULL) memory->create(dtfm_type,ntypes+1,"nve:dtfm_type");
+  for (int itype = 1; itype <= ntypes; itype++)
+    dtfm_type[itype] = dtf / mass[itype];
+}
+
 /* ---------------------------------------------------------------------- */
 
 void FixNVE::initial_integrate_respa(int vflag, int ilevel, int /*iloop*/)
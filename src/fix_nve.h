@@ -27,7 +27,7 @@ namespace LAMMPS_NS {
 class FixNVE : public Fix {
  public:
   FixNVE(class LAMMPS *, int, char **);
-  virtual ~FixNVE() {}
+  virtual ~FixNVE();
   int setmask();
   virtual void init();
   virtual void initial_integrate(int);
@@ -40,6 +40,9 @@ class FixNVE : public Fix {
   double dtv,dtf;
   double *step_respa;
   int mass_require;
+  double *dtfm_type;             // dtf/mass per atom type for group all
+
+  void setup_dtfm_type();
 };
 
 }
@@ -72,7 +72,7 @@ void FixNVELimit::init()
   // warn if using fix shake, which will lead to invalid constraint forces
 
   for (int i = 0; i < modify->nfix; i++)
-    if ((strcmp(modify->fix[i]->style,"shake") == 0)
+    if ((strncmp(modify->fix[i]->style,"shake",5) == 0)
         || (strcmp(modify->fix[i]->style,"rattle") == 0)) {
       if (comm->me == 0)
         error->warning(FLERR,"Should not use fix nve/limit with fix shake or fix rattle");
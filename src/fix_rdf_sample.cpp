@@ -0,0 +1,75 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include <cstring>
+#include "fix_rdf_sample.h"
+#include "compute_rdf.h"
+#include "force.h"
+#include "modify.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+using namespace FixConst;
+
+/* ----------------------------------------------------------------------
+   internal fix created by compute rdf with the accumulate keyword
+   adds a sample to the compute's histograms every Nevery steps
+------------------------------------------------------------------------- */
+
+FixRDFSample::FixRDFSample(LAMMPS *lmp, int narg, char **arg) :
+  Fix(lmp, narg, arg), idcompute(NULL), crdf(NULL)
+{
+  if (narg != 5) error->all(FLERR,"Illegal fix RDF_SAMPLE command");
+
+  int n = strlen(arg[3]) + 1;
+  idcompute = new char[n];
+  strcpy(idcompute,arg[3]);
+
+  nevery = force->inumeric(FLERR,arg[4]);
+  if (nevery <= 0) error->all(FLERR,"Illegal fix RDF_SAMPLE command");
+}
+
+/* ---------------------------------------------------------------------- */
+
+FixRDFSample::~FixRDFSample()
+{
+  delete [] idcompute;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int FixRDFSample::setmask()
+{
+  int mask = 0;
+  mask |= END_OF_STEP;
+  return mask;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixRDFSample::init()
+{
+  int icompute = modify->find_compute(idcompute);
+  if (icompute < 0)
+    error->all(FLERR,"Compute ID for fix RDF_SAMPLE does not exist");
+  if (strcmp(modify->compute[icompute]->style,"rdf") != 0)
+    error->all(FLERR,"Fix RDF_SAMPLE compute is not a compute rdf");
+  crdf = (ComputeRDF *) modify->compute[icompute];
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixRDFSample::end_of_step()
+{
+  crdf->sample();
+}
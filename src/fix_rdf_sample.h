@@ -0,0 +1,61 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef FIX_CLASS
+
+FixStyle(RDF_SAMPLE,FixRDFSample)
+
+#else
+
+#ifndef LMP_FIX_RDF_SAMPLE_H
+#define LMP_FIX_RDF_SAMPLE_H
+
+#include "fix.h"
+
+namespace LAMMPS_NS {
+
+class FixRDFSample : public Fix {
+ public:
+  FixRDFSample(class LAMMPS *, int, char **);
+  ~FixRDFSample();
+  int setmask();
+  void init();
+  void end_of_step();
+
+ private:
+  char *idcompute;
+  class ComputeRDF *crdf;
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal ... command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
+E: Compute ID for fix RDF_SAMPLE does not exist
+
+The compute rdf command that created this fix has been deleted.
+
+E: Fix RDF_SAMPLE compute is not a compute rdf
+
+Self-explanatory.
+
+*/
@@ -134,7 +134,7 @@ void FixTempCSLD::init()
 
   int has_shake = 0;
   for (int i = 0; i < modify->nfix; i++)
-    if ((strcmp(modify->fix[i]->style,"shake") == 0)
+    if ((strncmp(modify->fix[i]->style,"shake",5) == 0)
         || (strcmp(modify->fix[i]->style,"rattle") == 0)) ++has_shake;
 
   if (has_shake > 0)
@@ -57,6 +57,10 @@ KSpace::KSpace(LAMMPS *lmp) : Pointers(lmp)
   collective_flag = 0;
 #endif
 
+  fft_overlap = 0;
+  every = 1;
+  every_extrapolate = 0;
+
   kewaldflag = 0;
 
   order_6 = 5;
@@ -521,6 +525,24 @@ void KSpace::modify_params(int narg, char **arg)
       else if (strcmp(arg[iarg+1],"no") == 0) collective_flag = 0;
       else error->all(FLERR,"Illegal kspace_modify command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"every") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
+      every = force->inumeric(FLERR,arg[iarg+1]);
+      if (every <= 0) error->all(FLERR,"Illegal kspace_modify command");
+      iarg += 2;
+      if (iarg < narg && strcmp(arg[iarg],"impulse") == 0) {
+        every_extrapolate = 0;
+        iarg++;
+      } else if (iarg < narg && strcmp(arg[iarg],"extrapolate") == 0) {
+        every_extrapolate = 1;
+        iarg++;
+      }
+    } else if (strcmp(arg[iarg],"fft") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
+      if (strcmp(arg[iarg+1],"pencil") == 0) fft_overlap = 0;
+      else if (strcmp(arg[iarg+1],"pencil_overlap") == 0) fft_overlap = 1;
+      else error->all(FLERR,"Illegal kspace_modify command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"diff") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
       if (strcmp(arg[iarg+1],"ad") == 0) differentiation_flag = 1;
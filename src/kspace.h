@@ -88,6 +88,10 @@ class KSpace : protected Pointers {
   int compute_flag;               // 0 if skip compute()
   int fftbench;                   // 0 if skip FFT timing
   int collective_flag;            // 1 if use MPI collectives for FFT/remap
+  int fft_overlap;                // 1 if pipeline 1d FFTs with remaps
+  int every;                      // solve only every this many steps
+  int every_extrapolate;          // 1 if extrapolate forces in between
+                                  // 0 if apply them as impulse
   int stagger_flag;               // 1 if using staggered PPPM grids
 
   double splittol;                // tolerance for when to truncate splitting
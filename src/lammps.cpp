@@ -42,6 +42,7 @@
 #include "modify.h"
 #include "group.h"
 #include "output.h"
+#include "write_restart.h"
 #include "citeme.h"
 #include "accelerator_kokkos.h"
 #include "accelerator_omp.h"
@@ -830,6 +831,10 @@ void LAMMPS::init()
 
 void LAMMPS::destroy()
 {
+  // finish pending async restart file while errors can still be reported
+
+  if (output && output->restart) output->restart->async_stop();
+
   delete update;
   update = NULL;
 
@@ -39,6 +39,11 @@ NeighList::NeighList(LAMMPS *lmp) : Pointers(lmp)
   numneigh = NULL;
   firstneigh = NULL;
 
+  interior = 0;
+  ninterior = 0;
+  maxboundary = 0;
+  iboundary = NULL;
+
   // defaults, but may be reset by post_constructor()
 
   occasional = 0;
@@ -115,6 +120,7 @@ NeighList::~NeighList()
     delete [] ipage_middle;
   }
 
+  memory->destroy(iboundary);
   delete [] iskip;
   memory->destroy(ijskip);
 }
@@ -238,6 +244,42 @@ void NeighList::grow(int nlocal, int nall)
   }
 }
 
+/* ----------------------------------------------------------------------
+   reorder ilist so I atoms whose neighbors are all owned atoms come first
+   set ninterior = # of such atoms, relative order of both parts is kept
+   interior atoms can be computed before ghost atom coords are current,
+     see the comm_modify overlap option
+   only the first inum entries are reordered, ghost entries are left as is
+------------------------------------------------------------------------- */
+
+void NeighList::partition_interior()
+{
+  int i,ii,jj,jnum,nboundary;
+  int *jlist;
+
+  if (inum > maxboundary) {
+    maxboundary = maxatom;
+    memory->destroy(iboundary);
+    memory->create(iboundary,maxboundary,"neighlist:iboundary");
+  }
+
+  const int nlocal = atom->nlocal;
+
+  ninterior = nboundary = 0;
+  for (ii = 0; ii < inum; ii++) {
+    i = ilist[ii];
+    jlist = firstneigh[i];
+    jnum = numneigh[i];
+    for (jj = 0; jj < jnum; jj++)
+      if ((jlist[jj] & NEIGHMASK) >= nlocal) break;
+    if (jj < jnum) iboundary[nboundary++] = i;
+    else ilist[ninterior++] = i;
+  }
+
+  for (ii = 0; ii < nboundary; ii++)
+    ilist[ninterior+ii] = iboundary[ii];
+}
+
 /* ----------------------------------------------------------------------
    print attributes of this list and associated request
 ------------------------------------------------------------------------- */
@@ -295,6 +337,7 @@ bigint NeighList::memory_usage()
   bytes += memory->usage(ilist,maxatom);
   bytes += memory->usage(numneigh,maxatom);
   bytes += maxatom * sizeof(int *);
+  bytes += memory->usage(iboundary,maxboundary);
 
   int nmypage = comm->nthreads;
 
@@ -50,6 +50,12 @@ class NeighList : protected Pointers {
   int **firstneigh;                // ptr to 1st J int value of each I atom
   int maxatom;                     // size of allocated per-atom arrays
 
+  int interior;                    // 1 if ilist is partitioned after build
+  int ninterior;                   // # of I atoms with no ghost neighbors,
+                                   //   stored first in ilist if partitioned
+  int maxboundary;                 // size of iboundary scratch array
+  int *iboundary;                  // I atoms with ghost neighbors
+
   int pgsize;                      // size of each page
   int oneatom;                     // max size for one atom
   MyPage<int> *ipage;              // pages of neighbor indices
@@ -101,6 +107,7 @@ class NeighList : protected Pointers {
   void post_constructor(class NeighRequest *);
   void setup_pages(int, int);           // setup page data structures
   void grow(int,int);                   // grow all data structs
+  void partition_interior();            // interior I atoms first in ilist
   void print_attributes();              // debug routine
   int get_maxlocal() {return maxatom;}
   bigint memory_usage();
@@ -88,10 +88,14 @@ pairclass(NULL), pairnames(NULL), pairmasks(NULL)
   every = 1;
   delay = 10;
   dist_check = 1;
+  async_check = 0;
+  check_pending = 0;
   pgsize = 100000;
   oneatom = 2000;
   binsizeflag = 0;
   build_once = 0;
+  fuse_flag = 0;
+  fuse_pair = NULL;
   cluster_check = 0;
   ago = -1;
 
@@ -180,6 +184,8 @@ Neighbor::~Neighbor()
 {
   if (copymode) return;
 
+  check_wait();
+
   memory->destroy(cutneighsq);
   memory->destroy(cutneighghostsq);
   delete [] cuttype;
@@ -1279,7 +1285,7 @@ void Neighbor::init_topology()
   int bond_off = 0;
   int angle_off = 0;
   for (i = 0; i < modify->nfix; i++)
-    if ((strcmp(modify->fix[i]->style,"shake") == 0)
+    if ((strncmp(modify->fix[i]->style,"shake",5) == 0)
         || (strcmp(modify->fix[i]->style,"rattle") == 0))
       bond_off = angle_off = 1;
   if (force->bond && force->bond_match("quartic")) bond_off = 1;
@@ -1947,7 +1953,7 @@ int Neighbor::decide()
 
 int Neighbor::check_distance()
 {
-  double delx,dely,delz,rsq;
+  double delx,dely,delz;
   double delta,deltasq,delta1,delta2;
 
   if (boxcheck) {
@@ -1978,25 +1984,111 @@ int Neighbor::check_distance()
     }
   } else deltasq = triggersq;
 
-  double **x = atom->x;
   int nlocal = atom->nlocal;
   if (includegroup) nlocal = atom->nfirst;
 
-  int flag = 0;
-  for (int i = 0; i < nlocal; i++) {
-    delx = x[i][0] - xhold[i][0];
-    dely = x[i][1] - xhold[i][1];
-    delz = x[i][2] - xhold[i][2];
-    rsq = delx*delx + dely*dely + delz*delz;
-    if (rsq > deltasq) flag = 1;
+  double vmaxsq,amaxsq;
+  double rsqmax = max_displacement(nlocal,vmaxsq,amaxsq);
+  int flagall;
+
+  // async check during dynamics in parallel:
+  // use max displacement, speed, and acceleration reduced across procs
+  //   on a previous step, then start reduction of current values
+  //   w/out waiting for it
+  // predict current max displacement as previous one + v t + 1/2 a t^2
+  //   for elapsed time t, this bounds the displacement only as long as
+  //   no atom accelerates faster than the reduced max during that time
+  // minimization has no velocities, so it always uses the blocking check
+
+  int async = (async_check && update->whichflag == 1 && nprocs > 1);
+
+  if (async && check_pending) {
+    check_wait();
+    double dt = (update->ntimestep - check_step) * update->dt;
+    double dmax = sqrt(check_global[0]) + dt*sqrt(check_global[1]) +
+      0.5*dt*dt*sqrt(check_global[2]);
+    flagall = (dmax*dmax > deltasq) ? 1 : 0;
+  } else {
+    int flag = (rsqmax > deltasq) ? 1 : 0;
+    MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MAX,world);
+  }
+
+  if (async && !flagall) {
+    check_local[0] = rsqmax;
+    check_local[1] = vmaxsq;
+    check_local[2] = amaxsq;
+    check_step = update->ntimestep;
+    MPI_Iallreduce(check_local,check_global,3,MPI_DOUBLE,MPI_MAX,world,
+                   &check_request);
+    check_pending = 1;
   }
 
-  int flagall;
-  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MAX,world);
   if (flagall && ago == MAX(every,delay)) ndanger++;
   return flagall;
 }
 
+/* ----------------------------------------------------------------------
+   return max squared displacement of first N atoms since last build
+   also return max squared speed in vmaxsq and max squared acceleration
+     in amaxsq, only needed for async check
+   branch-free loops over flat arrays so compilers can vectorize them
+------------------------------------------------------------------------- */
+
+double Neighbor::max_displacement(int n, double &vmaxsq, double &amaxsq)
+{
+  double rsqmax = 0.0;
+  vmaxsq = amaxsq = 0.0;
+  if (n == 0) return rsqmax;
+
+  const double * const x = atom->x[0];
+  const double * const h = xhold[0];
+  const int n3 = 3*n;
+
+  for (int i = 0; i < n3; i += 3) {
+    const double delx = x[i] - h[i];
+    const double dely = x[i+1] - h[i+1];
+    const double delz = x[i+2] - h[i+2];
+    const double rsq = delx*delx + dely*dely + delz*delz;
+    rsqmax = MAX(rsqmax,rsq);
+  }
+
+  if (async_check && atom->v) {
+    const double * const v = atom->v[0];
+    for (int i = 0; i < n3; i += 3) {
+      const double vsq = v[i]*v[i] + v[i+1]*v[i+1] + v[i+2]*v[i+2];
+      vmaxsq = MAX(vmaxsq,vsq);
+    }
+  }
+
+  // acceleration from current forces, same units conversion as fix nve
+
+  if (async_check && atom->v) {
+    const double * const f = atom->f[0];
+    const double * const rmass = atom->rmass;
+    const double * const mass = atom->mass;
+    const int * const type = atom->type;
+    const double ftm2vsq = force->ftm2v*force->ftm2v;
+    for (int i = 0; i < n; i++) {
+      const double m = rmass ? rmass[i] : mass[type[i]];
+      const double fsq = f[3*i]*f[3*i] + f[3*i+1]*f[3*i+1] + f[3*i+2]*f[3*i+2];
+      amaxsq = MAX(amaxsq,ftm2vsq*fsq/(m*m));
+    }
+  }
+
+  return rsqmax;
+}
+
+/* ----------------------------------------------------------------------
+   complete an async dist check still in flight, if any
+------------------------------------------------------------------------- */
+
+void Neighbor::check_wait()
+{
+  if (!check_pending) return;
+  MPI_Wait(&check_request,MPI_STATUS_IGNORE);
+  check_pending = 0;
+}
+
 /* ----------------------------------------------------------------------
    build perpetual neighbor lists
    called at setup and every few timesteps during run or minimization
@@ -2011,6 +2103,10 @@ void Neighbor::build(int topoflag)
   ncalls++;
   lastcall = update->ntimestep;
 
+  // discard async dist check of previous lists
+
+  check_wait();
+
   int nlocal = atom->nlocal;
   int nall = nlocal + atom->nghost;
 
@@ -2075,6 +2171,7 @@ void Neighbor::build(int topoflag)
     if (!lists[m]->copy) lists[m]->grow(nlocal,nall);
     neigh_pair[m]->build_setup();
     neigh_pair[m]->build(lists[m]);
+    if (lists[m]->interior) lists[m]->partition_interior();
   }
 
   // build topology lists for bonds/angles/etc
@@ -2111,6 +2208,22 @@ void Neighbor::build_topology()
   }
 }
 
+/* ----------------------------------------------------------------------
+   return 1 if pair forces can be computed while building the pair's list
+   requires a perpetual list the pair owns, built by an NPair class
+     which calls Pair::compute_fused() for each owned atom
+------------------------------------------------------------------------- */
+
+int Neighbor::fuse_check(Pair *pair)
+{
+  if (!pair->fuse_enable) return 0;
+
+  NeighList *list = pair->list;
+  if (list == NULL || list->occasional || list->copy) return 0;
+  if (list->np == NULL || !list->np->fuse_allow) return 0;
+  return 1;
+}
+
 /* ----------------------------------------------------------------------
    build a single occasional pairwise neighbor list indexed by I
    called by other classes
@@ -2226,9 +2339,16 @@ void Neighbor::modify_params(int narg, char **arg)
       iarg += 2;
     } else if (strcmp(arg[iarg],"check") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal neigh_modify command");
-      if (strcmp(arg[iarg+1],"yes") == 0) dist_check = 1;
-      else if (strcmp(arg[iarg+1],"no") == 0) dist_check = 0;
-      else error->all(FLERR,"Illegal neigh_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) {
+        dist_check = 1;
+        async_check = 0;
+      } else if (strcmp(arg[iarg+1],"no") == 0) {
+        dist_check = 0;
+        async_check = 0;
+      } else if (strcmp(arg[iarg+1],"async") == 0) {
+        dist_check = 1;
+        async_check = 1;
+      } else error->all(FLERR,"Illegal neigh_modify command");
       iarg += 2;
     } else if (strcmp(arg[iarg],"once") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal neigh_modify command");
@@ -2236,6 +2356,12 @@ void Neighbor::modify_params(int narg, char **arg)
       else if (strcmp(arg[iarg+1],"no") == 0) build_once = 0;
       else error->all(FLERR,"Illegal neigh_modify command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"fuse") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal neigh_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) fuse_flag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) fuse_flag = 0;
+      else error->all(FLERR,"Illegal neigh_modify command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"page") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal neigh_modify command");
       old_pgsize = pgsize;
@@ -26,11 +26,15 @@ class Neighbor : protected Pointers {
   int every;                       // build every this many steps
   int delay;                       // delay build for this many steps
   int dist_check;                  // 0 = always build, 1 = only if 1/2 dist
+  int async_check;                 // 1 if dist check is reduced across procs
+                                   //   without blocking, used on next check
   int ago;                         // how many steps ago neighboring occurred
   int pgsize;                      // size of neighbor page
   int oneatom;                     // max # of neighbors for one atom
   int includegroup;                // only build pairwise lists for this group
   int build_once;                  // 1 if only build lists once per run
+  int fuse_flag;                   // 1 if neigh_modify fuse yes
+  class Pair *fuse_pair;           // pair evaluated while building its list
 
   double skin;                     // skin distance
   double cutneighmin;              // min neighbor cutoff for all type pairs
@@ -119,6 +123,7 @@ class Neighbor : protected Pointers {
   void set(int, char **);           // set neighbor style and skin distance
   void reset_timestep(bigint);      // reset of timestep counter
   void modify_params(int, char**);  // modify params that control builds
+  int fuse_check(class Pair *);     // 1 if pair can be fused with build()
 
   void exclusion_group_group_delete(int, int);  // rm a group-group exclusion
   int exclude_setting();            // return exclude value to accelerator pkg
@@ -146,6 +151,15 @@ class Neighbor : protected Pointers {
   double **xhold;                      // atom coords at last neighbor build
   int maxhold;                         // size of xhold array
 
+  int check_pending;                   // 1 if async dist check is in flight
+  bigint check_step;                   // timestep the async check was started
+  MPI_Request check_request;           // request of async dist check
+  double check_local[3];               // max displacement, speed, accel (sq)
+  double check_global[3];              // same, reduced across procs
+
+  double max_displacement(int, double &, double &);
+  void check_wait();
+
   int boxcheck;                        // 1 if need to store box size
   double boxlo_hold[3],boxhi_hold[3];  // box size at last neighbor build
   double corners_hold[8][3];           // box corners at last neighbor build
@@ -34,6 +34,7 @@ NPair::NPair(LAMMPS *lmp)
   molecular = atom->molecular;
   copymode = 0;
   execution_space = Host;
+  fuse_allow = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -26,6 +26,7 @@ class NPair : protected Pointers {
   bigint last_build;            // last timestep build performed
 
   double cutoff_custom;         // cutoff set by requestor
+  int fuse_allow;               // 1 if build() can evaluate pair forces
 
   NPair(class LAMMPS *);
   virtual ~NPair();
@@ -18,6 +18,7 @@
 #include "atom_vec.h"
 #include "molecule.h"
 #include "domain.h"
+#include "pair.h"
 #include "my_page.h"
 #include "error.h"
 
@@ -25,12 +26,16 @@ using namespace LAMMPS_NS;
 
 /* ---------------------------------------------------------------------- */
 
-NPairHalfBinNewton::NPairHalfBinNewton(LAMMPS *lmp) : NPair(lmp) {}
+NPairHalfBinNewton::NPairHalfBinNewton(LAMMPS *lmp) : NPair(lmp)
+{
+  fuse_allow = 1;
+}
 
 /* ----------------------------------------------------------------------
    binned neighbor list construction with full Newton's 3rd law
    each owned atom i checks its own bin and other bins in Newton stencil
    every pair stored exactly once by some processor
+   if fusing, pair computes forces of each atom while its neighbors are hot
 ------------------------------------------------------------------------- */
 
 void NPairHalfBinNewton::build(NeighList *list)
@@ -61,6 +66,9 @@ void NPairHalfBinNewton::build(NeighList *list)
   int **firstneigh = list->firstneigh;
   MyPage<int> *ipage = list->ipage;
 
+  Pair *fpair = neighbor->fuse_pair;
+  if (fpair && fpair->list != list) fpair = NULL;
+
   int inum = 0;
   ipage->reset();
 
@@ -155,6 +163,8 @@ void NPairHalfBinNewton::build(NeighList *list)
     ipage->vgot(n);
     if (ipage->status())
       error->one(FLERR,"Neighbor list overflow, boost neigh_modify one");
+
+    if (fpair) fpair->compute_fused(i,neighptr,n);
   }
 
   list->inum = inum;
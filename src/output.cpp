@@ -733,6 +733,7 @@ void Output::create_restart(int narg, char **arg)
     restart_flag = restart_flag_single = restart_flag_double = 0;
     last_restart = -1;
 
+    if (restart) restart->async_stop();
     delete restart;
     restart = NULL;
     delete [] restart1;
@@ -815,8 +816,17 @@ void Output::create_restart(int narg, char **arg)
       error->all(FLERR,"Both restart files must use MPI-IO or neither");
   }
 
+  // delta files refer to the last full file, which toggling would overwrite
+
+  if (nfile == 2)
+    for (int iarg = nfile+1; iarg < narg; iarg++)
+      if (strcmp(arg[iarg],"delta") == 0)
+        error->all(FLERR,"Restart delta requires a single restart file name");
+
   // setup output style and process optional args
+  // finish pending async restart file of previous settings first
 
+  if (restart) restart->async_stop();
   delete restart;
   restart = new WriteRestart(lmp);
   int iarg = nfile+1;
@@ -185,4 +185,9 @@ E: Both restart files must use MPI-IO or neither
 
 Self-explanatory.
 
+E: Restart delta requires a single restart file name
+
+With two file names, the full restart file that delta files refer to
+would be overwritten.
+
 */
@@ -77,6 +77,8 @@ Pair::Pair(LAMMPS *lmp) : Pointers(lmp)
 
   ewaldflag = pppmflag = msmflag = dispersionflag = tip4pflag = dipoleflag = 0;
   reinitflag = 1;
+  fuse_enable = 0;
+  energy_local_enable = 0;
 
   // pair_modify settings
 
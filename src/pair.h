@@ -62,6 +62,8 @@ class Pair : protected Pointers {
   int tip4pflag;                 // 1 if compatible with TIP4P solver
   int dipoleflag;                // 1 if compatible with dipole solver
   int reinitflag;                // 1 if compatible with fix adapt and alike
+  int fuse_enable;               // 1 if compute_fused() exists
+  int energy_local_enable;       // 1 if energy_local() exists
 
   int tail_flag;                 // pair_modify flag for LJ tail correction
   double etail,ptail;            // energy/pressure tail corrections
@@ -140,6 +142,21 @@ class Pair : protected Pointers {
   virtual void compute_middle() {}
   virtual void compute_outer(int, int) {}
 
+  // fused neighbor list build and force evaluation, see neigh_modify fuse
+  // compute_fused() is called with the neighbors of one owned atom
+  //   right after the list build found them
+
+  void fused_setup(int eflag, int vflag) {ev_init(eflag,vflag);}
+  void fused_finish() {if (vflag_fdotr) virial_fdotr_compute();}
+  virtual void compute_fused(int, int *, int) {}
+
+  // energy of one owned atom in a per-atom split of eng_vdwl
+  // computed from a full neighbor list that includes ghost atoms,
+  //   so the change of energy due to a local change of atom types
+  //   only requires the atoms within the cutoff of the changed atoms
+
+  virtual double energy_local(int, class NeighList *) {return 0.0;}
+
   virtual double single(int, int, int, int,
                         double, double, double,
                         double& fforce) {
@@ -32,6 +32,7 @@ using namespace MathConst;
 PairBuck::PairBuck(LAMMPS *lmp) : Pair(lmp)
 {
   writedata = 1;
+  fuse_enable = 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -134,6 +135,72 @@ void PairBuck::compute(int eflag, int vflag)
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   forces between atom I and the neighbors just found for it
+   called by the neighbor list build, see neigh_modify fuse
+------------------------------------------------------------------------- */
+
+void PairBuck::compute_fused(int i, int *jlist, int jnum)
+{
+  int j,jj,itype,jtype;
+  double xtmp,ytmp,ztmp,delx,dely,delz,evdwl,fpair;
+  double rsq,r2inv,r6inv,forcebuck,factor_lj;
+  double r,rexp;
+
+  evdwl = 0.0;
+
+  double **x = atom->x;
+  double **f = atom->f;
+  int *type = atom->type;
+  int nlocal = atom->nlocal;
+  double *special_lj = force->special_lj;
+  int newton_pair = force->newton_pair;
+
+  xtmp = x[i][0];
+  ytmp = x[i][1];
+  ztmp = x[i][2];
+  itype = type[i];
+
+  for (jj = 0; jj < jnum; jj++) {
+    j = jlist[jj];
+    factor_lj = special_lj[sbmask(j)];
+    j &= NEIGHMASK;
+
+    delx = xtmp - x[j][0];
+    dely = ytmp - x[j][1];
+    delz = ztmp - x[j][2];
+    rsq = delx*delx + dely*dely + delz*delz;
+    jtype = type[j];
+
+    if (rsq < cutsq[itype][jtype]) {
+      r2inv = 1.0/rsq;
+      r6inv = r2inv*r2inv*r2inv;
+      r = sqrt(rsq);
+      rexp = exp(-r*rhoinv[itype][jtype]);
+      forcebuck = buck1[itype][jtype]*r*rexp - buck2[itype][jtype]*r6inv;
+      fpair = factor_lj*forcebuck*r2inv;
+
+      f[i][0] += delx*fpair;
+      f[i][1] += dely*fpair;
+      f[i][2] += delz*fpair;
+      if (newton_pair || j < nlocal) {
+        f[j][0] -= delx*fpair;
+        f[j][1] -= dely*fpair;
+        f[j][2] -= delz*fpair;
+      }
+
+      if (eflag_either) {
+        evdwl = a[itype][jtype]*rexp - c[itype][jtype]*r6inv -
+          offset[itype][jtype];
+        evdwl *= factor_lj;
+      }
+
+      if (evflag) ev_tally(i,j,nlocal,newton_pair,
+                           evdwl,0.0,fpair,delx,dely,delz);
+    }
+  }
+}
+
 /* ----------------------------------------------------------------------
    allocate all arrays
 ------------------------------------------------------------------------- */
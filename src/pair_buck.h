@@ -29,6 +29,7 @@ class PairBuck : public Pair {
   PairBuck(class LAMMPS *);
   virtual ~PairBuck();
   virtual void compute(int, int);
+  virtual void compute_fused(int, int *, int);
   void settings(int, char **);
   void coeff(int, char **);
   double init_one(int, int);
@@ -42,6 +42,7 @@ PairLJCut::PairLJCut(LAMMPS *lmp) : Pair(lmp)
 {
   respa_enable = 1;
   writedata = 1;
+  fuse_enable = 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -69,14 +70,17 @@ void PairLJCut::compute(int eflag, int vflag)
 {
   int i,j,ii,jj,inum,jnum,itype,jtype;
   double xtmp,ytmp,ztmp,delx,dely,delz,evdwl,fpair;
+  double fxtmp,fytmp,fztmp;
   double rsq,r2inv,r6inv,forcelj,factor_lj;
   int *ilist,*jlist,*numneigh,**firstneigh;
 
   evdwl = 0.0;
   ev_init(eflag,vflag);
 
-  double **x = atom->x;
-  double **f = atom->f;
+  // x and f are contiguous 3*nmax blocks, index them directly
+
+  const double * _noalias const x = atom->x[0];
+  double * _noalias const f = atom->f[0];
   int *type = atom->type;
   int nlocal = atom->nlocal;
   double *special_lj = force->special_lj;
@@ -88,45 +92,53 @@ void PairLJCut::compute(int eflag, int vflag)
   firstneigh = list->firstneigh;
 
   // loop over neighbors of my atoms
+  // force on I is accumulated locally and stored once per atom
 
   for (ii = 0; ii < inum; ii++) {
     i = ilist[ii];
-    xtmp = x[i][0];
-    ytmp = x[i][1];
-    ztmp = x[i][2];
+    xtmp = x[3*i];
+    ytmp = x[3*i+1];
+    ztmp = x[3*i+2];
     itype = type[i];
     jlist = firstneigh[i];
     jnum = numneigh[i];
+    fxtmp = fytmp = fztmp = 0.0;
+
+    const double * const cutsqi = cutsq[itype];
+    const double * const lj1i = lj1[itype];
+    const double * const lj2i = lj2[itype];
+    const double * const lj3i = lj3[itype];
+    const double * const lj4i = lj4[itype];
+    const double * const offseti = offset[itype];
 
     for (jj = 0; jj < jnum; jj++) {
       j = jlist[jj];
       factor_lj = special_lj[sbmask(j)];
       j &= NEIGHMASK;
 
-      delx = xtmp - x[j][0];
-      dely = ytmp - x[j][1];
-      delz = ztmp - x[j][2];
+      delx = xtmp - x[3*j];
+      dely = ytmp - x[3*j+1];
+      delz = ztmp - x[3*j+2];
       rsq = delx*delx + dely*dely + delz*delz;
       jtype = type[j];
 
-      if (rsq < cutsq[itype][jtype]) {
+      if (rsq < cutsqi[jtype]) {
         r2inv = 1.0/rsq;
         r6inv = r2inv*r2inv*r2inv;
-        forcelj = r6inv * (lj1[itype][jtype]*r6inv - lj2[itype][jtype]);
+        forcelj = r6inv * (lj1i[jtype]*r6inv - lj2i[jtype]);
         fpair = factor_lj*forcelj*r2inv;
 
-        f[i][0] += delx*fpair;
-        f[i][1] += dely*fpair;
-        f[i][2] += delz*fpair;
+        fxtmp += delx*fpair;
+        fytmp += dely*fpair;
+        fztmp += delz*fpair;
         if (newton_pair || j < nlocal) {
-          f[j][0] -= delx*fpair;
-          f[j][1] -= dely*fpair;
-          f[j][2] -= delz*fpair;
+          f[3*j] -= delx*fpair;
+          f[3*j+1] -= dely*fpair;
+          f[3*j+2] -= delz*fpair;
         }
 
         if (eflag) {
-          evdwl = r6inv*(lj3[itype][jtype]*r6inv-lj4[itype][jtype]) -
-            offset[itype][jtype];
+          evdwl = r6inv*(lj3i[jtype]*r6inv-lj4i[jtype]) - offseti[jtype];
           evdwl *= factor_lj;
         }
 
@@ -134,11 +146,90 @@ void PairLJCut::compute(int eflag, int vflag)
                              evdwl,0.0,fpair,delx,dely,delz);
       }
     }
+
+    f[3*i] += fxtmp;
+    f[3*i+1] += fytmp;
+    f[3*i+2] += fztmp;
   }
 
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   forces between atom I and the neighbors just found for it
+   called by the neighbor list build, see neigh_modify fuse
+------------------------------------------------------------------------- */
+
+void PairLJCut::compute_fused(int i, int *jlist, int jnum)
+{
+  int j,jj,jtype;
+  double xtmp,ytmp,ztmp,delx,dely,delz,evdwl,fpair;
+  double fxtmp,fytmp,fztmp;
+  double rsq,r2inv,r6inv,forcelj,factor_lj;
+
+  evdwl = 0.0;
+
+  const double * _noalias const x = atom->x[0];
+  double * _noalias const f = atom->f[0];
+  int *type = atom->type;
+  int nlocal = atom->nlocal;
+  double *special_lj = force->special_lj;
+  int newton_pair = force->newton_pair;
+
+  xtmp = x[3*i];
+  ytmp = x[3*i+1];
+  ztmp = x[3*i+2];
+  int itype = type[i];
+  fxtmp = fytmp = fztmp = 0.0;
+
+  const double * const cutsqi = cutsq[itype];
+  const double * const lj1i = lj1[itype];
+  const double * const lj2i = lj2[itype];
+  const double * const lj3i = lj3[itype];
+  const double * const lj4i = lj4[itype];
+  const double * const offseti = offset[itype];
+
+  for (jj = 0; jj < jnum; jj++) {
+    j = jlist[jj];
+    factor_lj = special_lj[sbmask(j)];
+    j &= NEIGHMASK;
+
+    delx = xtmp - x[3*j];
+    dely = ytmp - x[3*j+1];
+    delz = ztmp - x[3*j+2];
+    rsq = delx*delx + dely*dely + delz*delz;
+    jtype = type[j];
+
+    if (rsq < cutsqi[jtype]) {
+      r2inv = 1.0/rsq;
+      r6inv = r2inv*r2inv*r2inv;
+      forcelj = r6inv * (lj1i[jtype]*r6inv - lj2i[jtype]);
+      fpair = factor_lj*forcelj*r2inv;
+
+      fxtmp += delx*fpair;
+      fytmp += dely*fpair;
+      fztmp += delz*fpair;
+      if (newton_pair || j < nlocal) {
+        f[3*j] -= delx*fpair;
+        f[3*j+1] -= dely*fpair;
+        f[3*j+2] -= delz*fpair;
+      }
+
+      if (eflag_either) {
+        evdwl = r6inv*(lj3i[jtype]*r6inv-lj4i[jtype]) - offseti[jtype];
+        evdwl *= factor_lj;
+      }
+
+      if (evflag) ev_tally(i,j,nlocal,newton_pair,
+                           evdwl,0.0,fpair,delx,dely,delz);
+    }
+  }
+
+  f[3*i] += fxtmp;
+  f[3*i+1] += fytmp;
+  f[3*i+2] += fztmp;
+}
+
 /* ---------------------------------------------------------------------- */
 
 void PairLJCut::compute_inner()
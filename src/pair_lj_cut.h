@@ -46,6 +46,8 @@ class PairLJCut : public Pair {
   void compute_middle();
   void compute_outer(int, int);
 
+  virtual void compute_fused(int, int *, int);
+
  protected:
   double cut_global;
   double **cut;
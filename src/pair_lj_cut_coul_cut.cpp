@@ -33,6 +33,7 @@ using namespace MathConst;
 PairLJCutCoulCut::PairLJCutCoulCut(LAMMPS *lmp) : Pair(lmp)
 {
   writedata = 1;
+  fuse_enable = 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -151,6 +152,87 @@ void PairLJCutCoulCut::compute(int eflag, int vflag)
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   forces between atom I and the neighbors just found for it
+   called by the neighbor list build, see neigh_modify fuse
+------------------------------------------------------------------------- */
+
+void PairLJCutCoulCut::compute_fused(int i, int *jlist, int jnum)
+{
+  int j,jj,itype,jtype;
+  double qtmp,xtmp,ytmp,ztmp,delx,dely,delz,evdwl,ecoul,fpair;
+  double rsq,r2inv,r6inv,forcecoul,forcelj,factor_coul,factor_lj;
+
+  evdwl = ecoul = 0.0;
+
+  double **x = atom->x;
+  double **f = atom->f;
+  double *q = atom->q;
+  int *type = atom->type;
+  int nlocal = atom->nlocal;
+  double *special_coul = force->special_coul;
+  double *special_lj = force->special_lj;
+  int newton_pair = force->newton_pair;
+  double qqrd2e = force->qqrd2e;
+
+  qtmp = q[i];
+  xtmp = x[i][0];
+  ytmp = x[i][1];
+  ztmp = x[i][2];
+  itype = type[i];
+
+  for (jj = 0; jj < jnum; jj++) {
+    j = jlist[jj];
+    factor_lj = special_lj[sbmask(j)];
+    factor_coul = special_coul[sbmask(j)];
+    j &= NEIGHMASK;
+
+    delx = xtmp - x[j][0];
+    dely = ytmp - x[j][1];
+    delz = ztmp - x[j][2];
+    rsq = delx*delx + dely*dely + delz*delz;
+    jtype = type[j];
+
+    if (rsq < cutsq[itype][jtype]) {
+      r2inv = 1.0/rsq;
+
+      if (rsq < cut_coulsq[itype][jtype])
+        forcecoul = qqrd2e * qtmp*q[j]*sqrt(r2inv);
+      else forcecoul = 0.0;
+
+      if (rsq < cut_ljsq[itype][jtype]) {
+        r6inv = r2inv*r2inv*r2inv;
+        forcelj = r6inv * (lj1[itype][jtype]*r6inv - lj2[itype][jtype]);
+      } else forcelj = 0.0;
+
+      fpair = (factor_coul*forcecoul + factor_lj*forcelj) * r2inv;
+
+      f[i][0] += delx*fpair;
+      f[i][1] += dely*fpair;
+      f[i][2] += delz*fpair;
+      if (newton_pair || j < nlocal) {
+        f[j][0] -= delx*fpair;
+        f[j][1] -= dely*fpair;
+        f[j][2] -= delz*fpair;
+      }
+
+      if (eflag_either) {
+        if (rsq < cut_coulsq[itype][jtype])
+          ecoul = factor_coul * qqrd2e * qtmp*q[j]*sqrt(r2inv);
+        else ecoul = 0.0;
+        if (rsq < cut_ljsq[itype][jtype]) {
+          evdwl = r6inv*(lj3[itype][jtype]*r6inv-lj4[itype][jtype]) -
+            offset[itype][jtype];
+          evdwl *= factor_lj;
+        } else evdwl = 0.0;
+      }
+
+      if (evflag) ev_tally(i,j,nlocal,newton_pair,
+                           evdwl,ecoul,fpair,delx,dely,delz);
+    }
+  }
+}
+
 /* ----------------------------------------------------------------------
    allocate all arrays
 ------------------------------------------------------------------------- */
@@ -29,6 +29,7 @@ class PairLJCutCoulCut : public Pair {
   PairLJCutCoulCut(class LAMMPS *);
   virtual ~PairLJCutCoulCut();
   virtual void compute(int, int);
+  virtual void compute_fused(int, int *, int);
   virtual void settings(int, char **);
   void coeff(int, char **);
   void init_style();
@@ -30,6 +30,7 @@ using namespace LAMMPS_NS;
 PairMorse::PairMorse(LAMMPS *lmp) : Pair(lmp)
 {
   writedata = 1;
+  fuse_enable = 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -125,6 +126,69 @@ void PairMorse::compute(int eflag, int vflag)
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   forces between atom I and the neighbors just found for it
+   called by the neighbor list build, see neigh_modify fuse
+------------------------------------------------------------------------- */
+
+void PairMorse::compute_fused(int i, int *jlist, int jnum)
+{
+  int j,jj,itype,jtype;
+  double xtmp,ytmp,ztmp,delx,dely,delz,evdwl,fpair;
+  double rsq,r,dr,dexp,factor_lj;
+
+  evdwl = 0.0;
+
+  double **x = atom->x;
+  double **f = atom->f;
+  int *type = atom->type;
+  int nlocal = atom->nlocal;
+  double *special_lj = force->special_lj;
+  int newton_pair = force->newton_pair;
+
+  xtmp = x[i][0];
+  ytmp = x[i][1];
+  ztmp = x[i][2];
+  itype = type[i];
+
+  for (jj = 0; jj < jnum; jj++) {
+    j = jlist[jj];
+    factor_lj = special_lj[sbmask(j)];
+    j &= NEIGHMASK;
+
+    delx = xtmp - x[j][0];
+    dely = ytmp - x[j][1];
+    delz = ztmp - x[j][2];
+    rsq = delx*delx + dely*dely + delz*delz;
+    jtype = type[j];
+
+    if (rsq < cutsq[itype][jtype]) {
+      r = sqrt(rsq);
+      dr = r - r0[itype][jtype];
+      dexp = exp(-alpha[itype][jtype] * dr);
+      fpair = factor_lj * morse1[itype][jtype] * (dexp*dexp - dexp) / r;
+
+      f[i][0] += delx*fpair;
+      f[i][1] += dely*fpair;
+      f[i][2] += delz*fpair;
+      if (newton_pair || j < nlocal) {
+        f[j][0] -= delx*fpair;
+        f[j][1] -= dely*fpair;
+        f[j][2] -= delz*fpair;
+      }
+
+      if (eflag_either) {
+        evdwl = d0[itype][jtype] * (dexp*dexp - 2.0*dexp) -
+          offset[itype][jtype];
+        evdwl *= factor_lj;
+      }
+
+      if (evflag) ev_tally(i,j,nlocal,newton_pair,
+                           evdwl,0.0,fpair,delx,dely,delz);
+    }
+  }
+}
+
 /* ----------------------------------------------------------------------
    allocate all arrays
 ------------------------------------------------------------------------- */
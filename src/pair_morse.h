@@ -29,6 +29,7 @@ class PairMorse : public Pair {
   PairMorse(class LAMMPS *);
   virtual ~PairMorse();
   virtual void compute(int, int);
+  virtual void compute_fused(int, int *, int);
 
   void settings(int, char **);
   void coeff(int, char **);
@@ -56,6 +56,8 @@ using namespace LAMMPS_NS;
 
                            // customize for new sections
 #define NSECTIONS 25       // change when add to header::section_keywords
+#define PBLOCK 4194304     // max bytes per proc in one parallel read pass
+#define RVOUS 1            // 0 for irregular, 1 for all2all
 
 enum{NONE,APPEND,VALUE,MERGE};
 
@@ -67,6 +69,18 @@ const char *suffixes[] = {"/cuda","/gpu","/opt","/omp","/kk",
                           "/coul/dsf","/coul/debye","/coul/charmm",
                           NULL};
 
+// sort routed lines by the key at the start of each datum
+
+static int compare_key(const void *iptr, const void *jptr)
+{
+  bigint i,j;
+  memcpy(&i,iptr,sizeof(bigint));
+  memcpy(&j,jptr,sizeof(bigint));
+  if (i < j) return -1;
+  if (i > j) return 1;
+  return 0;
+}
+
 /* ---------------------------------------------------------------------- */
 
 ReadData::ReadData(LAMMPS *lmp) : Pointers(lmp)
@@ -81,6 +95,13 @@ ReadData::ReadData(LAMMPS *lmp) : Pointers(lmp)
   arg = NULL;
   fp = NULL;
 
+  pbuf = NULL;
+  maxpbuf = 0;
+  ownerflag = 0;
+  nrvous = 0;
+  atomIDs = NULL;
+  procowner = NULL;
+
   // customize for new sections
   // pointers to atom styles that store extra info
 
@@ -112,6 +133,10 @@ ReadData::~ReadData()
   memory->destroy(fix_index);
   memory->sfree(fix_header);
   memory->sfree(fix_section);
+
+  memory->sfree(pbuf);
+  memory->destroy(atomIDs);
+  memory->destroy(procowner);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -135,6 +160,8 @@ void ReadData::command(int narg, char **arg)
     extra_dihedral_types = extra_improper_types = 0;
 
   groupbit = 0;
+  parallel = 0;
+  datafile = arg[0];
 
   nfix = 0;
   fix_index = NULL;
@@ -269,6 +296,12 @@ void ReadData::command(int narg, char **arg)
       int igroup = group->find_or_create(arg[iarg+1]);
       groupbit = group->bitmask[igroup];
       iarg += 2;
+    } else if (strcmp(arg[iarg],"parallel") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal read_data command");
+      if (strcmp(arg[iarg+1],"yes") == 0) parallel = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) parallel = 0;
+      else error->all(FLERR,"Illegal read_data command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"fix") == 0) {
       if (iarg+4 > narg)
         error->all(FLERR,"Illegal read_data command");
@@ -315,6 +348,11 @@ void ReadData::command(int narg, char **arg)
       (extra_atom_types || extra_bond_types || extra_angle_types ||
        extra_dihedral_types || extra_improper_types))
     error->all(FLERR,"Cannot use read_data extra with add flag");
+  if (parallel) {
+    char *suffix = datafile + strlen(datafile) - 3;
+    if (suffix > datafile && strcmp(suffix,".gz") == 0)
+      error->all(FLERR,"Read_data parallel requires an uncompressed data file");
+  }
 
   // first time system initialization
 
@@ -1176,14 +1214,25 @@ void ReadData::atoms()
     if (logfile) fprintf(logfile,"  reading atoms ...\n");
   }
 
-  bigint nread = 0;
-
-  while (nread < natoms) {
-    nchunk = MIN(natoms-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_atoms(nchunk,buffer,id_offset,mol_offset,toffset,shiftflag,shift);
-    nread += nchunk;
+  // parallel: each proc parses its part of the section, keeping any atom
+  //   in the box, then atoms are migrated to the procs that own them
+
+  if (parallel) {
+    int n = read_section(natoms,1);
+    if (n) atom->data_atoms(n,pbuf,id_offset,mol_offset,toffset,
+                            shiftflag,shift,1);
+    migrate_atoms();
+  } else {
+    bigint nread = 0;
+
+    while (nread < natoms) {
+      nchunk = MIN(natoms-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_atoms(nchunk,buffer,id_offset,mol_offset,toffset,
+                       shiftflag,shift);
+      nread += nchunk;
+    }
   }
 
   // check that all atoms were assigned correctly
@@ -1238,14 +1287,20 @@ void ReadData::velocities()
     atom->map_set();
   }
 
-  bigint nread = 0;
+  if (parallel) {
+    int n = read_section(natoms,1);
+    n = route_lines(n,0,1);
+    if (n) atom->data_vels(n,pbuf,id_offset);
+  } else {
+    bigint nread = 0;
 
-  while (nread < natoms) {
-    nchunk = MIN(natoms-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_vels(nchunk,buffer,id_offset);
-    nread += nchunk;
+    while (nread < natoms) {
+      nchunk = MIN(natoms-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_vels(nchunk,buffer,id_offset);
+      nread += nchunk;
+    }
   }
 
   if (mapflag) {
@@ -1287,15 +1342,23 @@ void ReadData::bonds(int firstpass)
   }
 
   // read and process bonds
-
-  bigint nread = 0;
-
-  while (nread < nbonds) {
-    nchunk = MIN(nbonds-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_bonds(nchunk,buffer,count,id_offset,boffset);
-    nread += nchunk;
+  // parallel: route each line to the procs which store it
+
+  if (parallel) {
+    int n = read_section(nbonds,1);
+    if (force->newton_bond) n = route_lines(n,2,1);
+    else n = route_lines(n,2,2);
+    if (n) atom->data_bonds(n,pbuf,count,id_offset,boffset);
+  } else {
+    bigint nread = 0;
+
+    while (nread < nbonds) {
+      nchunk = MIN(nbonds-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_bonds(nchunk,buffer,count,id_offset,boffset);
+      nread += nchunk;
+    }
   }
 
   // if firstpass: tally max bond/atom and return
@@ -1370,15 +1433,23 @@ void ReadData::angles(int firstpass)
   }
 
   // read and process angles
-
-  bigint nread = 0;
-
-  while (nread < nangles) {
-    nchunk = MIN(nangles-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_angles(nchunk,buffer,count,id_offset,aoffset);
-    nread += nchunk;
+  // parallel: route each line to the procs which store it
+
+  if (parallel) {
+    int n = read_section(nangles,1);
+    if (force->newton_bond) n = route_lines(n,3,1);
+    else n = route_lines(n,2,3);
+    if (n) atom->data_angles(n,pbuf,count,id_offset,aoffset);
+  } else {
+    bigint nread = 0;
+
+    while (nread < nangles) {
+      nchunk = MIN(nangles-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_angles(nchunk,buffer,count,id_offset,aoffset);
+      nread += nchunk;
+    }
   }
 
   // if firstpass: tally max angle/atom and return
@@ -1453,15 +1524,23 @@ void ReadData::dihedrals(int firstpass)
   }
 
   // read and process dihedrals
-
-  bigint nread = 0;
-
-  while (nread < ndihedrals) {
-    nchunk = MIN(ndihedrals-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_dihedrals(nchunk,buffer,count,id_offset,doffset);
-    nread += nchunk;
+  // parallel: route each line to the procs which store it
+
+  if (parallel) {
+    int n = read_section(ndihedrals,1);
+    if (force->newton_bond) n = route_lines(n,3,1);
+    else n = route_lines(n,2,4);
+    if (n) atom->data_dihedrals(n,pbuf,count,id_offset,doffset);
+  } else {
+    bigint nread = 0;
+
+    while (nread < ndihedrals) {
+      nchunk = MIN(ndihedrals-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_dihedrals(nchunk,buffer,count,id_offset,doffset);
+      nread += nchunk;
+    }
   }
 
   // if firstpass: tally max dihedral/atom and return
@@ -1536,15 +1615,23 @@ void ReadData::impropers(int firstpass)
   }
 
   // read and process impropers
-
-  bigint nread = 0;
-
-  while (nread < nimpropers) {
-    nchunk = MIN(nimpropers-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_impropers(nchunk,buffer,count,id_offset,ioffset);
-    nread += nchunk;
+  // parallel: route each line to the procs which store it
+
+  if (parallel) {
+    int n = read_section(nimpropers,1);
+    if (force->newton_bond) n = route_lines(n,3,1);
+    else n = route_lines(n,2,4);
+    if (n) atom->data_impropers(n,pbuf,count,id_offset,ioffset);
+  } else {
+    bigint nread = 0;
+
+    while (nread < nimpropers) {
+      nchunk = MIN(nimpropers-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_impropers(nchunk,buffer,count,id_offset,ioffset);
+      nread += nchunk;
+    }
   }
 
   // if firstpass: tally max improper/atom and return
@@ -2053,6 +2140,10 @@ void ReadData::parse_keyword(int first)
 
 void ReadData::skip_lines(bigint n)
 {
+  if (parallel && n > CHUNK) {
+    read_section(n,0);
+    return;
+  }
   if (me) return;
   if (n <= 0) return;
   char *eof = NULL;
@@ -2060,6 +2151,382 @@ void ReadData::skip_lines(bigint n)
   if (eof == NULL) error->one(FLERR,"Unexpected end of data file");
 }
 
+/* ----------------------------------------------------------------------
+   all procs read the next N lines of the file in parallel
+   proc 0 knows where the section starts, each pass over the file
+     assigns a contiguous block of bytes to each proc
+   a line belongs to the proc whose block it starts in,
+     so each proc reads past the end of its block to complete its last line
+   if keepflag, store my lines of the section in pbuf
+   on return proc 0's file pointer is positioned after the section
+   return # of lines stored in pbuf
+------------------------------------------------------------------------- */
+
+int ReadData::read_section(bigint n, int keepflag)
+{
+  if (n <= 0) return 0;
+
+  int nprocs = comm->nprocs;
+
+  bigint pos;
+  if (me == 0) pos = ftell(fp);
+  MPI_Bcast(&pos,1,MPI_LMP_BIGINT,0,world);
+
+  FILE *pfp = fopen(datafile,"rb");
+  if (pfp == NULL) {
+    char str[128];
+    snprintf(str,128,"Cannot open file %s",datafile);
+    error->one(FLERR,str);
+  }
+
+  char *rbuf = (char *)
+    memory->smalloc(PBLOCK+MAXLINE+1,"read_data:rbuf");
+
+  bigint npbuf = 0;
+  int nkeep = 0;
+  bigint nprev = 0;
+  bigint end = -1;
+
+  while (1) {
+
+    // my block of this pass is [lo,lo+block)
+    // read from lo-1, which is a newline for proc 0 since pos starts a line
+
+    bigint block = MIN(PBLOCK,(n-nprev)*MAXLINE/nprocs + 1);
+    bigint lo = pos + me*block;
+    fseek(pfp,lo-1,SEEK_SET);
+    bigint nbytes = fread(rbuf,1,block+MAXLINE+1,pfp);
+    int eof = (nbytes < block+MAXLINE+1);
+
+    // lines that start in my block follow a newline in rbuf[0,block)
+
+    bigint j;
+    bigint nmine = 0;
+    for (j = 0; j < block && j+1 < nbytes; j++)
+      if (rbuf[j] == '\n') nmine++;
+
+    bigint nbefore,ntotal;
+    MPI_Scan(&nmine,&nbefore,1,MPI_LMP_BIGINT,MPI_SUM,world);
+    MPI_Allreduce(&nmine,&ntotal,1,MPI_LMP_BIGINT,MPI_SUM,world);
+
+    // store my lines that are part of the section
+    // mylast = file offset after my last line
+    // myend = file offset after last line of section, if I have it
+
+    bigint index = nprev + nbefore - nmine;
+    bigint mylast = -1;
+    bigint myend = -1;
+    bigint start,stop;
+
+    for (j = 0; j < block && j+1 < nbytes; j++) {
+      if (rbuf[j] != '\n') continue;
+      start = j+1;
+      for (stop = start; stop < nbytes; stop++)
+        if (rbuf[stop] == '\n') break;
+      if (stop == nbytes && !eof)
+        error->one(FLERR,"Data file line is too long for read_data parallel");
+
+      if (index < n && keepflag) {
+        grow_pbuf(npbuf + stop-start + 2);
+        memcpy(&pbuf[npbuf],&rbuf[start],stop-start);
+        npbuf += stop-start;
+        pbuf[npbuf++] = '\n';
+        nkeep++;
+      }
+      if (index == n-1) myend = lo-1 + stop+1;
+      mylast = lo-1 + stop+1;
+      index++;
+    }
+
+    if (nprev + ntotal >= n) {
+      MPI_Allreduce(&myend,&end,1,MPI_LMP_BIGINT,MPI_MAX,world);
+      break;
+    }
+    if (ntotal == 0) error->all(FLERR,"Unexpected end of data file");
+
+    nprev += ntotal;
+    MPI_Allreduce(&mylast,&pos,1,MPI_LMP_BIGINT,MPI_MAX,world);
+  }
+
+  if (nkeep) pbuf[npbuf] = '\0';
+  memory->sfree(rbuf);
+  fclose(pfp);
+
+  if (me == 0) fseek(fp,end,SEEK_SET);
+
+  return nkeep;
+}
+
+/* ----------------------------------------------------------------------
+   insure pbuf can hold N bytes plus a trailing NULL
+------------------------------------------------------------------------- */
+
+void ReadData::grow_pbuf(bigint n)
+{
+  if (n+1 <= maxpbuf) return;
+  maxpbuf = MAX(2*maxpbuf,n+1);
+  pbuf = (char *) memory->srealloc(pbuf,maxpbuf,"read_data:pbuf");
+}
+
+/* ----------------------------------------------------------------------
+   move atoms read in parallel to the procs that own their sub-domain
+   atoms from a previous data file stay where they are
+------------------------------------------------------------------------- */
+
+void ReadData::migrate_atoms()
+{
+  // Irregular clears the atom map, so it must be current
+
+  if (atom->map_style) {
+    atom->map_init();
+    atom->map_set();
+  }
+
+  int nlocal = atom->nlocal;
+  double **x = atom->x;
+
+  int *procassign;
+  memory->create(procassign,nlocal,"read_data:procassign");
+
+  if (domain->triclinic) domain->x2lamda(nlocal);
+  comm->coord2proc_setup();
+
+  int igx,igy,igz;
+  for (int i = 0; i < nlocal; i++) {
+    if (i < nlocal_previous) procassign[i] = me;
+    else procassign[i] = comm->coord2proc(x[i],igx,igy,igz);
+  }
+
+  Irregular *irregular = new Irregular(lmp);
+  irregular->migrate_atoms(1,1,procassign);
+  delete irregular;
+
+  if (domain->triclinic) domain->lamda2x(atom->nlocal);
+  memory->destroy(procassign);
+}
+
+/* ----------------------------------------------------------------------
+   store the owning proc of each atomID in a rendezvous decomposition
+   each proc is assigned every 1/Pth atom
+------------------------------------------------------------------------- */
+
+void ReadData::atom_owners()
+{
+  tagint *tag = atom->tag;
+  int nlocal = atom->nlocal;
+  int nprocs = comm->nprocs;
+
+  int *proclist;
+  memory->create(proclist,nlocal,"read_data:proclist");
+  IDRvous *idbuf = (IDRvous *)
+    memory->smalloc((bigint) nlocal*sizeof(IDRvous),"read_data:idbuf");
+
+  for (int i = 0; i < nlocal; i++) {
+    proclist[i] = tag[i] % nprocs;
+    idbuf[i].me = me;
+    idbuf[i].atomID = tag[i];
+  }
+
+  char *buf;
+  comm->rendezvous(RVOUS,nlocal,(char *) idbuf,sizeof(IDRvous),0,proclist,
+                   rendezvous_ids,0,buf,0,(void *) this);
+
+  memory->destroy(proclist);
+  memory->sfree(idbuf);
+
+  ownerflag = 1;
+}
+
+/* ----------------------------------------------------------------------
+   callback from atom_owners() in rendezvous decomposition
+------------------------------------------------------------------------- */
+
+int ReadData::rendezvous_ids(int n, char *inbuf,
+                             int &flag, int *& /*proclist*/,
+                             char *& /*outbuf*/, void *ptr)
+{
+  ReadData *rptr = (ReadData *) ptr;
+  Memory *memory = rptr->memory;
+
+  memory->destroy(rptr->procowner);
+  memory->destroy(rptr->atomIDs);
+  memory->create(rptr->procowner,n,"read_data:procowner");
+  memory->create(rptr->atomIDs,n,"read_data:atomIDs");
+
+  IDRvous *in = (IDRvous *) inbuf;
+
+  for (int i = 0; i < n; i++) {
+    rptr->procowner[i] = in[i].me;
+    rptr->atomIDs[i] = in[i].atomID;
+  }
+  rptr->nrvous = n;
+
+  // flag = 0: no second comm needed in rendezvous
+
+  flag = 0;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   send each of my N lines in pbuf to the procs that own the atomIDs
+     in columns icol to icol+ncol-1 of the line
+   a line sent to the same proc for several of its atoms is stored once
+   a line with an invalid atomID comes back to me, so the caller flags it
+   on return pbuf holds the lines routed to me
+   return # of lines in pbuf
+------------------------------------------------------------------------- */
+
+int ReadData::route_lines(int n, int icol, int ncol)
+{
+  int i,j,m;
+  char *ptr,*next;
+
+  int nprocs = comm->nprocs;
+  if (!ownerflag) atom_owners();
+
+  // each datum = sort key, atomID, line padded to 8-byte boundary
+  // key encodes my proc and the line index, to remove duplicates
+
+  int maxlen = 0;
+  ptr = pbuf;
+  for (i = 0; i < n; i++) {
+    next = strchr(ptr,'\n');
+    maxlen = MAX(maxlen,(int) (next-ptr));
+    ptr = next + 1;
+  }
+  int maxall;
+  MPI_Allreduce(&maxlen,&maxall,1,MPI_INT,MPI_MAX,world);
+
+  int offset = sizeof(bigint) + sizeof(tagint);
+  rsize = offset + maxall + 1;
+  rsize = (rsize + 7) / 8 * 8;
+
+  int nsend = n*ncol;
+  int *proclist;
+  memory->create(proclist,nsend,"read_data:proclist");
+  char *inbuf = (char *)
+    memory->smalloc((bigint) nsend*rsize,"read_data:inbuf");
+
+  bigint key;
+  tagint atomID;
+  char *datum;
+
+  ptr = pbuf;
+  m = 0;
+  for (i = 0; i < n; i++) {
+    next = strchr(ptr,'\n');
+    *next = '\0';
+    key = (bigint) i*nprocs + me;
+
+    char *word = ptr;
+    for (j = 0; j < icol+ncol; j++) {
+      word += strspn(word," \t\r\f");
+      if (j >= icol) {
+        atomID = ATOTAGINT(word) + id_offset;
+        datum = &inbuf[(bigint) m*rsize];
+        memcpy(datum,&key,sizeof(bigint));
+        memcpy(&datum[sizeof(bigint)],&atomID,sizeof(tagint));
+        strcpy(&datum[offset],ptr);
+        if (atomID > 0) proclist[m] = atomID % nprocs;
+        else proclist[m] = 0;
+        m++;
+      }
+      word += strcspn(word," \t\r\f");
+    }
+    ptr = next + 1;
+  }
+
+  char *outbuf;
+  int nout = comm->rendezvous(RVOUS,nsend,inbuf,rsize,0,proclist,
+                              rendezvous_lines,0,outbuf,rsize,(void *) this);
+
+  memory->destroy(proclist);
+  memory->sfree(inbuf);
+
+  // sort received lines by key and store each unique line in pbuf
+
+  if (nout) qsort(outbuf,nout,rsize,compare_key);
+
+  grow_pbuf((bigint) nout*(maxall+1));
+
+  bigint npbuf = 0;
+  int nlines = 0;
+  bigint lastkey = -1;
+
+  for (i = 0; i < nout; i++) {
+    datum = &outbuf[(bigint) i*rsize];
+    memcpy(&key,datum,sizeof(bigint));
+    if (key == lastkey) continue;
+    lastkey = key;
+    int len = strlen(&datum[offset]);
+    memcpy(&pbuf[npbuf],&datum[offset],len);
+    npbuf += len;
+    pbuf[npbuf++] = '\n';
+    nlines++;
+  }
+  if (nlines) pbuf[npbuf] = '\0';
+
+  memory->sfree(outbuf);
+  return nlines;
+}
+
+/* ----------------------------------------------------------------------
+   callback from route_lines() in rendezvous decomposition
+   send each line to the owner of its atomID, or back to its sender
+------------------------------------------------------------------------- */
+
+int ReadData::rendezvous_lines(int n, char *inbuf,
+                               int &flag, int *&proclist, char *&outbuf,
+                               void *ptr)
+{
+  ReadData *rptr = (ReadData *) ptr;
+  Atom *atom = rptr->atom;
+  Memory *memory = rptr->memory;
+  int nprocs = rptr->comm->nprocs;
+
+  // clear atom map so it can be used here as a hash table
+
+  atom->map_clear();
+
+  int nrvous = rptr->nrvous;
+  tagint *atomIDs = rptr->atomIDs;
+
+  for (int i = 0; i < nrvous; i++)
+    atom->map_one(atomIDs[i],i);
+
+  // proclist = owner of atomID in caller decomposition
+
+  int *procowner = rptr->procowner;
+  int rsize = rptr->rsize;
+  memory->create(proclist,n,"read_data:proclist");
+
+  int m;
+  bigint key;
+  tagint atomID;
+
+  for (int i = 0; i < n; i++) {
+    memcpy(&key,&inbuf[(bigint) i*rsize],sizeof(bigint));
+    memcpy(&atomID,&inbuf[(bigint) i*rsize+sizeof(bigint)],sizeof(tagint));
+    if (atomID > 0 && atomID <= atom->map_tag_max) m = atom->map(atomID);
+    else m = -1;
+    if (m >= 0) proclist[i] = procowner[m];
+    else proclist[i] = key % nprocs;
+  }
+
+  outbuf = inbuf;
+
+  // re-create atom map
+
+  atom->map_init(0);
+  atom->nghost = 0;
+  atom->map_set();
+
+  // flag = 1: outbuf = inbuf
+
+  flag = 1;
+  return n;
+}
+
 /* ----------------------------------------------------------------------
    parse a line of coeffs into words, storing them in narg,arg
    trim anything from '#' onward
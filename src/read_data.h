@@ -77,6 +77,24 @@ class ReadData : protected Pointers {
   char **fix_header;
   char **fix_section;
 
+  // parallel read of large sections
+
+  int parallel;                // 1 if each proc reads part of a section
+  char *datafile;              // name of data file
+  char *pbuf;                  // lines of a section read or routed to me
+  bigint maxpbuf;              // allocated size of pbuf
+
+  int ownerflag;               // 1 if atom owners are stored in rvous decomp
+  int nrvous;                  // # of atomIDs I own in rvous decomp
+  tagint *atomIDs;             // atomIDs in rvous decomp
+  int *procowner;              // owning proc for each atomID in rvous decomp
+  int rsize;                   // byte size of a routed line datum
+
+  struct IDRvous {
+    int me;
+    tagint atomID;
+  };
+
   // methods
 
   void open(char *);
@@ -109,6 +127,17 @@ class ReadData : protected Pointers {
   void impropercoeffs(int);
 
   void fix(int, char *);
+
+  int read_section(bigint, int);
+  void grow_pbuf(bigint);
+  void migrate_atoms();
+  void atom_owners();
+  int route_lines(int, int, int);
+
+  // callback functions for rendezvous communication
+
+  static int rendezvous_ids(int, char *, int &, int *&, char *&, void *);
+  static int rendezvous_lines(int, char *, int &, int *&, char *&, void *);
 };
 
 }
@@ -564,6 +593,16 @@ The specified file cannot be opened.  Check that the path and name are
 correct. If the file is a compressed file, also check that the gzip
 executable can be found and run.
 
+E: Read_data parallel requires an uncompressed data file
+
+Each processor must be able to seek to its part of the file, which
+is not possible when reading through a gzip pipeline.
+
+E: Data file line is too long for read_data parallel
+
+Lines in the Atoms, Velocities, and topology sections of the data
+file must be shorter than 256 characters to be read in parallel.
+
 U: Read data add offset is too big
 
 It cannot be larger than the size of atom IDs, e.g. the maximum 32-bit
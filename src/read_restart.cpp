@@ -35,6 +35,8 @@
 #include "special.h"
 #include "universe.h"
 #include "mpiio.h"
+#include "output.h"
+#include "write_restart.h"
 #include "memory.h"
 #include "error.h"
 
@@ -64,13 +66,19 @@ enum{VERSION,SMALLINT,TAGINT,BIGINT,
      ATOM_ID,ATOM_MAP_STYLE,ATOM_MAP_USER,ATOM_SORTFREQ,ATOM_SORTBIN,
      COMM_MODE,COMM_CUTOFF,COMM_VEL,NO_PAIR,
      EXTRA_BOND_PER_ATOM,EXTRA_ANGLE_PER_ATOM,EXTRA_DIHEDRAL_PER_ATOM,
-     EXTRA_IMPROPER_PER_ATOM,EXTRA_SPECIAL_PER_ATOM,ATOM_MAXSPECIAL};
+     EXTRA_IMPROPER_PER_ATOM,EXTRA_SPECIAL_PER_ATOM,ATOM_MAXSPECIAL,
+     DELTA_BASE,DELTA_OFFSET};
 
 #define LB_FACTOR 1.1
 
 /* ---------------------------------------------------------------------- */
 
-ReadRestart::ReadRestart(LAMMPS *lmp) : Pointers(lmp) {}
+ReadRestart::ReadRestart(LAMMPS *lmp) : Pointers(lmp)
+{
+  fp = dfp = NULL;
+  delta_base = NULL;
+  delta_offset = 0;
+}
 
 /* ---------------------------------------------------------------------- */
 
@@ -81,6 +89,11 @@ void ReadRestart::command(int narg, char **arg)
   if (domain->box_exist)
     error->all(FLERR,"Cannot read_restart after simulation box is defined");
 
+  // finish restart file still being written by an async I/O thread,
+  //   it may be the file read here
+
+  if (output->restart) output->restart->async_stop();
+
   MPI_Barrier(world);
   double time1 = MPI_Wtime();
 
@@ -197,6 +210,30 @@ void ReadRestart::command(int narg, char **arg)
     fp = NULL;
   }
 
+  // for a delta file, first read all per-atom info from its base file
+  // single file: keep delta file open, position base file at its atoms
+
+  char *atomfile = file;
+  if (delta_base) {
+    if (mpiioflag)
+      error->all(FLERR,"Invalid flag in layout section of restart file");
+    atomfile = delta_base;
+    if (me == 0) {
+      if (screen) fprintf(screen,"  base restart file = %s\n",delta_base);
+      if (logfile) fprintf(logfile,"  base restart file = %s\n",delta_base);
+    }
+    if (!multiproc && me == 0) {
+      dfp = fp;
+      fp = fopen(delta_base,"rb");
+      if (fp == NULL) {
+        char str[128];
+        snprintf(str,128,"Cannot open restart file %s",delta_base);
+        error->one(FLERR,str);
+      }
+      fseek(fp,delta_offset,SEEK_SET);
+    }
+  }
+
   // read per-proc info
 
   AtomVec *avec = atom->avec;
@@ -258,6 +295,16 @@ void ReadRestart::command(int narg, char **arg)
 
       m = 0;
       while (m < n) {
+
+        // atoms of a base file are moved after the delta is applied
+
+        if (delta_base) {
+          if (((tagint) ubuf(buf[m+4]).i) % nprocs == me)
+            m += avec->unpack_restart(&buf[m]);
+          else m += static_cast<int> (buf[m]);
+          continue;
+        }
+
         x = &buf[m+1];
         if (remapflag) {
           iptr = (imageint *) &buf[m+7];
@@ -290,12 +337,12 @@ void ReadRestart::command(int narg, char **arg)
 
   else if (nprocs <= multiproc_file) {
 
-    char *procfile = new char[strlen(file) + 16];
-    char *ptr = strchr(file,'%');
+    char *procfile = new char[strlen(atomfile) + 16];
+    char *ptr = strchr(atomfile,'%');
 
     for (int iproc = me; iproc < multiproc_file; iproc += nprocs) {
       *ptr = '\0';
-      sprintf(procfile,"%s%d%s",file,iproc,ptr+1);
+      sprintf(procfile,"%s%d%s",atomfile,iproc,ptr+1);
       *ptr = '%';
       fp = fopen(procfile,"rb");
       if (fp == NULL) {
@@ -364,10 +411,10 @@ void ReadRestart::command(int narg, char **arg)
     MPI_Comm_split(world,icluster,0,&clustercomm);
 
     if (filereader) {
-      char *procfile = new char[strlen(file) + 16];
-      char *ptr = strchr(file,'%');
+      char *procfile = new char[strlen(atomfile) + 16];
+      char *ptr = strchr(atomfile,'%');
       *ptr = '\0';
-      sprintf(procfile,"%s%d%s",file,icluster,ptr+1);
+      sprintf(procfile,"%s%d%s",atomfile,icluster,ptr+1);
       *ptr = '%';
       fp = fopen(procfile,"rb");
       if (fp == NULL) {
@@ -439,13 +486,17 @@ void ReadRestart::command(int narg, char **arg)
 
   // clean-up memory
 
-  delete [] file;
   memory->destroy(buf);
 
-  // for multiproc or MPI-IO files:
+  // overwrite dynamic per-atom state from delta file
+
+  if (delta_base) read_delta(file);
+  delete [] file;
+
+  // for multiproc or MPI-IO or delta files:
   // perform irregular comm to migrate atoms to correct procs
 
-  if (multiproc || mpiioflag) {
+  if (multiproc || mpiioflag || delta_base) {
 
     // if remapflag set, remap all atoms I read back to box before migrating
 
@@ -509,6 +560,9 @@ void ReadRestart::command(int narg, char **arg)
     }
   }
 
+  delete [] delta_base;
+  delta_base = NULL;
+
   // check that all atoms were assigned to procs
 
   bigint natoms;
@@ -1175,6 +1229,12 @@ void ReadRestart::file_layout()
         memory->destroy(nproc_chunk_sizes);
         memory->destroy(nproc_chunk_offsets);
       }
+
+    } else if (flag == DELTA_BASE) {
+      delete [] delta_base;
+      delta_base = read_string();
+    } else if (flag == DELTA_OFFSET) {
+      delta_offset = read_bigint();
     }
 
     flag = read_int();
@@ -1189,6 +1249,135 @@ void ReadRestart::file_layout()
   }
 }
 
+/* ----------------------------------------------------------------------
+   read per-atom info of a delta file after atoms of its base file were read
+   proc 0 reads each per-proc chunk and bcasts it to other procs
+   each proc updates the atoms it read from the base file
+------------------------------------------------------------------------- */
+
+void ReadRestart::read_delta(char *file)
+{
+  // map atom IDs to the base atoms I own
+
+  int mapflag = 0;
+  if (atom->map_style == 0) mapflag = 1;
+  atom->map_init();
+  atom->map_set();
+
+  int n,m;
+  int maxbuf = 0;
+  double *buf = NULL;
+  bigint nmatch = 0;
+
+  // single file: chunks follow the header in the open delta file
+  // multiproc: chunks are in the per-proc files of the delta file
+
+  int nfile = multiproc ? multiproc_file : 1;
+  char *procfile = new char[strlen(file) + 16];
+
+  for (int ifile = 0; ifile < nfile; ifile++) {
+    int nchunk = nprocs_file;
+    if (multiproc) {
+      if (me == 0) {
+        char *ptr = strchr(file,'%');
+        *ptr = '\0';
+        sprintf(procfile,"%s%d%s",file,ifile,ptr+1);
+        *ptr = '%';
+        fp = fopen(procfile,"rb");
+        if (fp == NULL) {
+          char str[128];
+          snprintf(str,128,"Cannot open restart file %s",procfile);
+          error->one(FLERR,str);
+        }
+      }
+      if (read_int() != PROCSPERFILE)
+        error->all(FLERR,"Invalid flag in peratom section of restart file");
+      nchunk = read_int();
+    } else fp = dfp;
+
+    for (int ichunk = 0; ichunk < nchunk; ichunk++) {
+      if (read_int() != PERPROC)
+        error->all(FLERR,"Invalid flag in peratom section of restart file");
+
+      n = read_int();
+      if (n > maxbuf) {
+        maxbuf = n;
+        memory->destroy(buf);
+        memory->create(buf,maxbuf,"read_restart:buf");
+      }
+      read_double_vec(n,buf);
+
+      m = 0;
+      while (m < n) {
+        nmatch += unpack_delta(&buf[m]);
+        m += static_cast<int> (buf[m]);
+      }
+    }
+
+    if (me == 0) {
+      fclose(fp);
+      fp = dfp = NULL;
+    }
+  }
+
+  delete [] procfile;
+  memory->destroy(buf);
+
+  if (mapflag) {
+    atom->map_delete();
+    atom->map_style = 0;
+  }
+
+  bigint nall;
+  MPI_Allreduce(&nmatch,&nall,1,MPI_LMP_BIGINT,MPI_SUM,world);
+  if (nall != atom->natoms)
+    error->all(FLERR,"Restart delta file does not match its base file");
+}
+
+/* ----------------------------------------------------------------------
+   overwrite dynamic state of an atom I own with values from a delta file
+   must match WriteRestart::pack_delta()
+   return 1 if I own the atom, else 0
+------------------------------------------------------------------------- */
+
+int ReadRestart::unpack_delta(double *buf)
+{
+  int i = atom->map((tagint) ubuf(buf[4]).i);
+  if (i < 0 || i >= atom->nlocal) return 0;
+
+  int m = 1;
+  atom->x[i][0] = buf[m++];
+  atom->x[i][1] = buf[m++];
+  atom->x[i][2] = buf[m++];
+  m++;
+  atom->type[i] = (int) ubuf(buf[m++]).i;
+  atom->mask[i] = (int) ubuf(buf[m++]).i;
+  atom->image[i] = (imageint) ubuf(buf[m++]).i;
+  atom->v[i][0] = buf[m++];
+  atom->v[i][1] = buf[m++];
+  atom->v[i][2] = buf[m++];
+
+  if (atom->q_flag) atom->q[i] = buf[m++];
+  if (atom->omega_flag) {
+    atom->omega[i][0] = buf[m++];
+    atom->omega[i][1] = buf[m++];
+    atom->omega[i][2] = buf[m++];
+  }
+  if (atom->angmom_flag) {
+    atom->angmom[i][0] = buf[m++];
+    atom->angmom[i][1] = buf[m++];
+    atom->angmom[i][2] = buf[m++];
+  }
+
+  double **extra = atom->extra;
+  if (atom->nextra_store) {
+    int size = static_cast<int> (buf[0]) - m;
+    for (int k = 0; k < size; k++) extra[i][k] = buf[m++];
+  }
+
+  return 1;
+}
+
 // ----------------------------------------------------------------------
 // ----------------------------------------------------------------------
 // low-level fread methods
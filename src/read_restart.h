@@ -46,6 +46,12 @@ class ReadRestart : protected Pointers {
   bigint assignedChunkSize;
   MPI_Offset assignedChunkOffset,headerOffset;
 
+  // delta file values
+
+  char *delta_base;            // full restart file the delta file refers to
+  bigint delta_offset;         // offset of per-atom info in single base file
+  FILE *dfp;                   // open delta file while base file is read
+
   void file_search(char *, char *);
   void header(int);
   void type_arrays();
@@ -55,6 +61,8 @@ class ReadRestart : protected Pointers {
   void endian();
   int version_numeric();
   void file_layout();
+  void read_delta(char *);
+  int unpack_delta(double *);
 
   int read_int();
   bigint read_bigint();
@@ -62,6 +70,17 @@ class ReadRestart : protected Pointers {
   char *read_string();
   void read_int_vec(int, int *);
   void read_double_vec(int, double *);
+
+  // union data struct for packing 32-bit and 64-bit ints into double bufs
+  // see atom_vec.h for documentation
+
+  union ubuf {
+    double d;
+    int64_t i;
+    ubuf(double arg) : d(arg) {}
+    ubuf(int64_t arg) : i(arg) {}
+    ubuf(int arg) : i(arg) {}
+  };
 };
 
 }
@@ -99,6 +118,12 @@ E: Invalid flag in peratom section of restart file
 
 The format of this section of the file is not correct.
 
+E: Restart delta file does not match its base file
+
+Not every atom in the base restart file was found in the delta file.
+The base file may have been overwritten since the delta file was
+written.
+
 E: Did not assign all restart atoms correctly
 
 Atoms read in from the restart file were not assigned correctly to
@@ -317,6 +317,11 @@ void Respa::init()
   if (modify->nfix == 0 && comm->me == 0)
     error->warning(FLERR,"No fixes defined, atoms won't move");
 
+  // kspace_modify every is for run_style verlet, use respa levels instead
+
+  if (force->kspace && force->kspace->every > 1)
+    error->all(FLERR,"Kspace_modify every requires run_style verlet");
+
   // create fix needed for storing atom-based respa level forces
   // will delete it at end of run
 
@@ -120,6 +120,11 @@ W: One or more respa levels compute no forces
 
 This is computationally inefficient.
 
+E: Kspace_modify every requires run_style verlet
+
+Run_style respa computes kspace forces on its own outer level, use
+that to evaluate them less often.
+
 E: Respa inner cutoffs are invalid
 
 The first cutoff must be <= the second cutoff.
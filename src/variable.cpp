@@ -49,6 +49,8 @@ using namespace MathConst;
 #define VALUELENGTH 64               // also in python.cpp
 #define MAXFUNCARG 6
 
+#define VBLOCK 256                   // # of atoms per block in eval_program()
+
 #define MYROUND(a) (( a-floor(a) ) >= .5) ? ceil(a) : floor(a)
 
 enum{INDEX,LOOP,WORLD,UNIVERSE,ULOOP,STRING,GETENV,
@@ -100,6 +102,11 @@ Variable::Variable(LAMMPS *lmp) : Pointers(lmp)
   randomequal = NULL;
   randomatom = NULL;
 
+  program = NULL;
+  nprogram = maxprogram = ndepth = 0;
+  vstack = NULL;
+  maxvstack = 0;
+
   // customize by assigning a precedence level
 
   precedence[DONE] = 0;
@@ -140,6 +147,8 @@ Variable::~Variable()
   delete randomequal;
   delete randomatom;
 
+  memory->sfree(program);
+  memory->destroy(vstack);
 }
 
 /* ----------------------------------------------------------------------
@@ -980,7 +989,41 @@ void Variable::compute_atom(int ivar, int igroup,
   int *mask = atom->mask;
   int nlocal = atom->nlocal;
 
-  if (style[ivar] == ATOM) {
+  // flatten the tree into a postfix program and run it on blocks of atoms
+  //   in the group, so each operation is a loop the compiler can vectorize
+  // trees the program cannot express are evaluated atom by atom
+
+  int depth = 0;
+  nprogram = ndepth = 0;
+
+  if (style[ivar] == ATOM && compile_tree(tree,depth)) {
+    int ilist[VBLOCK];
+    double *values;
+    int i,k,n;
+
+    if (sumflag == 0) {
+      int m = 0;
+      for (i = 0; i < nlocal; i++) {
+        if (!(mask[i] & groupbit)) result[m] = 0.0;
+        m += stride;
+      }
+    }
+
+    i = 0;
+    while (i < nlocal) {
+      n = 0;
+      for (; i < nlocal && n < VBLOCK; i++)
+        if (mask[i] & groupbit) ilist[n++] = i;
+      if (n == 0) continue;
+
+      values = eval_program(ilist,n);
+      if (sumflag == 0)
+        for (k = 0; k < n; k++) result[ilist[k]*stride] = values[k];
+      else
+        for (k = 0; k < n; k++) result[ilist[k]*stride] += values[k];
+    }
+
+  } else if (style[ivar] == ATOM) {
     if (sumflag == 0) {
       int m = 0;
       for (int i = 0; i < nlocal; i++) {
@@ -3142,6 +3185,329 @@ double Variable::eval_tree(Tree *tree, int i)
   return 0.0;
 }
 
+/* ----------------------------------------------------------------------
+   # of operands of a tree node in a compiled program
+   return -1 if the node type cannot be compiled,
+     b/c it draws random numbers or depends on per-atom values in ways
+     where the order of evaluation matters
+------------------------------------------------------------------------- */
+
+static int program_args(int type)
+{
+  switch (type) {
+  case VALUE: case ATOMARRAY: case TYPEARRAY: case INTARRAY:
+  case BIGINTARRAY: case GMASK: case RMASK: case GRMASK:
+    return 0;
+  case UNARY: case NOT: case SQRT: case EXP: case LN: case LOG: case ABS:
+  case SIN: case COS: case TAN: case ASIN: case ACOS: case ATAN:
+  case CEIL: case FLOOR: case ROUND:
+    return 1;
+  case ADD: case SUBTRACT: case MULTIPLY: case DIVIDE: case MODULO:
+  case CARAT: case EQ: case NE: case LT: case LE: case GT: case GE:
+  case AND: case OR: case XOR: case ATAN2: case RAMP: case VDISPLACE:
+    return 2;
+  case SWIGGLE: case CWIGGLE:
+    return 3;
+  }
+  return -1;
+}
+
+/* ----------------------------------------------------------------------
+   append collapsed atom-style tree to program in postfix order
+   depth = # of operands on the stack after this tree is executed
+   return 1 if successful, 0 if tree must be evaluated via eval_tree()
+------------------------------------------------------------------------- */
+
+int Variable::compile_tree(Tree *tree, int &depth)
+{
+  int nargs = program_args(tree->type);
+  if (nargs < 0) return 0;
+
+  // eval_tree() skips 2nd arg of AND,OR if 1st is 0.0
+  // so it must be safe to evaluate for every atom
+
+  if ((tree->type == AND || tree->type == OR) && tree_can_error(tree->second))
+    return 0;
+
+  if (nargs > 0 && !compile_tree(tree->first,depth)) return 0;
+  if (nargs > 1 && !compile_tree(tree->second,depth)) return 0;
+  if (nargs > 2 && !compile_tree(tree->extra[0],depth)) return 0;
+
+  if (nprogram == maxprogram) {
+    maxprogram += CHUNK;
+    program = (Tree **)
+      memory->srealloc(program,maxprogram*sizeof(Tree *),"variable:program");
+  }
+  program[nprogram++] = tree;
+
+  depth += 1 - nargs;
+  if (depth > ndepth) ndepth = depth;
+  return 1;
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if evaluating tree can generate an error for some atoms
+------------------------------------------------------------------------- */
+
+int Variable::tree_can_error(Tree *tree)
+{
+  int type = tree->type;
+  if (type == DIVIDE || type == MODULO || type == CARAT ||
+      type == SQRT || type == LN || type == LOG ||
+      type == ASIN || type == ACOS || type == SWIGGLE || type == CWIGGLE)
+    return 1;
+
+  if (tree->first && tree_can_error(tree->first)) return 1;
+  if (tree->second && tree_can_error(tree->second)) return 1;
+  for (int i = 0; i < tree->nextra; i++)
+    if (tree_can_error(tree->extra[i])) return 1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   execute compiled program for N atoms in ilist
+   each operand on the stack holds one value per atom
+   return ptr to the N results
+   customize by adding a function, same as eval_tree()
+---------------------------------------------------------------------- */
+
+double *Variable::eval_program(int *ilist, int n)
+{
+  int k,nargs,nstride,ivalue;
+  double *a,*b,*c;
+  double *array;
+  double value,delta,omega;
+  int flag = 0;
+  int sp = 0;
+
+  if (ndepth > maxvstack) {
+    maxvstack = ndepth;
+    memory->destroy(vstack);
+    memory->create(vstack,maxvstack*VBLOCK,"variable:vstack");
+  }
+
+  for (int iop = 0; iop < nprogram; iop++) {
+    Tree *tree = program[iop];
+
+    // a,b,c = 1st,2nd,3rd operand, result replaces 1st operand
+
+    nargs = program_args(tree->type);
+    if (nargs == 0) sp++;
+    else sp -= nargs-1;
+    a = &vstack[(sp-1)*VBLOCK];
+    b = a + VBLOCK;
+    c = b + VBLOCK;
+
+    switch (tree->type) {
+
+    case VALUE:
+      value = tree->value;
+      for (k = 0; k < n; k++) a[k] = value;
+      break;
+    case ATOMARRAY:
+      array = tree->array;
+      nstride = tree->nstride;
+      for (k = 0; k < n; k++) a[k] = array[ilist[k]*nstride];
+      break;
+    case TYPEARRAY: {
+      int *type = atom->type;
+      array = tree->array;
+      for (k = 0; k < n; k++) a[k] = array[type[ilist[k]]];
+      break;
+    }
+    case INTARRAY: {
+      int *iarray = tree->iarray;
+      nstride = tree->nstride;
+      for (k = 0; k < n; k++) a[k] = (double) iarray[ilist[k]*nstride];
+      break;
+    }
+    case BIGINTARRAY: {
+      bigint *barray = tree->barray;
+      nstride = tree->nstride;
+      for (k = 0; k < n; k++) a[k] = (double) barray[ilist[k]*nstride];
+      break;
+    }
+    case GMASK: {
+      int *mask = atom->mask;
+      ivalue = tree->ivalue1;
+      for (k = 0; k < n; k++) a[k] = (mask[ilist[k]] & ivalue) ? 1.0 : 0.0;
+      break;
+    }
+    case RMASK: {
+      double **x = atom->x;
+      Region *region = domain->regions[tree->ivalue1];
+      for (k = 0; k < n; k++)
+        a[k] = region->match(x[ilist[k]][0],x[ilist[k]][1],x[ilist[k]][2]) ?
+          1.0 : 0.0;
+      break;
+    }
+    case GRMASK: {
+      int *mask = atom->mask;
+      double **x = atom->x;
+      Region *region = domain->regions[tree->ivalue2];
+      ivalue = tree->ivalue1;
+      for (k = 0; k < n; k++)
+        a[k] = ((mask[ilist[k]] & ivalue) &&
+                region->match(x[ilist[k]][0],x[ilist[k]][1],x[ilist[k]][2])) ?
+          1.0 : 0.0;
+      break;
+    }
+
+    case ADD:
+      for (k = 0; k < n; k++) a[k] += b[k];
+      break;
+    case SUBTRACT:
+      for (k = 0; k < n; k++) a[k] -= b[k];
+      break;
+    case MULTIPLY:
+      for (k = 0; k < n; k++) a[k] *= b[k];
+      break;
+    case DIVIDE:
+      for (k = 0; k < n; k++) if (b[k] == 0.0) flag = 1;
+      if (flag) error->one(FLERR,"Divide by 0 in variable formula");
+      for (k = 0; k < n; k++) a[k] /= b[k];
+      break;
+    case MODULO:
+      for (k = 0; k < n; k++) if (b[k] == 0.0) flag = 1;
+      if (flag) error->one(FLERR,"Modulo 0 in variable formula");
+      for (k = 0; k < n; k++) a[k] = fmod(a[k],b[k]);
+      break;
+    case CARAT:
+      for (k = 0; k < n; k++) if (b[k] == 0.0) flag = 1;
+      if (flag) error->one(FLERR,"Power by 0 in variable formula");
+      for (k = 0; k < n; k++) a[k] = pow(a[k],b[k]);
+      break;
+    case UNARY:
+      for (k = 0; k < n; k++) a[k] = -a[k];
+      break;
+
+    case NOT:
+      for (k = 0; k < n; k++) a[k] = (a[k] == 0.0) ? 1.0 : 0.0;
+      break;
+    case EQ:
+      for (k = 0; k < n; k++) a[k] = (a[k] == b[k]) ? 1.0 : 0.0;
+      break;
+    case NE:
+      for (k = 0; k < n; k++) a[k] = (a[k] != b[k]) ? 1.0 : 0.0;
+      break;
+    case LT:
+      for (k = 0; k < n; k++) a[k] = (a[k] < b[k]) ? 1.0 : 0.0;
+      break;
+    case LE:
+      for (k = 0; k < n; k++) a[k] = (a[k] <= b[k]) ? 1.0 : 0.0;
+      break;
+    case GT:
+      for (k = 0; k < n; k++) a[k] = (a[k] > b[k]) ? 1.0 : 0.0;
+      break;
+    case GE:
+      for (k = 0; k < n; k++) a[k] = (a[k] >= b[k]) ? 1.0 : 0.0;
+      break;
+    case AND:
+      for (k = 0; k < n; k++)
+        a[k] = (a[k] != 0.0 && b[k] != 0.0) ? 1.0 : 0.0;
+      break;
+    case OR:
+      for (k = 0; k < n; k++)
+        a[k] = (a[k] != 0.0 || b[k] != 0.0) ? 1.0 : 0.0;
+      break;
+    case XOR:
+      for (k = 0; k < n; k++)
+        a[k] = ((a[k] == 0.0) != (b[k] == 0.0)) ? 1.0 : 0.0;
+      break;
+
+    case SQRT:
+      for (k = 0; k < n; k++) if (a[k] < 0.0) flag = 1;
+      if (flag) error->one(FLERR,"Sqrt of negative value in variable formula");
+      for (k = 0; k < n; k++) a[k] = sqrt(a[k]);
+      break;
+    case EXP:
+      for (k = 0; k < n; k++) a[k] = exp(a[k]);
+      break;
+    case LN:
+      for (k = 0; k < n; k++) if (a[k] <= 0.0) flag = 1;
+      if (flag)
+        error->one(FLERR,"Log of zero/negative value in variable formula");
+      for (k = 0; k < n; k++) a[k] = log(a[k]);
+      break;
+    case LOG:
+      for (k = 0; k < n; k++) if (a[k] <= 0.0) flag = 1;
+      if (flag)
+        error->one(FLERR,"Log of zero/negative value in variable formula");
+      for (k = 0; k < n; k++) a[k] = log10(a[k]);
+      break;
+    case ABS:
+      for (k = 0; k < n; k++) a[k] = fabs(a[k]);
+      break;
+
+    case SIN:
+      for (k = 0; k < n; k++) a[k] = sin(a[k]);
+      break;
+    case COS:
+      for (k = 0; k < n; k++) a[k] = cos(a[k]);
+      break;
+    case TAN:
+      for (k = 0; k < n; k++) a[k] = tan(a[k]);
+      break;
+    case ASIN:
+      for (k = 0; k < n; k++) if (a[k] < -1.0 || a[k] > 1.0) flag = 1;
+      if (flag) error->one(FLERR,"Arcsin of invalid value in variable formula");
+      for (k = 0; k < n; k++) a[k] = asin(a[k]);
+      break;
+    case ACOS:
+      for (k = 0; k < n; k++) if (a[k] < -1.0 || a[k] > 1.0) flag = 1;
+      if (flag) error->one(FLERR,"Arccos of invalid value in variable formula");
+      for (k = 0; k < n; k++) a[k] = acos(a[k]);
+      break;
+    case ATAN:
+      for (k = 0; k < n; k++) a[k] = atan(a[k]);
+      break;
+    case ATAN2:
+      for (k = 0; k < n; k++) a[k] = atan2(a[k],b[k]);
+      break;
+
+    case CEIL:
+      for (k = 0; k < n; k++) a[k] = ceil(a[k]);
+      break;
+    case FLOOR:
+      for (k = 0; k < n; k++) a[k] = floor(a[k]);
+      break;
+    case ROUND:
+      for (k = 0; k < n; k++) a[k] = MYROUND(a[k]);
+      break;
+
+    case RAMP:
+      delta = update->ntimestep - update->beginstep;
+      if (delta != 0.0) delta /= update->endstep - update->beginstep;
+      for (k = 0; k < n; k++) a[k] += delta*(b[k]-a[k]);
+      break;
+    case VDISPLACE:
+      delta = update->ntimestep - update->beginstep;
+      for (k = 0; k < n; k++) a[k] += b[k]*delta*update->dt;
+      break;
+    case SWIGGLE:
+      for (k = 0; k < n; k++) if (c[k] == 0.0) flag = 1;
+      if (flag) error->one(FLERR,"Invalid math function in variable formula");
+      delta = update->ntimestep - update->beginstep;
+      for (k = 0; k < n; k++) {
+        omega = 2.0*MY_PI/c[k];
+        a[k] += b[k]*sin(omega*delta*update->dt);
+      }
+      break;
+    case CWIGGLE:
+      for (k = 0; k < n; k++) if (c[k] == 0.0) flag = 1;
+      if (flag) error->one(FLERR,"Invalid math function in variable formula");
+      delta = update->ntimestep - update->beginstep;
+      for (k = 0; k < n; k++) {
+        omega = 2.0*MY_PI/c[k];
+        a[k] += b[k]*(1.0-cos(omega*delta*update->dt));
+      }
+      break;
+    }
+  }
+
+  return vstack;
+}
+
 /* ----------------------------------------------------------------------
    scan entire tree, find size of vectors for vector-style variable
    return N for consistent vector size
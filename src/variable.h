@@ -99,6 +99,12 @@ class Variable : protected Pointers {
       first(NULL), second(NULL), extra(NULL) {}
   };
 
+  Tree **program;          // collapsed atom-style tree in postfix order
+  int nprogram,maxprogram; // # of ops in program and allocated length
+  int ndepth;              // max # of operands on stack while executing it
+  double *vstack;          // operand stack, one block of atoms per operand
+  int maxvstack;           // # of blocks allocated in vstack
+
   int compute_python(int);
   void remove(int);
   void grow();
@@ -109,6 +115,9 @@ class Variable : protected Pointers {
   int size_tree_vector(Tree *);
   int compare_tree_vector(int, int);
   void free_tree(Tree *);
+  int compile_tree(Tree *, int &);
+  int tree_can_error(Tree *);
+  double *eval_program(int *, int);
   int find_matching_paren(char *, int, char *&, int);
   int math_function(char *, char *, Tree **, Tree **,
                     int &, double *, int &, int);
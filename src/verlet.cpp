@@ -30,6 +30,8 @@
 #include "modify.h"
 #include "compute.h"
 #include "fix.h"
+#include "fix_store.h"
+#include "neigh_list.h"
 #include "timer.h"
 #include "memory.h"
 #include "error.h"
@@ -39,7 +41,8 @@ using namespace LAMMPS_NS;
 /* ---------------------------------------------------------------------- */
 
 Verlet::Verlet(LAMMPS *lmp, int narg, char **arg) :
-  Integrate(lmp, narg, arg) {}
+  Integrate(lmp, narg, arg), kspace_last(-1), kspace_natoms(0),
+  fix_kspace(NULL) {}
 
 /* ----------------------------------------------------------------------
    initialization before run
@@ -79,6 +82,50 @@ void Verlet::init()
   // orthogonal vs triclinic simulation box
 
   triclinic = domain->triclinic;
+
+  // per-atom storage of kspace forces in between solves, see kspace_modify
+  // only forces on owned atoms are stored, so no TIP4P kspace styles
+
+  kspace_every = 1;
+  kspace_extrapolate = 0;
+  fix_kspace = NULL;
+
+  int nvalues = 0;
+  if (kspace_compute_flag && force->kspace->every > 1) {
+    if (strcmp(update->integrate_style,"verlet") != 0)
+      error->all(FLERR,"Kspace_modify every requires run_style verlet");
+    if (force->kspace->tip4pflag)
+      error->all(FLERR,"Kspace_modify every cannot be used with "
+                 "TIP4P kspace styles");
+    kspace_every = force->kspace->every;
+    kspace_extrapolate = force->kspace->every_extrapolate;
+    if (kspace_extrapolate) nvalues = 6;
+    else nvalues = 3;
+  }
+
+  ifix = modify->find_fix("VERLET_KSPACE_STORE");
+  if (ifix >= 0 && ((FixStore *) modify->fix[ifix])->nvalues != nvalues) {
+    modify->delete_fix("VERLET_KSPACE_STORE");
+    ifix = -1;
+  }
+
+  if (nvalues && ifix < 0) {
+    char nvalues_str[4];
+    sprintf(nvalues_str,"%d",nvalues);
+    char **newarg = new char*[6];
+    newarg[0] = (char *) "VERLET_KSPACE_STORE";
+    newarg[1] = (char *) "all";
+    newarg[2] = (char *) "STORE";
+    newarg[3] = (char *) "peratom";
+    newarg[4] = (char *) "0";
+    newarg[5] = nvalues_str;
+    modify->add_fix(6,newarg);
+    delete [] newarg;
+    ifix = modify->nfix-1;
+    kspace_last = -1;
+  }
+
+  if (nvalues) fix_kspace = (FixStore *) modify->fix[ifix];
 }
 
 /* ----------------------------------------------------------------------
@@ -102,6 +149,9 @@ void Verlet::setup(int flag)
 
   update->setupflag = 1;
 
+  overlap_setup();
+  fuse_setup();
+
   // setup domain, communication and neighboring
   // acquire ghosts
   // build neighbor lists
@@ -120,6 +170,9 @@ void Verlet::setup(int flag)
   domain->image_check();
   domain->box_too_small_check();
   modify->setup_pre_neighbor();
+  if (force->pair && force->pair->list)
+    force->pair->list->interior = overlap_pair;
+  else overlap_pair = 0;
   neighbor->build(1);
   modify->setup_post_neighbor();
   neighbor->ncalls = 0;
@@ -143,7 +196,7 @@ void Verlet::setup(int flag)
 
   if (force->kspace) {
     force->kspace->setup();
-    if (kspace_compute_flag) force->kspace->compute(eflag,vflag);
+    if (kspace_compute_flag) kspace_compute(1);
     else force->kspace->compute_dummy(eflag,vflag);
   }
 
@@ -155,6 +208,63 @@ void Verlet::setup(int flag)
   update->setupflag = 0;
 }
 
+/* ----------------------------------------------------------------------
+   decide which computations overlap with communication, see comm_modify
+   done in setup() since it depends on the fix lists set by Modify::init()
+------------------------------------------------------------------------- */
+
+void Verlet::overlap_setup()
+{
+  // overlap of computation with forward/reverse comm, see comm_modify
+  // pair can only compute owned atoms while ghost coords are in flight
+  //   if it does no comm and needs no ghost info beyond its neighbor list
+  //   and no fixes or tally computes act during or in between pair slices
+  // bonded and kspace can run while ghost forces are in flight
+  //   if they only change forces of owned atoms
+
+  overlap_pair = overlap_bond = overlap_kspace = 0;
+
+  if (comm->overlap && comm->style == 0 && !external_force_clear) {
+    Pair *pair = force->pair;
+    if (pair_compute_flag && modify->n_pre_force == 0 &&
+        pair->manybody_flag == 0 &&
+        pair->comm_forward == 0 && pair->comm_reverse == 0 &&
+        force->pair_match("hybrid",0) == NULL &&
+        force->pair_match("tip4p",0) == NULL &&
+        modify->find_fix("package_gpu") < 0 &&
+        modify->find_fix("package_intel") < 0) overlap_pair = 1;
+    for (int i = 0; i < modify->ncompute; i++)
+      if (strstr(modify->compute[i]->style,"/tally")) overlap_pair = 0;
+
+    if (force->newton && modify->n_pre_reverse == 0) {
+      if (atom->molecular && force->newton_bond == 0) overlap_bond = 1;
+      if (kspace_compute_flag && force->kspace->tip4pflag == 0)
+        overlap_kspace = 1;
+    }
+
+    if (!overlap_pair && !overlap_bond && !overlap_kspace && comm->me == 0)
+      error->warning(FLERR,"Comm_modify overlap is ignored by this run");
+  }
+}
+
+/* ----------------------------------------------------------------------
+   decide if pair forces are computed during reneighboring, see neigh_modify
+   forces must be cleared before the build and nothing may act in between
+------------------------------------------------------------------------- */
+
+void Verlet::fuse_setup()
+{
+  fuse_pair = 0;
+  if (!neighbor->fuse_flag) return;
+
+  if (pair_compute_flag && !overlap_pair && !external_force_clear &&
+      modify->n_post_neighbor == 0 && modify->n_pre_force == 0 &&
+      neighbor->fuse_check(force->pair)) fuse_pair = 1;
+
+  if (!fuse_pair && comm->me == 0)
+    error->warning(FLERR,"Neigh_modify fuse is ignored by this run");
+}
+
 /* ----------------------------------------------------------------------
    setup without output
    flag = 0 = just force calculation
@@ -165,6 +275,12 @@ void Verlet::setup_minimal(int flag)
 {
   update->setupflag = 1;
 
+  // no overlap of computation with comm after minimal setup,
+  //   since fix lists may have changed since the last setup()
+
+  overlap_pair = overlap_bond = overlap_kspace = 0;
+  if (force->pair && force->pair->list) force->pair->list->interior = 0;
+
   // setup domain, communication and neighboring
   // acquire ghosts
   // build neighbor lists
@@ -205,7 +321,7 @@ void Verlet::setup_minimal(int flag)
 
   if (force->kspace) {
     force->kspace->setup();
-    if (kspace_compute_flag) force->kspace->compute(eflag,vflag);
+    if (kspace_compute_flag) kspace_compute(2);
     else force->kspace->compute_dummy(eflag,vflag);
   }
 
@@ -223,7 +339,7 @@ void Verlet::setup_minimal(int flag)
 void Verlet::run(int n)
 {
   bigint ntimestep;
-  int nflag,sortflag;
+  int nflag,sortflag,fused;
 
   int n_post_integrate = modify->n_post_integrate;
   int n_pre_exchange = modify->n_pre_exchange;
@@ -233,6 +349,7 @@ void Verlet::run(int n)
   int n_pre_reverse = modify->n_pre_reverse;
   int n_post_force = modify->n_post_force;
   int n_end_of_step = modify->n_end_of_step;
+  int npending = 0;
 
   if (atom->sortfreq > 0) sortflag = 1;
   else sortflag = 0;
@@ -256,10 +373,12 @@ void Verlet::run(int n)
     // regular communication vs neighbor list rebuild
 
     nflag = neighbor->decide();
+    fused = 0;
 
     if (nflag == 0) {
       timer->stamp();
-      comm->forward_comm();
+      if (overlap_pair) npending = comm->forward_comm_begin();
+      else comm->forward_comm();
       timer->stamp(Timer::COMM);
     } else {
       if (n_pre_exchange) {
@@ -284,7 +403,15 @@ void Verlet::run(int n)
         modify->pre_neighbor();
         timer->stamp(Timer::MODIFY);
       }
-      neighbor->build(1);
+      if (fuse_pair) {
+        force_clear();
+        force->pair->fused_setup(eflag,vflag);
+        neighbor->fuse_pair = force->pair;
+        neighbor->build(1);
+        neighbor->fuse_pair = NULL;
+        force->pair->fused_finish();
+        fused = 1;
+      } else neighbor->build(1);
       timer->stamp(Timer::NEIGH);
       if (n_post_neighbor) {
         modify->post_neighbor();
@@ -296,8 +423,9 @@ void Verlet::run(int n)
     // important for pair to come before bonded contributions
     // since some bonded potentials tally pairwise energy/virial
     // and Pair:ev_tally() needs to be called before any tallying
+    // if fused, forces were cleared and pair computed by neighbor build
 
-    force_clear();
+    if (!fused) force_clear();
 
     timer->stamp();
 
@@ -306,12 +434,17 @@ void Verlet::run(int n)
       timer->stamp(Timer::MODIFY);
     }
 
-    if (pair_compute_flag) {
-      force->pair->compute(eflag,vflag);
-      timer->stamp(Timer::PAIR);
+    if (pair_compute_flag && !fused) {
+      if (overlap_pair) {
+        pair_compute_overlap(npending);
+        npending = 0;
+      } else {
+        force->pair->compute(eflag,vflag);
+        timer->stamp(Timer::PAIR);
+      }
     }
 
-    if (atom->molecular) {
+    if (atom->molecular && !overlap_bond) {
       if (force->bond) force->bond->compute(eflag,vflag);
       if (force->angle) force->angle->compute(eflag,vflag);
       if (force->dihedral) force->dihedral->compute(eflag,vflag);
@@ -319,8 +452,8 @@ void Verlet::run(int n)
       timer->stamp(Timer::BOND);
     }
 
-    if (kspace_compute_flag) {
-      force->kspace->compute(eflag,vflag);
+    if (kspace_compute_flag && !overlap_kspace) {
+      kspace_compute(0);
       timer->stamp(Timer::KSPACE);
     }
 
@@ -332,8 +465,11 @@ void Verlet::run(int n)
     // reverse communication of forces
 
     if (force->newton) {
-      comm->reverse_comm();
-      timer->stamp(Timer::COMM);
+      if (overlap_bond || overlap_kspace) reverse_comm_overlap();
+      else {
+        comm->reverse_comm();
+        timer->stamp(Timer::COMM);
+      }
     }
 
     // force modifications, final time integration, diagnostics
@@ -362,6 +498,250 @@ void Verlet::cleanup()
   update->update_time();
 }
 
+/* ----------------------------------------------------------------------
+   pair computation overlapped with staged forward comm of ghost coords
+   npending = # of forward comm stages still in flight
+   interior atoms of the pair list are computed in one slice per stage,
+     boundary atoms with ghost neighbors after the comm has completed
+   each slice is a separate pair->compute() call on part of the ilist,
+     so energy and explicit virial of slices are summed here,
+     virial via F dot r is only computed by the final slice
+   not done if per-atom energy or virial is tallied this step
+------------------------------------------------------------------------- */
+
+void Verlet::pair_compute_overlap(int npending)
+{
+  Pair *pair = force->pair;
+
+  if (npending == 0 || eflag/2 || vflag/4) {
+    while (npending) npending = comm->forward_comm_next();
+    timer->stamp(Timer::COMM);
+    pair->compute(eflag,vflag);
+    timer->stamp(Timer::PAIR);
+    return;
+  }
+
+  NeighList *list = pair->list;
+  const int inum = list->inum;
+  const int ninterior = list->ninterior;
+  int *ilist = list->ilist;
+
+  int vflag_slice = vflag;
+  if (vflag == 2 && pair->no_virial_fdotr_compute == 0) vflag_slice = 0;
+
+  double eng_vdwl = 0.0;
+  double eng_coul = 0.0;
+  double virial[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+  const int nslice = npending;
+  int ifirst = 0;
+
+  for (int islice = 0; islice < nslice; islice++) {
+    int ilast = static_cast<int> ((bigint) ninterior*(islice+1)/nslice);
+    list->ilist = ilist + ifirst;
+    list->inum = ilast - ifirst;
+    pair->compute(eflag,vflag_slice);
+    if (eflag) {
+      eng_vdwl += pair->eng_vdwl;
+      eng_coul += pair->eng_coul;
+    }
+    if (vflag_slice)
+      for (int i = 0; i < 6; i++) virial[i] += pair->virial[i];
+    ifirst = ilast;
+    timer->stamp(Timer::PAIR);
+
+    npending = comm->forward_comm_next();
+    timer->stamp(Timer::COMM);
+  }
+
+  list->ilist = ilist + ninterior;
+  list->inum = inum - ninterior;
+  pair->compute(eflag,vflag);
+  list->ilist = ilist;
+  list->inum = inum;
+
+  if (eflag) {
+    pair->eng_vdwl += eng_vdwl;
+    pair->eng_coul += eng_coul;
+  }
+  if (vflag_slice)
+    for (int i = 0; i < 6; i++) pair->virial[i] += virial[i];
+  timer->stamp(Timer::PAIR);
+}
+
+/* ----------------------------------------------------------------------
+   staged reverse comm of ghost forces overlapped with bonded and kspace
+   one comm stage is completed after each of them, then the remaining ones
+------------------------------------------------------------------------- */
+
+void Verlet::reverse_comm_overlap()
+{
+  int npending = comm->reverse_comm_begin();
+  timer->stamp(Timer::COMM);
+
+  if (overlap_bond) {
+    if (force->bond) force->bond->compute(eflag,vflag);
+    if (force->angle) force->angle->compute(eflag,vflag);
+    if (force->dihedral) force->dihedral->compute(eflag,vflag);
+    if (force->improper) force->improper->compute(eflag,vflag);
+    timer->stamp(Timer::BOND);
+    if (npending) npending = comm->reverse_comm_next();
+    timer->stamp(Timer::COMM);
+  }
+
+  if (overlap_kspace) {
+    kspace_compute(0);
+    timer->stamp(Timer::KSPACE);
+    if (npending) npending = comm->reverse_comm_next();
+    timer->stamp(Timer::COMM);
+  }
+
+  while (npending) npending = comm->reverse_comm_next();
+  timer->stamp(Timer::COMM);
+}
+
+/* ----------------------------------------------------------------------
+   kspace forces, with a full solve only every Nth step, see kspace_modify
+   setupflag = 0 for a step of run(), 1 for setup(), 2 for setup_minimal()
+   every step that is a multiple of N does a solve
+   the forces of a solve are stored per atom as f after - f before it
+   impulse: stored forces are applied with weight N on solve steps
+     and not at all in between, as in r-RESPA
+   extrapolate: stored forces are applied on every step, linearly
+     extrapolated from the last 2 solves
+   setup() applies the forces a step of run() would at this timestep,
+     using stored forces of a previous run if they are still current,
+     so that consecutive runs give the same trajectory as a single one
+   setup_minimal() for rerun etc applies the forces of a plain solve
+   energy and virial are those of the last solve
+------------------------------------------------------------------------- */
+
+void Verlet::kspace_compute(int setupflag)
+{
+  KSpace *kspace = force->kspace;
+
+  if (kspace_every == 1) {
+    kspace->compute(eflag,vflag);
+    return;
+  }
+
+  int i;
+  double **f = atom->f;
+  double **fk = fix_kspace->astore;
+  int nlocal = atom->nlocal;
+  bigint ntimestep = update->ntimestep;
+  int solvestep = (ntimestep % kspace_every == 0);
+
+  // steps of run() in between solves
+
+  if (setupflag == 0 && !solvestep) {
+    if (eflag/2 || vflag/4)
+      error->all(FLERR,"Kspace per-atom energy or virial requested "
+                 "in between kspace_modify every solves");
+    if (kspace_extrapolate) kspace_extrapolate_forces();
+    return;
+  }
+
+  // stored forces of a previous run are current if its last solve
+  // is at most N steps back and no atoms were added or removed since
+
+  int current = 0;
+  if (setupflag == 1 && kspace_last >= 0 && kspace_last <= ntimestep &&
+      ntimestep - kspace_last <= kspace_every &&
+      kspace_natoms == atom->natoms) current = 1;
+
+  // setup in between solves still solves for energy and virial, but
+  //   impulse: drops its forces, since none are applied in between
+  //   extrapolate: uses the stored forces instead, if they are current
+
+  if (setupflag == 1 && !solvestep && (!kspace_extrapolate || current)) {
+    double **fsave;
+    memory->create(fsave,nlocal,3,"verlet:fsave");
+    for (i = 0; i < nlocal; i++) {
+      fsave[i][0] = f[i][0];
+      fsave[i][1] = f[i][1];
+      fsave[i][2] = f[i][2];
+    }
+
+    kspace->compute(eflag,vflag);
+
+    for (i = 0; i < nlocal; i++) {
+      f[i][0] = fsave[i][0];
+      f[i][1] = fsave[i][1];
+      f[i][2] = fsave[i][2];
+    }
+    memory->destroy(fsave);
+
+    if (kspace_extrapolate) kspace_extrapolate_forces();
+    return;
+  }
+
+  // solve and store its forces
+  // solve steps apply them as a step of run() does, with the previous
+  //   solve as 2nd one for extrapolation unless it is of this same step
+  // all other solves, i.e. setup_minimal() or setup in between solves
+  //   without current stored forces, apply them once as every 1 does
+  //   and use them for both solves, so extrapolation is constant
+
+  int onstep = (setupflag != 2 && solvestep);
+  int shift = kspace_extrapolate && onstep &&
+    (setupflag == 0 || (current && kspace_last < ntimestep));
+  int keep = kspace_extrapolate && onstep && setupflag == 1 &&
+    current && kspace_last == ntimestep;
+  int seed = kspace_extrapolate && !shift && !keep;
+
+  double weight = 0.0;
+  if (onstep && !kspace_extrapolate) weight = kspace_every - 1;
+
+  for (i = 0; i < nlocal; i++) {
+    if (shift) {
+      fk[i][3] = fk[i][0];
+      fk[i][4] = fk[i][1];
+      fk[i][5] = fk[i][2];
+    }
+    fk[i][0] = f[i][0];
+    fk[i][1] = f[i][1];
+    fk[i][2] = f[i][2];
+  }
+
+  kspace->compute(eflag,vflag);
+
+  for (i = 0; i < nlocal; i++) {
+    fk[i][0] = f[i][0] - fk[i][0];
+    fk[i][1] = f[i][1] - fk[i][1];
+    fk[i][2] = f[i][2] - fk[i][2];
+    f[i][0] += weight*fk[i][0];
+    f[i][1] += weight*fk[i][1];
+    f[i][2] += weight*fk[i][2];
+    if (seed) {
+      fk[i][3] = fk[i][0];
+      fk[i][4] = fk[i][1];
+      fk[i][5] = fk[i][2];
+    }
+  }
+
+  kspace_last = ntimestep;
+  kspace_natoms = atom->natoms;
+}
+
+/* ----------------------------------------------------------------------
+   add kspace forces extrapolated from the last 2 solves
+------------------------------------------------------------------------- */
+
+void Verlet::kspace_extrapolate_forces()
+{
+  double **f = atom->f;
+  double **fk = fix_kspace->astore;
+  int nlocal = atom->nlocal;
+
+  double frac = (double) (update->ntimestep - kspace_last) / kspace_every;
+  for (int i = 0; i < nlocal; i++) {
+    f[i][0] += fk[i][0] + frac*(fk[i][0] - fk[i][3]);
+    f[i][1] += fk[i][1] + frac*(fk[i][1] - fk[i][4]);
+    f[i][2] += fk[i][2] + frac*(fk[i][2] - fk[i][5]);
+  }
+}
+
 /* ----------------------------------------------------------------------
    clear force on own & ghost atoms
    clear other arrays as needed
@@ -37,8 +37,23 @@ class Verlet : public Integrate {
  protected:
   int triclinic;                    // 0 if domain is orthog, 1 if triclinic
   int torqueflag,extraflag;
+  int overlap_pair;                 // 1 if pair overlaps forward comm
+  int overlap_bond,overlap_kspace;  // 1 if bonded/kspace overlap reverse comm
+  int fuse_pair;                    // 1 if pair is computed by neighbor build
+
+  int kspace_every;                 // full kspace solve every this many steps
+  int kspace_extrapolate;           // 1 if extrapolate kspace forces
+  bigint kspace_last;               // timestep of last kspace solve, -1 if none
+  bigint kspace_natoms;             // # of atoms at last kspace solve
+  class FixStore *fix_kspace;       // kspace forces of last 2 solves
 
   virtual void force_clear();
+  void overlap_setup();
+  void fuse_setup();
+  void pair_compute_overlap(int);
+  void reverse_comm_overlap();
+  void kspace_compute(int);
+  void kspace_extrapolate_forces();
 };
 
 }
@@ -53,6 +68,37 @@ W: No fixes defined, atoms won't move
 If you are not using a fix like nve, nvt, npt then atom velocities and
 coordinates will not be updated during timestepping.
 
+W: Comm_modify overlap is ignored by this run
+
+None of the pair, bonded, or kspace computations can be overlapped with
+communication for the current settings, e.g. because the pair style is
+manybody or communicates itself, or because fixes must run in between.
+The run proceeds without overlap.
+
+W: Neigh_modify fuse is ignored by this run
+
+The pair style has no fused force kernel, its neighbor list is not
+built by the half/bin/newton method, or fixes must run in between
+neighbor list build and pair forces.  The run proceeds with separate
+neighbor list build and pair force computation.
+
+E: Kspace_modify every requires run_style verlet
+
+Other run styles derived from verlet, e.g. verlet/split,
+verlet/lrt/intel or verlet/kk, compute kspace forces every step
+themselves.
+
+E: Kspace_modify every cannot be used with TIP4P kspace styles
+
+TIP4P kspace styles also change forces of ghost atoms, which cannot be
+stored in between kspace solves.
+
+E: Kspace per-atom energy or virial requested in between kspace_modify every solves
+
+With kspace_modify every N, per-atom kspace energy and virial are only
+computed on timesteps that are multiples of N.  Output them only on
+those timesteps.
+
 E: KOKKOS package requires run_style verlet/kk
 
 The KOKKOS package requires the Kokkos version of run_style verlet; the
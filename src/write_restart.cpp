@@ -13,6 +13,7 @@
 
 #include <mpi.h>
 #include <cstring>
+#include <cstdlib>
 #include "write_restart.h"
 #include "atom.h"
 #include "atom_vec.h"
@@ -63,7 +64,8 @@ enum{VERSION,SMALLINT,TAGINT,BIGINT,
      ATOM_ID,ATOM_MAP_STYLE,ATOM_MAP_USER,ATOM_SORTFREQ,ATOM_SORTBIN,
      COMM_MODE,COMM_CUTOFF,COMM_VEL,NO_PAIR,
      EXTRA_BOND_PER_ATOM,EXTRA_ANGLE_PER_ATOM,EXTRA_DIHEDRAL_PER_ATOM,
-     EXTRA_IMPROPER_PER_ATOM,EXTRA_SPECIAL_PER_ATOM,ATOM_MAXSPECIAL};
+     EXTRA_IMPROPER_PER_ATOM,EXTRA_SPECIAL_PER_ATOM,ATOM_MAXSPECIAL,
+     DELTA_BASE,DELTA_OFFSET};
 
 /* ---------------------------------------------------------------------- */
 
@@ -74,6 +76,43 @@ WriteRestart::WriteRestart(LAMMPS *lmp) : Pointers(lmp)
   multiproc = 0;
   noinit = 0;
   fp = NULL;
+  mpiio = NULL;
+
+  async_flag = 0;
+  abuf = NULL;
+  maxabuf = 0;
+  acount = NULL;
+  hbuf = NULL;
+  hsize = 0;
+  afile = abase = NULL;
+  async_error = 0;
+
+  delta_every = 0;
+  delta_flag = 0;
+  delta_count = 0;
+  delta_base = NULL;
+  delta_offset = 0;
+  delta_natoms = delta_nbonds = delta_nangles = 0;
+  delta_ndihedrals = delta_nimpropers = 0;
+  delta_checksum = 0;
+#if defined(LAMMPS_ASYNC_DUMP)
+  async_state = ASYNC_IDLE;
+  async_running = 0;
+#endif
+}
+
+/* ---------------------------------------------------------------------- */
+
+WriteRestart::~WriteRestart()
+{
+  async_join();
+
+  memory->destroy(abuf);
+  memory->destroy(acount);
+  free(hbuf);
+  delete [] afile;
+  delete [] abase;
+  delete [] delta_base;
 }
 
 /* ----------------------------------------------------------------------
@@ -109,6 +148,12 @@ void WriteRestart::command(int narg, char **arg)
   // also called by Output class for periodic restart files
 
   multiproc_options(multiproc,mpiioflag,narg-1,&arg[1]);
+  if (async_flag)
+    error->all(FLERR,"Write_restart async yes is only allowed "
+               "for the restart command");
+  if (delta_every)
+    error->all(FLERR,"Write_restart delta is only allowed "
+               "for the restart command");
 
   // init entire system since comm->exchange is done
   // comm::init needs neighbor::init needs pair::init needs kspace::init, etc
@@ -227,8 +272,37 @@ void WriteRestart::multiproc_options(int multiproc_caller, int mpiioflag_caller,
     } else if (strcmp(arg[iarg],"noinit") == 0) {
       noinit = 1;
       iarg++;
+
+    } else if (strcmp(arg[iarg],"async") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal write_restart command");
+      if (strcmp(arg[iarg+1],"yes") == 0) async_flag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) async_flag = 0;
+      else error->all(FLERR,"Illegal write_restart command");
+#if !defined(LAMMPS_ASYNC_DUMP)
+      if (async_flag)
+        error->all(FLERR,"Restart async yes requires LAMMPS be built "
+                   "with -DLAMMPS_ASYNC_DUMP");
+#endif
+      iarg += 2;
+
+    } else if (strcmp(arg[iarg],"delta") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal write_restart command");
+      delta_every = force->inumeric(FLERR,arg[iarg+1]);
+      if (delta_every <= 0) error->all(FLERR,"Illegal write_restart command");
+      iarg += 2;
+
     } else error->all(FLERR,"Illegal write_restart command");
   }
+
+  if (async_flag && mpiioflag)
+    error->all(FLERR,"Restart async yes not allowed with MPI-IO output");
+  if (delta_every && mpiioflag)
+    error->all(FLERR,"Restart delta not allowed with MPI-IO output");
+  if (delta_every && atom->tag_enable == 0)
+    error->all(FLERR,"Restart delta requires atom IDs");
+  if (delta_every && (atom->ellipsoid_flag || atom->line_flag ||
+                      atom->tri_flag || atom->body_flag))
+    error->all(FLERR,"Restart delta not allowed with this atom style");
 }
 
 /* ----------------------------------------------------------------------
@@ -247,6 +321,11 @@ void WriteRestart::write(char *file)
 
   if (neighbor->build_once) domain->reset_box();
 
+  // if async, I/O thread must be done with previous file before
+  //   its buffers and fp can be reused
+
+  if (async_flag) async_wait();
+
   // natoms = sum of nlocal = value to write into restart file
   // if unequal and thermo lostflag is "error", don't write restart file
 
@@ -255,7 +334,22 @@ void WriteRestart::write(char *file)
   if (natoms != atom->natoms && output->thermo->lostflag == Thermo::ERROR)
     error->all(FLERR,"Atom count is inconsistent, cannot write restart file");
 
+  // with delta, write only dynamic per-atom state relative to last full file
+  // write a full file every delta_every files or when topology or any
+  //   other per-atom info a delta file does not store has changed,
+  //   which also catches changes that keep all counts the same
+
+  delta_flag = 0;
+  uint64_t checksum = 0;
+  if (delta_every > 1) checksum = static_checksum();
+  if (delta_every > 1 && delta_base && delta_count < delta_every &&
+      natoms == delta_natoms && atom->nbonds == delta_nbonds &&
+      atom->nangles == delta_nangles && atom->ndihedrals == delta_ndihedrals &&
+      atom->nimpropers == delta_nimpropers && checksum == delta_checksum)
+    delta_flag = 1;
+
   // open single restart file or base file for multiproc case
+  // if async, header goes into memory and I/O thread writes the file
 
   if (me == 0) {
     char *hfile;
@@ -266,7 +360,22 @@ void WriteRestart::write(char *file)
       sprintf(hfile,"%s%s%s",file,"base",ptr+1);
       *ptr = '%';
     } else hfile = file;
-    fp = fopen(hfile,"wb");
+    if (async_flag) {
+#if defined(LAMMPS_ASYNC_DUMP)
+      free(hbuf);
+      hbuf = NULL;
+      hsize = 0;
+      fp = open_memstream(&hbuf,&hsize);
+      if (fp == NULL)
+        error->one(FLERR,"Cannot open restart header in memory");
+#endif
+      delete [] abase;
+      abase = NULL;
+      if (multiproc) {
+        abase = new char[strlen(hfile)+1];
+        strcpy(abase,hfile);
+      }
+    } else fp = fopen(hfile,"wb");
     if (fp == NULL) {
       char str[128];
       snprintf(str,128,"Cannot open restart file %s",hfile);
@@ -303,7 +412,9 @@ void WriteRestart::write(char *file)
   //   but nlocal * doubles-peratom could oveflow
 
   int max_size;
-  int send_size = atom->avec->size_restart();
+  int send_size;
+  if (delta_flag) send_size = size_delta();
+  else send_size = atom->avec->size_restart();
   MPI_Allreduce(&send_size,&max_size,1,MPI_INT,MPI_MAX,world);
 
   double *buf;
@@ -313,6 +424,11 @@ void WriteRestart::write(char *file)
 
   file_layout(send_size);
 
+  // offset of per-atom data in a single full file, for later delta files
+
+  if (delta_every && !delta_flag && me == 0 && !multiproc)
+    delta_offset = ftell(fp);
+
   // header info is complete
   // if multiproc output:
   //   close header file, open multiname file on each writing proc,
@@ -330,7 +446,11 @@ void WriteRestart::write(char *file)
     sprintf(multiname,"%s%d%s",file,icluster,ptr+1);
     *ptr = '%';
 
-    if (filewriter) {
+    if (filewriter && async_flag) {
+      delete [] afile;
+      afile = new char[strlen(multiname)+1];
+      strcpy(afile,multiname);
+    } else if (filewriter) {
       fp = fopen(multiname,"wb");
       if (fp == NULL) {
         char str[128];
@@ -347,7 +467,10 @@ void WriteRestart::write(char *file)
 
   AtomVec *avec = atom->avec;
   int n = 0;
-  for (int i = 0; i < atom->nlocal; i++) n += avec->pack_restart(i,&buf[n]);
+  if (delta_flag)
+    for (int i = 0; i < atom->nlocal; i++) n += pack_delta(i,&buf[n]);
+  else
+    for (int i = 0; i < atom->nlocal; i++) n += avec->pack_restart(i,&buf[n]);
 
   // if any fix requires it, remap each atom's coords via PBC
   // is because fix changes atom coords (excepting an integrate fix)
@@ -410,6 +533,20 @@ void WriteRestart::write(char *file)
     mpiio->close();
   }
 
+  // async output of one or more native files
+  // gather data of my cluster and hand it to I/O thread
+
+  else if (async_flag) {
+    if (me == 0 && !multiproc) {
+      fclose(fp);
+      fp = NULL;
+      delete [] afile;
+      afile = new char[strlen(file)+1];
+      strcpy(afile,file);
+    }
+    async_gather(send_size,max_size,buf);
+  }
+
   // output of one or more native files
   // filewriter = 1 = this proc writes to file
   // ping each proc in my cluster, receive its data, write data to file
@@ -444,6 +581,22 @@ void WriteRestart::write(char *file)
 
   memory->destroy(buf);
 
+  // a full file becomes the base of subsequent delta files
+
+  if (delta_flag) delta_count++;
+  else if (delta_every) {
+    delete [] delta_base;
+    delta_base = new char[strlen(file)+1];
+    strcpy(delta_base,file);
+    delta_count = 1;
+    delta_natoms = natoms;
+    delta_nbonds = atom->nbonds;
+    delta_nangles = atom->nangles;
+    delta_ndihedrals = atom->ndihedrals;
+    delta_nimpropers = atom->nimpropers;
+    delta_checksum = checksum;
+  }
+
   // invoke any fixes that write their own restart file
 
   for (int ifix = 0; ifix < modify->nfix; ifix++)
@@ -451,6 +604,218 @@ void WriteRestart::write(char *file)
       modify->fix[ifix]->write_restart_file(file);
 }
 
+/* ----------------------------------------------------------------------
+   gather packed buf of each proc in my cluster into abuf of filewriter
+   filewriter then hands abuf to I/O thread and returns
+   non-filewriter procs send buf as for a synchronous restart file
+------------------------------------------------------------------------- */
+
+void WriteRestart::async_gather(int send_size, int max_size, double *buf)
+{
+  int tmp,recv_size;
+  MPI_Status status;
+  MPI_Request request;
+
+  if (!filewriter) {
+    MPI_Recv(&tmp,0,MPI_INT,fileproc,0,world,MPI_STATUS_IGNORE);
+    MPI_Rsend(buf,send_size,MPI_DOUBLE,fileproc,0,world);
+    return;
+  }
+
+  if (acount == NULL) memory->create(acount,nclusterprocs,"write_restart:acount");
+
+  bigint offset = 0;
+  for (int iproc = 0; iproc < nclusterprocs; iproc++) {
+    if (offset + max_size > maxabuf) {
+      maxabuf = offset + max_size;
+      memory->grow(abuf,maxabuf,"write_restart:abuf");
+    }
+    if (iproc) {
+      MPI_Irecv(&abuf[offset],max_size,MPI_DOUBLE,me+iproc,0,world,&request);
+      MPI_Send(&tmp,0,MPI_INT,me+iproc,0,world);
+      MPI_Wait(&request,&status);
+      MPI_Get_count(&status,MPI_DOUBLE,&recv_size);
+    } else {
+      recv_size = send_size;
+      if (send_size) memcpy(abuf,buf,send_size*sizeof(double));
+    }
+    acount[iproc] = recv_size;
+    offset += recv_size;
+  }
+
+  async_post();
+}
+
+/* ----------------------------------------------------------------------
+   hand snapshot in abuf and hbuf to I/O thread, start thread on first use
+------------------------------------------------------------------------- */
+
+void WriteRestart::async_post()
+{
+#if defined(LAMMPS_ASYNC_DUMP)
+  if (!async_running) {
+    pthread_mutex_init(&async_mutex,NULL);
+    pthread_cond_init(&async_cond,NULL);
+    async_state = ASYNC_IDLE;
+    if (pthread_create(&async_thread,NULL,&WriteRestart::async_worker,this))
+      error->one(FLERR,"Cannot create I/O thread for restart async");
+    async_running = 1;
+  }
+
+  pthread_mutex_lock(&async_mutex);
+  async_state = ASYNC_BUSY;
+  pthread_cond_broadcast(&async_cond);
+  pthread_mutex_unlock(&async_mutex);
+#else
+  async_snapshot();
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   block until I/O thread is done with the previous restart file
+   report a file the I/O thread could not complete
+------------------------------------------------------------------------- */
+
+void WriteRestart::async_wait()
+{
+#if defined(LAMMPS_ASYNC_DUMP)
+  if (async_running) {
+    pthread_mutex_lock(&async_mutex);
+    while (async_state == ASYNC_BUSY)
+      pthread_cond_wait(&async_cond,&async_mutex);
+    pthread_mutex_unlock(&async_mutex);
+  }
+#endif
+
+  if (async_error) {
+    async_error = 0;
+    error->one(FLERR,"Could not write restart file in I/O thread");
+  }
+}
+
+/* ----------------------------------------------------------------------
+   finish pending restart file and terminate I/O thread
+   must be called by all procs, a new thread is started by next write
+   report a file the I/O thread could not complete on any proc
+------------------------------------------------------------------------- */
+
+void WriteRestart::async_stop()
+{
+  if (!async_flag) return;
+
+  async_join();
+
+  int flag = async_error;
+  int flagall;
+  async_error = 0;
+  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MAX,world);
+  if (flagall) error->all(FLERR,"Could not write restart file in I/O thread");
+}
+
+/* ----------------------------------------------------------------------
+   finish pending restart file and terminate I/O thread on this proc
+   no error check, since also called by destructor
+------------------------------------------------------------------------- */
+
+void WriteRestart::async_join()
+{
+#if defined(LAMMPS_ASYNC_DUMP)
+  if (!async_running) return;
+
+  pthread_mutex_lock(&async_mutex);
+  while (async_state == ASYNC_BUSY)
+    pthread_cond_wait(&async_cond,&async_mutex);
+  async_state = ASYNC_EXIT;
+  pthread_cond_broadcast(&async_cond);
+  pthread_mutex_unlock(&async_mutex);
+
+  pthread_join(async_thread,NULL);
+  pthread_cond_destroy(&async_cond);
+  pthread_mutex_destroy(&async_mutex);
+  async_running = 0;
+#endif
+}
+
+#if defined(LAMMPS_ASYNC_DUMP)
+
+/* ----------------------------------------------------------------------
+   I/O thread loop, writes each posted restart file until told to exit
+   must not make any MPI calls
+------------------------------------------------------------------------- */
+
+void *WriteRestart::async_worker(void *ptr)
+{
+  WriteRestart *wr = (WriteRestart *) ptr;
+
+  pthread_mutex_lock(&wr->async_mutex);
+  while (1) {
+    while (wr->async_state == ASYNC_IDLE)
+      pthread_cond_wait(&wr->async_cond,&wr->async_mutex);
+    if (wr->async_state == ASYNC_EXIT) break;
+    pthread_mutex_unlock(&wr->async_mutex);
+
+    wr->async_snapshot();
+
+    pthread_mutex_lock(&wr->async_mutex);
+    wr->async_state = ASYNC_IDLE;
+    pthread_cond_broadcast(&wr->async_cond);
+  }
+  pthread_mutex_unlock(&wr->async_mutex);
+
+  return NULL;
+}
+
+#endif
+
+/* ----------------------------------------------------------------------
+   write snapshot to file of my cluster and to base file if multiproc
+   called by I/O thread, so may not make any MPI calls
+------------------------------------------------------------------------- */
+
+void WriteRestart::async_snapshot()
+{
+  if (async_file(afile,1)) async_error = 1;
+  if (abase && async_file(abase,0)) async_error = 1;
+}
+
+/* ----------------------------------------------------------------------
+   write one file under a temporary name, rename it when it is complete
+   header = hbuf, unless multiproc per-cluster file
+   atomflag = 1 to also write per-proc data in abuf
+   return 1 if file could not be written
+------------------------------------------------------------------------- */
+
+int WriteRestart::async_file(const char *name, int atomflag)
+{
+  char *tmpname = new char[strlen(name) + 8];
+  sprintf(tmpname,"%s.tmp",name);
+
+  fp = fopen(tmpname,"wb");
+  if (fp == NULL) {
+    delete [] tmpname;
+    return 1;
+  }
+
+  if (!atomflag || !multiproc) fwrite(hbuf,sizeof(char),hsize,fp);
+
+  if (atomflag) {
+    if (multiproc) write_int(PROCSPERFILE,nclusterprocs);
+    bigint offset = 0;
+    for (int iproc = 0; iproc < nclusterprocs; iproc++) {
+      write_double_vec(PERPROC,acount[iproc],&abuf[offset]);
+      offset += acount[iproc];
+    }
+  }
+
+  int flag = ferror(fp);
+  if (fclose(fp)) flag = 1;
+  fp = NULL;
+  if (!flag && rename(tmpname,name)) flag = 1;
+
+  delete [] tmpname;
+  return flag ? 1 : 0;
+}
+
 /* ----------------------------------------------------------------------
    proc 0 writes out problem description
 ------------------------------------------------------------------------- */
@@ -612,6 +977,13 @@ void WriteRestart::file_layout(int send_size)
     memory->destroy(all_send_sizes);
   }
 
+  // delta file refers to full file with all other per-atom info
+
+  if (delta_flag && me == 0) {
+    write_string(DELTA_BASE,delta_base);
+    write_bigint(DELTA_OFFSET,delta_offset);
+  }
+
   // -1 flag signals end of file layout info
 
   if (me == 0) {
@@ -628,6 +1000,143 @@ void WriteRestart::file_layout(int send_size)
   }
 }
 
+/* ----------------------------------------------------------------------
+   size of my per-atom data in a delta file
+------------------------------------------------------------------------- */
+
+int WriteRestart::size_delta()
+{
+  int nlocal = atom->nlocal;
+  int nper = 11;
+  if (atom->q_flag) nper++;
+  if (atom->omega_flag) nper += 3;
+  if (atom->angmom_flag) nper += 3;
+
+  int n = nlocal*nper;
+  if (atom->nextra_restart)
+    for (int iextra = 0; iextra < atom->nextra_restart; iextra++)
+      for (int i = 0; i < nlocal; i++)
+        n += modify->fix[atom->extra_restart[iextra]]->size_restart(i);
+
+  return n;
+}
+
+/* ----------------------------------------------------------------------
+   pack atom I's dynamic state for a delta file including extra quantities
+   same leading values as AtomVec::pack_restart(), but no molecule IDs,
+     topology or other per-atom properties that are in the base file
+   must match ReadRestart::unpack_delta()
+------------------------------------------------------------------------- */
+
+int WriteRestart::pack_delta(int i, double *buf)
+{
+  int m = 1;
+  buf[m++] = atom->x[i][0];
+  buf[m++] = atom->x[i][1];
+  buf[m++] = atom->x[i][2];
+  buf[m++] = ubuf(atom->tag[i]).d;
+  buf[m++] = ubuf(atom->type[i]).d;
+  buf[m++] = ubuf(atom->mask[i]).d;
+  buf[m++] = ubuf(atom->image[i]).d;
+  buf[m++] = atom->v[i][0];
+  buf[m++] = atom->v[i][1];
+  buf[m++] = atom->v[i][2];
+
+  if (atom->q_flag) buf[m++] = atom->q[i];
+  if (atom->omega_flag) {
+    buf[m++] = atom->omega[i][0];
+    buf[m++] = atom->omega[i][1];
+    buf[m++] = atom->omega[i][2];
+  }
+  if (atom->angmom_flag) {
+    buf[m++] = atom->angmom[i][0];
+    buf[m++] = atom->angmom[i][1];
+    buf[m++] = atom->angmom[i][2];
+  }
+
+  if (atom->nextra_restart)
+    for (int iextra = 0; iextra < atom->nextra_restart; iextra++)
+      m += modify->fix[atom->extra_restart[iextra]]->pack_restart(i,&buf[m]);
+
+  buf[0] = m;
+  return m;
+}
+
+/* ----------------------------------------------------------------------
+   checksum of the per-atom info that delta files take from the full file
+   = values of AtomVec::pack_restart() after the leading ones in
+     pack_delta(), with charge, omega and angmom zeroed since delta files
+     have them, and without the per-atom info of fixes
+   per-atom hashes are summed, so result does not depend on atom order
+------------------------------------------------------------------------- */
+
+uint64_t WriteRestart::static_checksum()
+{
+  AtomVec *avec = atom->avec;
+  tagint *tag = atom->tag;
+  double *q = atom->q;
+  double **omega = atom->omega;
+  double **angmom = atom->angmom;
+  int nlocal = atom->nlocal;
+
+  double *buf;
+  memory->create(buf,MAX(avec->size_restart(),1),"write_restart:checksum");
+
+  double qsave = 0.0;
+  double omegasave[3],angmomsave[3];
+  uint64_t sum = 0;
+
+  for (int i = 0; i < nlocal; i++) {
+    if (atom->q_flag) {
+      qsave = q[i];
+      q[i] = 0.0;
+    }
+    if (atom->omega_flag)
+      for (int k = 0; k < 3; k++) {
+        omegasave[k] = omega[i][k];
+        omega[i][k] = 0.0;
+      }
+    if (atom->angmom_flag)
+      for (int k = 0; k < 3; k++) {
+        angmomsave[k] = angmom[i][k];
+        angmom[i][k] = 0.0;
+      }
+
+    int n = avec->pack_restart(i,buf);
+
+    if (atom->q_flag) q[i] = qsave;
+    if (atom->omega_flag)
+      for (int k = 0; k < 3; k++) omega[i][k] = omegasave[k];
+    if (atom->angmom_flag)
+      for (int k = 0; k < 3; k++) angmom[i][k] = angmomsave[k];
+
+    if (atom->nextra_restart)
+      for (int iextra = 0; iextra < atom->nextra_restart; iextra++)
+        n -= modify->fix[atom->extra_restart[iextra]]->size_restart(i);
+
+    // FNV-1a hash of atom ID and the 64-bit words of its static info
+
+    uint64_t hash = 14695981039346656037ULL;
+    hash = (hash ^ (uint64_t) tag[i]) * 1099511628211ULL;
+    for (int m = 11; m < n; m++) {
+      uint64_t word;
+      memcpy(&word,&buf[m],sizeof(uint64_t));
+      hash = (hash ^ word) * 1099511628211ULL;
+    }
+    sum += hash;
+  }
+
+  memory->destroy(buf);
+
+  // sum modulo 2^64 over all procs, in 2 halves that cannot overflow
+
+  long long part[2],all[2];
+  part[0] = (long long) (sum >> 32);
+  part[1] = (long long) (sum & 0xffffffffULL);
+  MPI_Allreduce(part,all,2,MPI_LONG_LONG,MPI_SUM,world);
+  return ((uint64_t) all[0] << 32) + (uint64_t) all[1];
+}
+
 // ----------------------------------------------------------------------
 // ----------------------------------------------------------------------
 // low-level fwrite methods
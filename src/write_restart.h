@@ -23,14 +23,20 @@ CommandStyle(write_restart,WriteRestart)
 #include <cstdio>
 #include "pointers.h"
 
+#if defined(LAMMPS_ASYNC_DUMP)
+#include <pthread.h>
+#endif
+
 namespace LAMMPS_NS {
 
 class WriteRestart : protected Pointers {
  public:
   WriteRestart(class LAMMPS *);
+  ~WriteRestart();
   void command(int, char **);
   void multiproc_options(int, int, int, char **);
   void write(char *);
+  void async_stop();
 
  private:
   int me,nprocs;
@@ -51,6 +57,52 @@ class WriteRestart : protected Pointers {
   class RestartMPIIO *mpiio;   // MPIIO for restart file output
   MPI_Offset headerOffset;
 
+  // restart async, used by periodic restart files only
+  // header is written into hbuf by proc 0, abuf holds packed data of my
+  // cluster, both are written by the I/O thread to afile and abase
+
+  int async_flag;            // 1 if files are written by an I/O thread
+  double *abuf;              // packed atoms of all procs in my cluster
+  bigint maxabuf;            // size of abuf
+  int *acount;               // # of values in abuf from each proc in cluster
+  char *hbuf;                // header of restart file in memory
+  size_t hsize;              // # of bytes in hbuf
+  char *afile;               // file with atoms the I/O thread writes
+  char *abase;               // base file the I/O thread writes, if multiproc
+  int async_error;           // 1 if I/O thread could not write a file
+
+#if defined(LAMMPS_ASYNC_DUMP)
+  enum{ASYNC_IDLE,ASYNC_BUSY,ASYNC_EXIT};
+  int async_state;           // state of the snapshot handed to the I/O thread
+  int async_running;         // 1 if the I/O thread was started
+  pthread_t async_thread;
+  pthread_mutex_t async_mutex;
+  pthread_cond_t async_cond;
+  static void *async_worker(void *);
+#endif
+
+  // restart delta, files between full ones only store dynamic per-atom state
+
+  int delta_every;           // write full file every this many files, 0 = off
+  int delta_flag;            // 1 if file being written is a delta file
+  int delta_count;           // # of files written since last full file
+  char *delta_base;          // name of last full file
+  bigint delta_offset;       // offset of per-atom data in single full file
+  bigint delta_natoms,delta_nbonds,delta_nangles;   // counts in full file
+  bigint delta_ndihedrals,delta_nimpropers;
+  uint64_t delta_checksum;   // checksum of static per-atom info in full file
+
+  int size_delta();
+  int pack_delta(int, double *);
+  uint64_t static_checksum();
+
+  void async_gather(int, int, double *);
+  void async_post();
+  void async_wait();
+  void async_join();
+  void async_snapshot();
+  int async_file(const char *, int);
+
   void header();
   void type_arrays();
   void force_fields();
@@ -66,6 +118,17 @@ class WriteRestart : protected Pointers {
   void write_string(int, const char *);
   void write_int_vec(int, int, int *);
   void write_double_vec(int, int, double *);
+
+  // union data struct for packing 32-bit and 64-bit ints into double bufs
+  // see atom_vec.h for documentation
+
+  union ubuf {
+    double d;
+    int64_t i;
+    ubuf(double arg) : d(arg) {}
+    ubuf(int64_t arg) : i(arg) {}
+    ubuf(int arg) : i(arg) {}
+  };
 };
 
 }
@@ -112,4 +175,49 @@ E: Cannot open restart file %s
 
 Self-explanatory.
 
+E: Restart async yes requires LAMMPS be built with -DLAMMPS_ASYNC_DUMP
+
+The I/O thread uses POSIX threads, which must be enabled when LAMMPS
+is built.
+
+E: Restart async yes not allowed with MPI-IO output
+
+MPI-IO output is written collectively by all procs and cannot be
+handed to an I/O thread.
+
+E: Write_restart async yes is only allowed for the restart command
+
+The write_restart command always writes its file before it returns.
+
+E: Write_restart delta is only allowed for the restart command
+
+Delta files refer to the last full restart file written by the
+same restart command.
+
+E: Restart delta not allowed with MPI-IO output
+
+Self-explanatory.
+
+E: Restart delta requires atom IDs
+
+Atoms in a delta file are matched to the base file by their IDs.
+
+E: Restart delta not allowed with this atom style
+
+Atom styles with ellipsoid, line, tri, or body particles store
+orientations in per-atom bonus data which delta files do not include.
+
+E: Cannot open restart header in memory
+
+The open_memstream() call for the restart header failed.
+
+E: Cannot create I/O thread for restart async
+
+The pthread_create() call failed.
+
+E: Could not write restart file in I/O thread
+
+The I/O thread could not open, write, or rename the previous restart
+file.  The file was not completed.
+
 */